@@ -0,0 +1,38 @@
+# @file         compile.py
+#               Benchmark for reusable compiled code: measures the cost of one call of a validator snippet
+#               run with `eval` (parsed on every call), compiled once with `compile` and executed with `run`,
+#               and compiled once with `compileFunction` and called from Python.
+#
+#               Usage: python3 benchmarks/compile.py [call count]
+#
+# @date         October 2026
+
+import sys
+import time
+import pythonmonkey as pm
+
+callCount = int(sys.argv[1]) if len(sys.argv) > 1 else 100000
+
+body = """
+const order = globalThis.benchOrder;
+let valid = typeof order.id === 'string' && order.id.length > 0;
+valid = valid && Number.isInteger(order.qty) && order.qty > 0;
+valid = valid && typeof order.price === 'number' && order.price >= 0;
+valid = valid && ['new', 'paid', 'shipped'].includes(order.state);
+"""
+pm.globalThis.benchOrder = {'id': 'A-1', 'qty': 3, 'price': 9.5, 'state': 'paid'}
+script = pm.compile(body + "valid", {'filename': 'validate.js'})
+validate = pm.compileFunction(['_'], body + "return valid", {'name': 'validate', 'filename': 'validate.js'})
+
+
+def measure(name, fn):
+  start = time.perf_counter()
+  for _ in range(callCount):
+    fn()
+  elapsed = time.perf_counter() - start
+  print(f'{name}: {callCount} calls in {elapsed:.3f}s, {elapsed / callCount * 1e6:.2f}us/call')
+
+
+measure('eval', lambda: pm.eval(body + "valid", {'filename': 'validate.js'}))
+measure('compile + run', lambda: pm.run(script))
+measure('compileFunction', lambda: validate(None))
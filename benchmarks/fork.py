@@ -0,0 +1,58 @@
+# @file         fork.py
+#               Benchmark for starting warmed-up workers: measures the time until a worker has evaluated its first
+#               script, for a new process importing pythonmonkey, for a new process with a warm compiled script cache,
+#               and for a child forked from a parent which has already imported pythonmonkey and loaded the builtins.
+#
+#               Usage: python3 benchmarks/fork.py [runs]
+#
+# @date         October 2026
+
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+runs = int(sys.argv[1]) if len(sys.argv) > 1 else 10
+
+workerCode = "console; new URL('https://example.com/').host"
+child = f"""
+import pythonmonkey as pm
+pm.eval({workerCode!r})
+"""
+
+
+def spawn(cacheDir):
+  env = dict(os.environ)
+  env.pop('PYTHONMONKEY_CACHE_DIR', None)
+  if cacheDir:
+    env['PYTHONMONKEY_CACHE_DIR'] = cacheDir
+  start = time.perf_counter()
+  subprocess.run([sys.executable, '-c', child], env=env, check=True)
+  return time.perf_counter() - start
+
+
+def fork():
+  import pythonmonkey as pm
+  start = time.perf_counter()
+  pid = os.fork()
+  if pid == 0:
+    pm.eval(workerCode)
+    os._exit(0)
+  os.waitpid(pid, 0)
+  return time.perf_counter() - start
+
+
+def report(label, times):
+  times = sorted(times)
+  print(f'{label:>12}: median {times[len(times) // 2] * 1000:7.1f}ms, best {times[0] * 1000:7.1f}ms')
+
+
+report('spawn', [spawn(None) for _ in range(runs)])
+with tempfile.TemporaryDirectory() as cacheDir:
+  spawn(cacheDir)  # populate
+  report('spawn, cache', [spawn(cacheDir) for _ in range(runs)])
+
+import pythonmonkey as pm  # the fork server: warmed up once, before any fork
+pm.eval(workerCode)
+report('fork', [fork() for _ in range(runs)])
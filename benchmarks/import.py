@@ -0,0 +1,57 @@
+# @file         import.py
+#               Benchmark for the cold start of a process: measures the time of `import pythonmonkey`, broken down
+#               into the native module (engine initialization), helpers and require (ctx-module bootstrap) phases,
+#               then the latency of the first eval and of the first use of lazily loaded builtin globals.
+#
+#               Usage: python3 benchmarks/import.py [runs]
+#
+# @date         October 2026
+
+import json
+import subprocess
+import sys
+
+runs = int(sys.argv[1]) if len(sys.argv) > 1 else 5
+
+child = """
+import json
+import time
+
+def measure(fn):
+  start = time.perf_counter()
+  fn()
+  return time.perf_counter() - start
+
+phases = {}
+phases['import'] = measure(lambda: __import__('pythonmonkey'))
+import pythonmonkey as pm
+phases['first eval'] = measure(lambda: pm.eval('1 + 1'))
+phases['first console'] = measure(lambda: pm.eval('console'))
+phases['first URL'] = measure(lambda: pm.eval("new URL('https://example.com/')"))
+phases['first XMLHttpRequest'] = measure(lambda: pm.eval('new XMLHttpRequest()'))
+print(json.dumps(phases))
+"""
+
+importPhases = {  # module => phase, from the cumulative times of -X importtime
+  'pythonmonkey.pythonmonkey': 'native module',
+  'pythonmonkey.helpers': 'helpers',
+  'pythonmonkey.require': 'require',
+}
+
+
+def startup():
+  result = subprocess.run([sys.executable, '-X', 'importtime', '-c', child], check=True, capture_output=True, text=True)
+  phases = json.loads(result.stdout)
+  for line in result.stderr.splitlines():  # import time: self [us] | cumulative | imported package
+    fields = line.split('|')
+    if len(fields) == 3 and fields[2].strip() in importPhases:
+      phases[importPhases[fields[2].strip()]] = int(fields[1]) / 1e6
+  return phases
+
+
+results = [startup() for _ in range(runs)]
+for phase in ['import', 'native module', 'helpers', 'require', 'first eval', 'first console', 'first URL', 'first XMLHttpRequest']:
+  times = sorted(result[phase] for result in results if phase in result)
+  if times:
+    indent = '  ' if phase in importPhases.values() else ''
+    print(f'{indent + phase:>22}: median {times[len(times) // 2] * 1000:7.1f}ms, best {times[0] * 1000:7.1f}ms')
@@ -0,0 +1,43 @@
+# @file         iteration.py
+#               Benchmark for iterating Python objects from JS: measures how many `for...of` steps per second
+#               PythonMonkey runs over a Python generator, and over the values and entries of a Python bytes object.
+#
+#               Usage: python3 benchmarks/iteration.py [item count]
+#
+# @date         October 2026
+
+import sys
+import time
+import pythonmonkey as pm
+
+itemCount = int(sys.argv[1]) if len(sys.argv) > 1 else 1000000
+
+sumValues = pm.eval("""
+(iterable) => {
+  let sum = 0;
+  for (const value of iterable)
+    sum += value;
+  return sum;
+}
+""")
+
+sumEntries = pm.eval("""
+(bytes) => {
+  let sum = 0;
+  for (const [index, value] of bytes.entries())
+    sum += index + value;
+  return sum;
+}
+""")
+
+
+def measure(name, fn, arg):
+  start = time.perf_counter()
+  fn(arg)
+  elapsed = time.perf_counter() - start
+  print(f'{name}: {itemCount} steps in {elapsed:.3f}s, {itemCount / elapsed:,.0f} steps/sec')
+
+
+measure('generator', sumValues, (i for i in range(itemCount)))
+measure('bytes values', sumValues, bytes(itemCount))
+measure('bytes entries', sumEntries, bytes(itemCount))
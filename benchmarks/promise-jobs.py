@@ -0,0 +1,61 @@
+# @file         promise-jobs.py
+#               Benchmark for the promise job queue: measures how many promise reaction jobs per second
+#               PythonMonkey runs for long `.then` chains and for many concurrent async functions.
+#
+#               Usage: python3 benchmarks/promise-jobs.py [chain length] [runs]
+#
+# @date         October 2026
+
+import asyncio
+import sys
+import time
+import pythonmonkey as pm
+
+chainLength = int(sys.argv[1]) if len(sys.argv) > 1 else 100000
+runs = int(sys.argv[2]) if len(sys.argv) > 2 else 5
+
+thenChain = pm.eval("""
+(length) => {
+  let p = Promise.resolve(0);
+  for (let i = 0; i < length; i++)
+    p = p.then((x) => x + 1);
+  return p;
+}
+""")
+
+manyAsyncFns = pm.eval("""
+async (count) => {
+  async function step(x) { await null; return x + 1; }
+  const all = [];
+  for (let i = 0; i < count; i++)
+    all.push(step(i));
+  return (await Promise.all(all)).length;
+}
+""")
+
+
+def report(label, unit, times):
+  times = sorted(times)
+  median = times[len(times) // 2]
+  print(f'{label:>16}: {chainLength} {unit} in median {median:.3f}s, best {times[0]:.3f}s, '
+        f'{chainLength / median:,.0f} {unit}/sec (median), {chainLength / times[0]:,.0f} {unit}/sec (best)')
+
+
+async def timeThenChain():
+  start = time.perf_counter()
+  assert await thenChain(chainLength) == chainLength
+  return time.perf_counter() - start
+
+
+async def timeManyAsyncFns():
+  start = time.perf_counter()
+  assert await manyAsyncFns(chainLength) == chainLength
+  return time.perf_counter() - start
+
+
+async def main():
+  report('.then chain', 'jobs', [await timeThenChain() for _ in range(runs)])
+  # each async function awaits once and resolves once, plus the Promise.all reactions
+  report('async functions', 'calls', [await timeManyAsyncFns() for _ in range(runs)])
+
+asyncio.run(main())
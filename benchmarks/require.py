@@ -0,0 +1,58 @@
+# @file         require.py
+#               Benchmark for loading a CommonJS project: generates a tree of hundreds of modules, each requiring
+#               a few others by relative and extensionless identifiers, then measures a cold `pm.require` of its
+#               entry point in a fresh process. Module resolution probes many missing paths, and every module
+#               source is read from disk, which is what internalBinding('fs') serves. Runs with and without
+#               prefetching the dependencies of each module on background threads.
+#
+#               Usage: python3 benchmarks/require.py [modules] [runs]
+#
+# @date         October 2026
+
+import os
+import subprocess
+import sys
+import tempfile
+
+moduleCount = int(sys.argv[1]) if len(sys.argv) > 1 else 300
+runs = int(sys.argv[2]) if len(sys.argv) > 2 else 5
+perDirectory = 20
+
+child = """
+import sys
+import time
+import pythonmonkey as pm
+pm.bootstrap.prefetchRequires = sys.argv[3] == 'prefetch'
+start = time.perf_counter()
+assert pm.require(sys.argv[1])['count'] == int(sys.argv[2])
+print(time.perf_counter() - start)
+"""
+
+
+def modulePath(i):
+  return os.path.join(f'dir{i // perDirectory}', f'mod{i}')
+
+
+def writeProject(root):
+  for i in range(moduleCount):
+    deps = [j for j in (2 * i + 1, 2 * i + 2) if j < moduleCount]
+    lines = ["exports.count = 1;"]
+    for j in deps:
+      relative = os.path.relpath(modulePath(j), os.path.dirname(modulePath(i))).replace(os.sep, '/')
+      lines.append(f"exports.count += require('./{relative}').count;")
+    lines.append(f"exports.text = '{'module ' * 200}';")  # some body to read
+    os.makedirs(os.path.join(root, os.path.dirname(modulePath(i))), exist_ok=True)
+    with open(os.path.join(root, modulePath(i) + '.js'), 'w', encoding='utf-8') as file:
+      file.write('\n'.join(lines) + '\n')
+
+
+with tempfile.TemporaryDirectory() as root:
+  writeProject(root)
+  entry = os.path.join(root, modulePath(0) + '.js')
+  for mode in ['prefetch', 'no prefetch']:
+    times = []
+    for _ in range(runs):
+      result = subprocess.run([sys.executable, '-c', child, entry, str(moduleCount), mode], check=True, capture_output=True, text=True)
+      times.append(float(result.stdout))
+    times.sort()
+    print(f'require {moduleCount} modules, {mode:>11}: median {times[len(times) // 2] * 1000:7.1f}ms, best {times[0] * 1000:7.1f}ms')
@@ -0,0 +1,55 @@
+# @file         startup.py
+#               Benchmark for the compiled script cache: measures the time to import pythonmonkey (which loads
+#               ctx-module, util.js, the URL polyfills and the other builtin modules) and require a module, with
+#               no cache, with an empty (cold) cache and with a populated (warm) cache.
+#
+#               Usage: python3 benchmarks/startup.py [runs]
+#
+# @date         October 2026
+
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+runs = int(sys.argv[1]) if len(sys.argv) > 1 else 5
+
+child = """
+import time
+start = time.perf_counter()
+import pythonmonkey as pm
+pm.require('util')
+elapsed = time.perf_counter() - start
+stats = pm.compileCacheStats()
+print(elapsed, stats['hits'], stats['misses'])
+"""
+
+
+def startup(cacheDir):
+  env = dict(os.environ)
+  env.pop('PYTHONMONKEY_CACHE_DIR', None)
+  if cacheDir:
+    env['PYTHONMONKEY_CACHE_DIR'] = cacheDir
+  output = subprocess.run([sys.executable, '-c', child], env=env, check=True, capture_output=True, text=True).stdout
+  elapsed, hits, misses = output.split()
+  return float(elapsed), int(hits), int(misses)
+
+
+def report(label, results):
+  times = sorted(result[0] for result in results)
+  print(f'{label:>10}: median {times[len(times) // 2] * 1000:7.1f}ms, best {times[0] * 1000:7.1f}ms, '
+        f'cache hits {results[-1][1]}, misses {results[-1][2]}')
+
+
+report('no cache', [startup(None) for _ in range(runs)])
+
+cold = []
+for _ in range(runs):
+  with tempfile.TemporaryDirectory() as cacheDir:
+    cold.append(startup(cacheDir))
+report('cold', cold)
+
+with tempfile.TemporaryDirectory() as cacheDir:
+  startup(cacheDir)  # populate
+  report('warm', [startup(cacheDir) for _ in range(runs)])
@@ -0,0 +1,46 @@
+# @file         timers.py
+#               Benchmark for JS timers: schedules many concurrent setTimeout timers (e.g. per-connection idle timeouts),
+#               clears half of them, and measures scheduling throughput and how late the remaining ones fire.
+#
+#               Usage: python3 benchmarks/timers.py [timer count]
+#
+# @date         October 2026
+
+import asyncio
+import sys
+import time
+import pythonmonkey as pm
+
+timerCount = int(sys.argv[1]) if len(sys.argv) > 1 else 100000
+
+manyTimers = pm.eval("""
+(count, clearEvery) => {
+  let fired = 0;
+  let maxLateness = 0;
+  const timers = [];
+  const start = Date.now();
+  for (let i = 0; i < count; i++) {
+    const delay = i % 1000; // timers expiring in the same millisecond are coalesced
+    timers.push(setTimeout(() => {
+      fired++;
+      maxLateness = Math.max(maxLateness, Date.now() - start - delay);
+    }, delay));
+  }
+  const scheduledIn = Date.now() - start;
+  for (let i = 0; i < count; i += clearEvery)
+    clearTimeout(timers[i]);
+  return { scheduledIn, result: () => ({ fired, maxLateness }) };
+}
+""")
+
+
+async def main():
+  start = time.perf_counter()
+  run = manyTimers(timerCount, 2)
+  await pm.wait()
+  elapsed = time.perf_counter() - start
+  result = run['result']()
+  print(f'scheduled {timerCount} timers in {run["scheduledIn"]:.0f}ms, {timerCount / run["scheduledIn"] * 1000:,.0f} timers/sec')
+  print(f'{result["fired"]:.0f} timers fired (half cleared), max lateness {result["maxLateness"]:.0f}ms, total {elapsed:.3f}s')
+
+asyncio.run(main())
@@ -0,0 +1,116 @@
+/**
+ * @file CompiledScript.hh
+ * @brief CompiledScript is a custom C-implemented python type. It holds a compiled JS script (a SpiderMonkey stencil) that can be run any number of times.
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Distributive Corp.
+ *
+ */
+
+#ifndef PythonMonkey_CompiledScript_
+#define PythonMonkey_CompiledScript_
+
+#include <jsapi.h>
+#include <js/CompileOptions.h>
+#include <js/experimental/JSStencil.h>
+#include <mozilla/RefPtr.h>
+
+#include <Python.h>
+
+#include <string>
+
+/**
+ * @brief The typedef for the backing store that will be used by CompiledScript objects.
+ * The stencil is instantiated on the first run, and the rooted JSScript is executed again by later runs.
+ */
+typedef struct {
+  PyObject_HEAD
+  JS::Stencil *stencil; // strong reference
+  JS::PersistentRootedScript *script; // nullptr until the first run
+  PyObject *filename;
+} CompiledScript;
+
+/**
+ * @brief The compile options of a CompiledScript, kept by value so that they can be applied on another thread
+ */
+struct CompiledScriptSettings {
+  std::string filename = "evaluate";
+  unsigned long lineno = 1;
+  unsigned long column = 1;
+  bool mutedErrors = false;
+  bool noScriptRval = false;
+  bool strict = false;
+
+  /**
+   * @brief Set these settings on compile options, the options keep pointing to `filename`
+   */
+  void apply(JS::CompileOptions &options) const;
+};
+
+/**
+ * @brief This struct is a bundle of methods used by the CompiledScript type
+ */
+struct CompiledScriptMethodDefinitions {
+public:
+  /**
+   * @brief Create a new CompiledScript
+   *
+   * @param stencil - the compiled script
+   * @param filename - the filename of the script, for repr
+   * @return PyObject* - A new instance of CompiledScript, or NULL on error
+   */
+  static PyObject *CompiledScript_create(already_AddRefed<JS::Stencil> stencil, const char *filename);
+
+  /**
+   * @brief Compile a global script on this thread, through the StencilCache if `useCache`
+   *
+   * @param cx - javascript context pointer
+   * @param source - the source code, a Python str
+   * @param settings - the compile options
+   * @param useCache - whether to look the stencil up in the StencilCache first
+   * @return PyObject* - A new instance of CompiledScript, or NULL with a SpiderMonkeyError set
+   */
+  static PyObject *compile(JSContext *cx, PyObject *source, const CompiledScriptSettings &settings, bool useCache);
+
+  /**
+   * @brief Deallocation method (.tp_dealloc), releases the stencil and the script
+   *
+   * @param self - The CompiledScript to be free'd
+   */
+  static void CompiledScript_dealloc(CompiledScript *self);
+
+  /**
+   * @brief .tp_repr method
+   *
+   * @param self - The CompiledScript
+   * @return PyObject* - the string representation
+   */
+  static PyObject *CompiledScript_repr(CompiledScript *self);
+
+  /**
+   * @brief Compile a global script on a helper thread, with its own JS::FrontendContext, so that the event-loop keeps running.
+   * At most four scripts are compiled at once, the others wait in a queue. At interpreter exit, queued compilations are dropped
+   * and running ones are waited for.
+   *
+   * @param source - the source code, a Python str
+   * @param settings - the compile options
+   * @return PyObject* - an asyncio.Future resolving to a CompiledScript, or rejecting with a SpiderMonkeyError. NULL on error
+   */
+  static PyObject *compileAsync(PyObject *source, CompiledScriptSettings &&settings);
+
+  /**
+   * @brief Get the JSScript of the stencil, instantiated in the current realm on the first call only
+   *
+   * @param cx - javascript context pointer
+   * @param self - The CompiledScript
+   * @return JSScript* - the script, or nullptr with a pending JS exception
+   */
+  static JSScript *instantiate(JSContext *cx, CompiledScript *self);
+};
+
+/**
+ * @brief Struct for the CompiledScriptType, used by all CompiledScript objects
+ */
+extern PyTypeObject CompiledScriptType;
+
+#endif
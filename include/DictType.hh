@@ -31,6 +31,17 @@ public:
    * @returns PyObject* pointer to the resulting PyObject
    */
   static PyObject *getPyObject(JSContext *cx, JS::Handle<JS::Value> jsObject);
+
+  /**
+   * @brief Construct a new DictType object from a JSObject, as an instance of a JSObjectProxy subtype
+   *
+   * @param cx - pointer to the JSContext
+   * @param jsObject - pointer to the JSObject to be coerced
+   * @param proxyType - JSObjectProxyType or one of its subtypes
+   *
+   * @returns PyObject* pointer to the resulting PyObject
+   */
+  static PyObject *getPyObject(JSContext *cx, JS::Handle<JS::Value> jsObject, PyTypeObject *proxyType);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,52 @@
+/**
+ * @file HelperThreadPool.hh
+ * @brief The thread pool running SpiderMonkey's helper thread tasks (background GC, off-thread compilation...), owned by PythonMonkey so that it survives `os.fork()`
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Distributive Corp.
+ *
+ */
+
+#ifndef PythonMonkey_HelperThreadPool_
+#define PythonMonkey_HelperThreadPool_
+
+#include <Python.h>
+
+/**
+ * @brief SpiderMonkey's own helper threads don't exist in a forked child, so the engine state copied into the
+ * child would wait forever on tasks nobody runs. Instead the engine hands its tasks to this pool, which the
+ * `os.register_at_fork` handlers drain before a fork and restart in the child. A warmed-up process can then be
+ * forked into workers which share its heap copy-on-write.
+ * On Windows, which has no fork, SpiderMonkey keeps its own thread pool.
+ */
+class HelperThreadPool {
+public:
+  /**
+   * @brief Make SpiderMonkey dispatch its helper thread tasks to this pool, must be called between `JS_Init` and `JS_NewContext`
+   */
+  static void init();
+
+  /**
+   * @brief Register the fork handlers with `os.register_at_fork`
+   *
+   * @return success, or false with the Python error indicator set
+   */
+  static bool registerForkHandlers();
+
+  /**
+   * @brief Stop starting tasks, and wait for the running ones to finish, so that no helper thread holds an engine lock across the fork
+   */
+  static void beforeFork();
+
+  /**
+   * @brief Start tasks again in the parent process
+   */
+  static void afterForkInParent();
+
+  /**
+   * @brief Start new helper threads in the child process, they run the tasks that were pending at the fork
+   */
+  static void afterForkInChild();
+};
+
+#endif
@@ -0,0 +1,220 @@
+/**
+ * @file JSMapProxy.hh
+ * @brief JSMapProxy is a custom C-implemented python type. It acts as a proxy for JS Maps from Spidermonkey, and behaves like a collections.abc.MutableMapping would.
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Distributive Corp.
+ *
+ */
+
+#ifndef PythonMonkey_JSMapProxy_
+#define PythonMonkey_JSMapProxy_
+
+#include <jsapi.h>
+
+#include <Python.h>
+
+/**
+ * @brief The typedef for the backing store that will be used by JSMapProxy objects. All it contains is a pointer to the JS Map
+ *
+ */
+typedef struct {
+  PyObject_HEAD
+  JS::PersistentRootedObject *jsMap;
+} JSMapProxy;
+
+/**
+ * @brief This struct is a bundle of methods used by the JSMapProxy type
+ *
+ * Lookups go straight to the JS Map (`JS::MapGet`, `JS::MapHas`, ...), so nothing is copied,
+ * and keys don't need to be hashable in Python: JS objects are looked up by identity as in JS.
+ */
+struct JSMapProxyMethodDefinitions {
+public:
+  /**
+   * @brief Create a new JSMapProxy
+   *
+   * @param cx - javascript context pointer
+   * @param map - the JS Map
+   * @return PyObject* - A new instance of JSMapProxy, or NULL on error
+   */
+  static PyObject *JSMapProxy_create(JSContext *cx, JS::HandleObject map);
+
+  /**
+   * @brief Deallocation method (.tp_dealloc), removes the reference to the underlying JS Map before freeing the JSMapProxy
+   *
+   * @param self - The JSMapProxy to be free'd
+   */
+  static void JSMapProxy_dealloc(JSMapProxy *self);
+
+  /**
+   * @brief Length method (.mp_length), returns the number of entries in the JS Map
+   *
+   * @param self - The JSMapProxy
+   * @return Py_ssize_t - The size of the JS Map
+   */
+  static Py_ssize_t JSMapProxy_length(JSMapProxy *self);
+
+  /**
+   * @brief Getter method (.mp_subscript), returns the value for the given key, raises KeyError if the key is absent
+   *
+   * @param self - The JSMapProxy
+   * @param key - The key
+   * @return PyObject* - the value, or NULL with an exception set
+   */
+  static PyObject *JSMapProxy_get(JSMapProxy *self, PyObject *key);
+
+  /**
+   * @brief Assign method (.mp_ass_subscript), sets the value for the key, or deletes the entry if value is NULL
+   *
+   * @param self - The JSMapProxy
+   * @param key - The key
+   * @param value - The value, or NULL to delete the entry
+   * @return int - 0 on success, -1 on error
+   */
+  static int JSMapProxy_assign(JSMapProxy *self, PyObject *key, PyObject *value);
+
+  /**
+   * @brief Test method (.sq_contains), returns whether the JS Map has the key
+   *
+   * @param self - The JSMapProxy
+   * @param key - The key
+   * @return int - 1 if present, 0 if not, -1 on error
+   */
+  static int JSMapProxy_contains(JSMapProxy *self, PyObject *key);
+
+  /**
+   * @brief .tp_iter method, iterates over the keys of the JS Map in insertion order
+   *
+   * @param self - The JSMapProxy
+   * @return PyObject* - the iterator
+   */
+  static PyObject *JSMapProxy_iter(JSMapProxy *self);
+
+  /**
+   * @brief .tp_repr method
+   *
+   * @param self - The JSMapProxy
+   * @return PyObject* - the string representation
+   */
+  static PyObject *JSMapProxy_repr(JSMapProxy *self);
+
+  /**
+   * @brief Comparison method (.tp_richcompare), only equality with other mappings is supported
+   *
+   * @param self - The JSMapProxy
+   * @param other - Any other PyObject
+   * @param op - Which boolean operator is being performed (Py_EQ for equality, Py_NE for inequality, etc.)
+   * @return PyObject* - True or False, or Py_NotImplemented
+   */
+  static PyObject *JSMapProxy_richcompare(JSMapProxy *self, PyObject *other, int op);
+
+  /**
+   * @brief Python method keys, a collections.abc.KeysView
+   */
+  static PyObject *JSMapProxy_keys(JSMapProxy *self, PyObject *Py_UNUSED(ignored));
+
+  /**
+   * @brief Python method values, a collections.abc.ValuesView
+   */
+  static PyObject *JSMapProxy_values(JSMapProxy *self, PyObject *Py_UNUSED(ignored));
+
+  /**
+   * @brief Python method items, a collections.abc.ItemsView
+   */
+  static PyObject *JSMapProxy_items(JSMapProxy *self, PyObject *Py_UNUSED(ignored));
+
+  /**
+   * @brief Python method get(key, default=None)
+   *
+   * @param self - The JSMapProxy
+   * @param args - the key and the default value
+   * @param nargs - number of args
+   * @return PyObject* - the value for the key if present, else default
+   */
+  static PyObject *JSMapProxy_get_method(JSMapProxy *self, PyObject *const *args, Py_ssize_t nargs);
+
+  /**
+   * @brief Python method pop(key[, default]), removes the entry and returns its value
+   *
+   * @param self - The JSMapProxy
+   * @param args - the key and the optional default value
+   * @param nargs - number of args
+   * @return PyObject* - the value, the default, or NULL with a KeyError set
+   */
+  static PyObject *JSMapProxy_pop_method(JSMapProxy *self, PyObject *const *args, Py_ssize_t nargs);
+
+  /**
+   * @brief Python method popitem(), removes and returns the oldest (key, value) entry
+   *
+   * @param self - The JSMapProxy
+   * @return PyObject* - the entry tuple, or NULL with a KeyError set if the JS Map is empty
+   */
+  static PyObject *JSMapProxy_popitem_method(JSMapProxy *self, PyObject *Py_UNUSED(ignored));
+
+  /**
+   * @brief Python method setdefault(key, default=None)
+   *
+   * @param self - The JSMapProxy
+   * @param args - the key and the default value
+   * @param nargs - number of args
+   * @return PyObject* - the value for the key, after setting it to default if absent
+   */
+  static PyObject *JSMapProxy_setdefault_method(JSMapProxy *self, PyObject *const *args, Py_ssize_t nargs);
+
+  /**
+   * @brief Python method update([other], **kwargs), from a mapping or an iterable of key/value pairs
+   *
+   * @param self - The JSMapProxy
+   * @param args - the optional mapping or iterable
+   * @param kwargs - more entries
+   * @return PyObject* - None, or NULL on error
+   */
+  static PyObject *JSMapProxy_update_method(JSMapProxy *self, PyObject *args, PyObject *kwargs);
+
+  /**
+   * @brief Python method clear()
+   *
+   * @param self - The JSMapProxy
+   * @return PyObject* - None, or NULL on error
+   */
+  static PyObject *JSMapProxy_clear_method(JSMapProxy *self, PyObject *Py_UNUSED(ignored));
+};
+
+/**
+ * @brief Struct for the methods that define the Mapping protocol
+ *
+ */
+static PyMappingMethods JSMapProxy_mapping_methods = {
+  .mp_length = (lenfunc)JSMapProxyMethodDefinitions::JSMapProxy_length,
+  .mp_subscript = (binaryfunc)JSMapProxyMethodDefinitions::JSMapProxy_get,
+  .mp_ass_subscript = (objobjargproc)JSMapProxyMethodDefinitions::JSMapProxy_assign
+};
+
+/**
+ * @brief Struct for the methods that define the Sequence protocol, only `in` is supported
+ *
+ */
+static PySequenceMethods JSMapProxy_sequence_methods = {
+  .sq_contains = (objobjproc)JSMapProxyMethodDefinitions::JSMapProxy_contains
+};
+
+static PyMethodDef JSMapProxy_methods[] = {
+  {"keys", (PyCFunction)JSMapProxyMethodDefinitions::JSMapProxy_keys, METH_NOARGS, "A set-like view of the Map's keys."},
+  {"values", (PyCFunction)JSMapProxyMethodDefinitions::JSMapProxy_values, METH_NOARGS, "A view of the Map's values."},
+  {"items", (PyCFunction)JSMapProxyMethodDefinitions::JSMapProxy_items, METH_NOARGS, "A set-like view of the Map's (key, value) entries."},
+  {"get", (PyCFunction)JSMapProxyMethodDefinitions::JSMapProxy_get_method, METH_FASTCALL, "Return the value for key if key is in the Map, else default."},
+  {"pop", (PyCFunction)JSMapProxyMethodDefinitions::JSMapProxy_pop_method, METH_FASTCALL, "Remove the entry for key and return its value, or default if given, else raise KeyError."},
+  {"popitem", (PyCFunction)JSMapProxyMethodDefinitions::JSMapProxy_popitem_method, METH_NOARGS, "Remove and return the oldest (key, value) entry, raise KeyError if the Map is empty."},
+  {"setdefault", (PyCFunction)JSMapProxyMethodDefinitions::JSMapProxy_setdefault_method, METH_FASTCALL, "Insert key with a value of default if key is not in the Map. Return the value for key."},
+  {"update", (PyCFunction)JSMapProxyMethodDefinitions::JSMapProxy_update_method, METH_VARARGS | METH_KEYWORDS, "Update the Map from a mapping or an iterable of key/value pairs, and keyword arguments."},
+  {"clear", (PyCFunction)JSMapProxyMethodDefinitions::JSMapProxy_clear_method, METH_NOARGS, "Remove all entries from the Map."},
+  {NULL, NULL}  /* sentinel */
+};
+
+/**
+ * @brief Struct for the JSMapProxyType, used by all JSMapProxy objects
+ */
+extern PyTypeObject JSMapProxyType;
+
+#endif
@@ -19,6 +19,8 @@
 #define KIND_KEYS 0
 #define KIND_VALUES 1
 #define KIND_ITEMS 2
+#define KIND_JS_ITERATOR 3 // the values of a JS iterable, as in `for...of`
+#define KIND_JS_ENTRIES 4  // the `[key, value]` entries of a JS iterable, as (key, value) tuples
 
 
 /**
@@ -33,6 +35,8 @@ typedef struct {
   bool reversed;
   int kind;
   PyDictObject *di_dict;   /* Set to NULL when iterator is exhausted */
+  JS::PersistentRootedObject *jsIterator; // only set for KIND_JS_ITERATOR and KIND_JS_ENTRIES
+  JS::PersistentRootedValue *nextMethod;  // only set for KIND_JS_ITERATOR and KIND_JS_ENTRIES, the iterator's `next` method looked up once
 } dictiterobject;
 
 
@@ -94,6 +98,26 @@ public:
    * @return PyObject* - number of objects left to iterate over in iteration
    */
   static PyObject *JSObjectIterProxy_len(JSObjectIterProxy *self);
+
+  /**
+   * @brief Get the value out of an iterator result `{ value, done }` returned by a JS iterator's `next()`
+   *
+   * @param cx - javascript context pointer
+   * @param result - the iterator result
+   * @return PyObject* - the value, or NULL without an exception set once done, or NULL on error
+   */
+  static PyObject *iteratorResultValue(JSContext *cx, JS::HandleValue result);
+
+  /**
+   * @brief Create a JSObjectIterProxy over a JS iterator, as in `for...of`
+   *
+   * @param cx - javascript context pointer
+   * @param owner - the Python object being iterated over, kept alive by the iterator
+   * @param jsIterator - the JS iterator
+   * @param kind - KIND_JS_ITERATOR for the values, or KIND_JS_ENTRIES for `[key, value]` entries as tuples
+   * @return PyObject* - the new JSObjectIterProxy, or NULL on error
+   */
+  static PyObject *JSObjectIterProxy_fromJSIterator(JSContext *cx, PyObject *owner, JS::HandleObject jsIterator, int kind);
 };
 
 
@@ -122,6 +122,22 @@ public:
    */
   static PyObject *JSObjectProxy_iter_next(JSObjectProxy *self);
 
+  /**
+   * @brief Return an async iterator object to make JSObjectProxy usable in `async for`, by calling its `[Symbol.asyncIterator]()` method
+   *
+   * @param self - The JSObjectProxy
+   * @return PyObject* - the JS async iterator, as a JSObjectAsyncIterableProxy
+   */
+  static PyObject *JSObjectProxy_aiter(JSObjectProxy *self);
+
+  /**
+   * @brief Implements the async next operator function, calling the JS async iterator's `next()` method once
+   *
+   * @param self - The JSObjectProxy, a JS async iterator
+   * @return PyObject* - awaitable for the next value, raising StopAsyncIteration once the JS iterator is done
+   */
+  static PyObject *JSObjectProxy_anext(JSObjectProxy *self);
+
   /**
    * @brief Compute a string representation of the JSObjectProxy
    *
@@ -324,6 +340,15 @@ static PyNumberMethods JSObjectProxy_number_methods = {
   .nb_inplace_or = (binaryfunc)JSObjectProxyMethodDefinitions::JSObjectProxy_ior
 };
 
+/**
+ * @brief Struct for the methods that define the async iterator protocol, only on JSObjectAsyncIterableProxyType
+ *
+ */
+static PyAsyncMethods JSObjectProxy_async_methods = {
+  .am_aiter = (unaryfunc)JSObjectProxyMethodDefinitions::JSObjectProxy_aiter,
+  .am_anext = (unaryfunc)JSObjectProxyMethodDefinitions::JSObjectProxy_anext
+};
+
 /**
  * @brief Struct for the other methods
  *
@@ -347,4 +372,9 @@ static PyMethodDef JSObjectProxy_methods[] = {
  */
 extern PyTypeObject JSObjectProxyType;
 
+/**
+ * @brief Struct for the JSObjectAsyncIterableProxyType, the JSObjectProxy subtype for JS objects with a `[Symbol.asyncIterator]` method and their async iterators
+ */
+extern PyTypeObject JSObjectAsyncIterableProxyType;
+
 #endif
\ No newline at end of file
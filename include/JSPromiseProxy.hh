@@ -0,0 +1,228 @@
+/**
+ * @file JSPromiseProxy.hh
+ * @brief JSPromiseProxy is a custom C-implemented python type. It acts as a proxy for JS Promises from Spidermonkey, and can be awaited like an asyncio.Future.
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Distributive Corp.
+ *
+ */
+
+#ifndef PythonMonkey_JSPromiseProxy_
+#define PythonMonkey_JSPromiseProxy_
+
+#include <jsapi.h>
+
+#include <Python.h>
+
+enum class JSPromiseProxyState {
+  PENDING,
+  FINISHED,
+  CANCELLED
+};
+
+/**
+ * @brief The typedef for the backing store that will be used by JSPromiseProxy objects.
+ * Besides the JS Promise, it holds the state that asyncio expects from a Future: the outcome, and the done callbacks.
+ * Like the C implementation of asyncio.Future, the first done callback is stored inline, the other ones in a list.
+ */
+typedef struct {
+  PyObject_HEAD
+  JS::PersistentRootedObject *promise;
+  PyObject *loop; // the event-loop the callbacks are scheduled on, None until one runs if created without a running loop
+  JSPromiseProxyState state;
+  PyObject *result;
+  PyObject *exception;
+  PyObject *cancelMessage;
+  PyObject *callback0;
+  PyObject *context0;
+  PyObject *callbacks; // list of (callback, context) tuples, or NULL
+  bool blocking; // `_asyncio_future_blocking`
+} JSPromiseProxy;
+
+/**
+ * @brief This struct is a bundle of methods used by the JSPromiseProxy type
+ *
+ * The type implements the asyncio Future protocol (`_asyncio_future_blocking`, `get_loop`, `add_done_callback`, ...),
+ * so asyncio tasks, `asyncio.gather` and alike accept it as a Future.
+ * @see https://docs.python.org/3/library/asyncio-future.html#asyncio.isfuture
+ */
+struct JSPromiseProxyMethodDefinitions {
+public:
+  /**
+   * @brief Create a new pending JSPromiseProxy
+   *
+   * @param cx - javascript context pointer
+   * @param promise - the JS Promise to wrap
+   * @param loop - the Python event-loop the done callbacks are scheduled on,
+   *               or None to bind the running loop the first time one is needed
+   * @return PyObject* - A new instance of JSPromiseProxy, or NULL on error
+   */
+  static PyObject *JSPromiseProxy_create(JSContext *cx, JS::HandleObject promise, PyObject *loop);
+
+  /**
+   * @brief Settle a pending JSPromiseProxy, and schedule its done callbacks. Does nothing if it has been cancelled.
+   *
+   * @param self - The JSPromiseProxy
+   * @param value - the fulfillment value, or the exception object if `rejected`
+   * @param rejected - whether the JS Promise has been rejected
+   * @return success, or false with the Python error indicator set
+   */
+  static bool JSPromiseProxy_settle(JSPromiseProxy *self, PyObject *value, bool rejected);
+
+  /**
+   * @brief Deallocation method (.tp_dealloc), removes the reference to the underlying JS Promise before freeing the JSPromiseProxy
+   *
+   * @param self - The JSPromiseProxy to be free'd
+   */
+  static void JSPromiseProxy_dealloc(JSPromiseProxy *self);
+
+  /**
+   * @brief .tp_traverse method
+   *
+   * @param self - The JSPromiseProxy
+   * @param visit - The function to be applied on each element of the object
+   * @param arg - The argument to the visit function
+   * @return 0 on success
+   */
+  static int JSPromiseProxy_traverse(JSPromiseProxy *self, visitproc visit, void *arg);
+
+  /**
+   * @brief .tp_clear method
+   *
+   * @param self - The JSPromiseProxy
+   * @return 0 on success
+   */
+  static int JSPromiseProxy_clear(JSPromiseProxy *self);
+
+  /**
+   * @brief .tp_repr method
+   *
+   * @param self - The JSPromiseProxy
+   * @return PyObject* - the string representation
+   */
+  static PyObject *JSPromiseProxy_repr(JSPromiseProxy *self);
+
+  /**
+   * @brief .am_await and .tp_iter method, a JSPromiseProxy is its own iterator
+   *
+   * @param self - The JSPromiseProxy
+   * @return PyObject* - self
+   */
+  static PyObject *JSPromiseProxy_await(JSPromiseProxy *self);
+
+  /**
+   * @brief .tp_iternext method, yields the JSPromiseProxy itself to the asyncio task until it is done,
+   * then returns the result (by raising StopIteration)
+   *
+   * @param self - The JSPromiseProxy
+   * @return PyObject* - self while pending, NULL once done
+   */
+  static PyObject *JSPromiseProxy_iternext(JSPromiseProxy *self);
+
+  /**
+   * @brief Getter for the `_asyncio_future_blocking` attribute
+   */
+  static PyObject *JSPromiseProxy_get_blocking(JSPromiseProxy *self, void *closure);
+
+  /**
+   * @brief Setter for the `_asyncio_future_blocking` attribute, asyncio tasks reset it to False
+   */
+  static int JSPromiseProxy_set_blocking(JSPromiseProxy *self, PyObject *value, void *closure);
+
+  /**
+   * @brief Python method get_loop
+   *
+   * @param self - The JSPromiseProxy
+   * @return PyObject* - the event-loop the JSPromiseProxy is bound to
+   */
+  static PyObject *JSPromiseProxy_get_loop(JSPromiseProxy *self, PyObject *Py_UNUSED(ignored));
+
+  /**
+   * @brief Python method done
+   *
+   * @param self - The JSPromiseProxy
+   * @return PyObject* - True if the JS Promise is settled or the JSPromiseProxy is cancelled
+   */
+  static PyObject *JSPromiseProxy_done(JSPromiseProxy *self, PyObject *Py_UNUSED(ignored));
+
+  /**
+   * @brief Python method cancelled
+   *
+   * @param self - The JSPromiseProxy
+   * @return PyObject* - True if the JSPromiseProxy is cancelled
+   */
+  static PyObject *JSPromiseProxy_cancelled(JSPromiseProxy *self, PyObject *Py_UNUSED(ignored));
+
+  /**
+   * @brief Python method result, raises the rejection reason if the JS Promise has been rejected
+   *
+   * @param self - The JSPromiseProxy
+   * @return PyObject* - the fulfillment value, or NULL with an exception set
+   */
+  static PyObject *JSPromiseProxy_result(JSPromiseProxy *self, PyObject *Py_UNUSED(ignored));
+
+  /**
+   * @brief Python method exception
+   *
+   * @param self - The JSPromiseProxy
+   * @return PyObject* - the rejection reason, None if fulfilled, or NULL with an exception set
+   */
+  static PyObject *JSPromiseProxy_exception(JSPromiseProxy *self, PyObject *Py_UNUSED(ignored));
+
+  /**
+   * @brief Python method add_done_callback(fn, *, context=None)
+   *
+   * @param self - The JSPromiseProxy
+   * @param args - the callback
+   * @param kwargs - the `contextvars.Context` to run the callback in
+   * @return PyObject* - None, or NULL on error
+   */
+  static PyObject *JSPromiseProxy_add_done_callback(JSPromiseProxy *self, PyObject *args, PyObject *kwargs);
+
+  /**
+   * @brief Python method remove_done_callback(fn)
+   *
+   * @param self - The JSPromiseProxy
+   * @param fn - the callback
+   * @return PyObject* - the number of callbacks removed
+   */
+  static PyObject *JSPromiseProxy_remove_done_callback(JSPromiseProxy *self, PyObject *fn);
+
+  /**
+   * @brief Python method cancel(msg=None). Only the Python side is cancelled, the JS Promise keeps running.
+   *
+   * @param self - The JSPromiseProxy
+   * @param args - the cancellation message
+   * @param kwargs - the cancellation message
+   * @return PyObject* - False if already done, True otherwise
+   */
+  static PyObject *JSPromiseProxy_cancel(JSPromiseProxy *self, PyObject *args, PyObject *kwargs);
+};
+
+static PyMethodDef JSPromiseProxy_methods[] = {
+  {"get_loop", (PyCFunction)JSPromiseProxyMethodDefinitions::JSPromiseProxy_get_loop, METH_NOARGS, "Return the event loop the object is bound to."},
+  {"done", (PyCFunction)JSPromiseProxyMethodDefinitions::JSPromiseProxy_done, METH_NOARGS, "Return True if the promise is settled or cancelled."},
+  {"cancelled", (PyCFunction)JSPromiseProxyMethodDefinitions::JSPromiseProxy_cancelled, METH_NOARGS, "Return True if cancelled."},
+  {"result", (PyCFunction)JSPromiseProxyMethodDefinitions::JSPromiseProxy_result, METH_NOARGS, "Return the fulfillment value, or raise the rejection reason."},
+  {"exception", (PyCFunction)JSPromiseProxyMethodDefinitions::JSPromiseProxy_exception, METH_NOARGS, "Return the rejection reason, or None if fulfilled."},
+  {"add_done_callback", (PyCFunction)JSPromiseProxyMethodDefinitions::JSPromiseProxy_add_done_callback, METH_VARARGS | METH_KEYWORDS, "Add a callback to be run when the promise is settled or cancelled."},
+  {"remove_done_callback", (PyCFunction)JSPromiseProxyMethodDefinitions::JSPromiseProxy_remove_done_callback, METH_O, "Remove all instances of a callback from the \"call when done\" list."},
+  {"cancel", (PyCFunction)JSPromiseProxyMethodDefinitions::JSPromiseProxy_cancel, METH_VARARGS | METH_KEYWORDS, "Cancel the awaiting of the promise, the promise itself keeps running."},
+  {NULL, NULL}  /* sentinel */
+};
+
+static PyGetSetDef JSPromiseProxy_getset[] = {
+  {"_asyncio_future_blocking", (getter)JSPromiseProxyMethodDefinitions::JSPromiseProxy_get_blocking, (setter)JSPromiseProxyMethodDefinitions::JSPromiseProxy_set_blocking, NULL, NULL},
+  {NULL}  /* sentinel */
+};
+
+static PyAsyncMethods JSPromiseProxy_async_methods = {
+  .am_await = (unaryfunc)JSPromiseProxyMethodDefinitions::JSPromiseProxy_await
+};
+
+/**
+ * @brief Struct for the JSPromiseProxyType, used by all JSPromiseProxy objects
+ */
+extern PyTypeObject JSPromiseProxyType;
+
+#endif
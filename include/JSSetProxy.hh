@@ -0,0 +1,197 @@
+/**
+ * @file JSSetProxy.hh
+ * @brief JSSetProxy is a custom C-implemented python type. It acts as a proxy for JS Sets from Spidermonkey, and behaves like a collections.abc.MutableSet would.
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Distributive Corp.
+ *
+ */
+
+#ifndef PythonMonkey_JSSetProxy_
+#define PythonMonkey_JSSetProxy_
+
+#include <jsapi.h>
+
+#include <Python.h>
+
+/**
+ * @brief The typedef for the backing store that will be used by JSSetProxy objects. All it contains is a pointer to the JS Set
+ *
+ */
+typedef struct {
+  PyObject_HEAD
+  JS::PersistentRootedObject *jsSet;
+} JSSetProxy;
+
+/**
+ * @brief This struct is a bundle of methods used by the JSSetProxy type
+ *
+ * Membership tests go straight to the JS Set (`JS::SetHas`), so nothing is copied.
+ * The set operators (`&`, `|`, `-`, `^`, `<=`, ...) return or compare against Python sets.
+ */
+struct JSSetProxyMethodDefinitions {
+public:
+  /**
+   * @brief Create a new JSSetProxy
+   *
+   * @param cx - javascript context pointer
+   * @param set - the JS Set
+   * @return PyObject* - A new instance of JSSetProxy, or NULL on error
+   */
+  static PyObject *JSSetProxy_create(JSContext *cx, JS::HandleObject set);
+
+  /**
+   * @brief Deallocation method (.tp_dealloc), removes the reference to the underlying JS Set before freeing the JSSetProxy
+   *
+   * @param self - The JSSetProxy to be free'd
+   */
+  static void JSSetProxy_dealloc(JSSetProxy *self);
+
+  /**
+   * @brief Length method (.sq_length), returns the number of values in the JS Set
+   *
+   * @param self - The JSSetProxy
+   * @return Py_ssize_t - The size of the JS Set
+   */
+  static Py_ssize_t JSSetProxy_length(JSSetProxy *self);
+
+  /**
+   * @brief Test method (.sq_contains), returns whether the JS Set has the value
+   *
+   * @param self - The JSSetProxy
+   * @param value - The value
+   * @return int - 1 if present, 0 if not, -1 on error
+   */
+  static int JSSetProxy_contains(JSSetProxy *self, PyObject *value);
+
+  /**
+   * @brief .tp_iter method, iterates over the values of the JS Set in insertion order
+   *
+   * @param self - The JSSetProxy
+   * @return PyObject* - the iterator
+   */
+  static PyObject *JSSetProxy_iter(JSSetProxy *self);
+
+  /**
+   * @brief .tp_repr method
+   *
+   * @param self - The JSSetProxy
+   * @return PyObject* - the string representation
+   */
+  static PyObject *JSSetProxy_repr(JSSetProxy *self);
+
+  /**
+   * @brief Comparison method (.tp_richcompare), subset/superset comparisons with other sets
+   *
+   * @param self - The JSSetProxy
+   * @param other - Any other PyObject
+   * @param op - Which boolean operator is being performed (Py_EQ for equality, Py_LE for subset, etc.)
+   * @return PyObject* - True or False, or Py_NotImplemented
+   */
+  static PyObject *JSSetProxy_richcompare(JSSetProxy *self, PyObject *other, int op);
+
+  /**
+   * @brief & method (.nb_and), the intersection as a Python set
+   */
+  static PyObject *JSSetProxy_and(PyObject *self, PyObject *other);
+
+  /**
+   * @brief | method (.nb_or), the union as a Python set
+   */
+  static PyObject *JSSetProxy_or(PyObject *self, PyObject *other);
+
+  /**
+   * @brief - method (.nb_subtract), the difference as a Python set
+   */
+  static PyObject *JSSetProxy_subtract(PyObject *self, PyObject *other);
+
+  /**
+   * @brief ^ method (.nb_xor), the symmetric difference as a Python set
+   */
+  static PyObject *JSSetProxy_xor(PyObject *self, PyObject *other);
+
+  /**
+   * @brief Python method add(value)
+   *
+   * @param self - The JSSetProxy
+   * @param value - The value to add
+   * @return PyObject* - None, or NULL on error
+   */
+  static PyObject *JSSetProxy_add(JSSetProxy *self, PyObject *value);
+
+  /**
+   * @brief Python method discard(value), does nothing if the value is absent
+   *
+   * @param self - The JSSetProxy
+   * @param value - The value to remove
+   * @return PyObject* - None, or NULL on error
+   */
+  static PyObject *JSSetProxy_discard(JSSetProxy *self, PyObject *value);
+
+  /**
+   * @brief Python method remove(value), raises KeyError if the value is absent
+   *
+   * @param self - The JSSetProxy
+   * @param value - The value to remove
+   * @return PyObject* - None, or NULL on error
+   */
+  static PyObject *JSSetProxy_remove(JSSetProxy *self, PyObject *value);
+
+  /**
+   * @brief Python method pop(), removes and returns the oldest value
+   *
+   * @param self - The JSSetProxy
+   * @return PyObject* - the value, or NULL with a KeyError set if the JS Set is empty
+   */
+  static PyObject *JSSetProxy_pop(JSSetProxy *self, PyObject *Py_UNUSED(ignored));
+
+  /**
+   * @brief Python method clear()
+   *
+   * @param self - The JSSetProxy
+   * @return PyObject* - None, or NULL on error
+   */
+  static PyObject *JSSetProxy_clear_method(JSSetProxy *self, PyObject *Py_UNUSED(ignored));
+
+  /**
+   * @brief Python method isdisjoint(other)
+   *
+   * @param self - The JSSetProxy
+   * @param other - Any iterable
+   * @return PyObject* - True if no value of other is in the JS Set
+   */
+  static PyObject *JSSetProxy_isdisjoint(JSSetProxy *self, PyObject *other);
+};
+
+/**
+ * @brief Struct for the methods that define the Sequence protocol, only `len()` and `in` are supported
+ *
+ */
+static PySequenceMethods JSSetProxy_sequence_methods = {
+  .sq_length = (lenfunc)JSSetProxyMethodDefinitions::JSSetProxy_length,
+  .sq_contains = (objobjproc)JSSetProxyMethodDefinitions::JSSetProxy_contains
+};
+
+static PyNumberMethods JSSetProxy_number_methods = {
+  .nb_subtract = (binaryfunc)JSSetProxyMethodDefinitions::JSSetProxy_subtract,
+  .nb_and = (binaryfunc)JSSetProxyMethodDefinitions::JSSetProxy_and,
+  .nb_xor = (binaryfunc)JSSetProxyMethodDefinitions::JSSetProxy_xor,
+  .nb_or = (binaryfunc)JSSetProxyMethodDefinitions::JSSetProxy_or
+};
+
+static PyMethodDef JSSetProxy_methods[] = {
+  {"add", (PyCFunction)JSSetProxyMethodDefinitions::JSSetProxy_add, METH_O, "Add a value to the Set."},
+  {"discard", (PyCFunction)JSSetProxyMethodDefinitions::JSSetProxy_discard, METH_O, "Remove a value from the Set if it is a member."},
+  {"remove", (PyCFunction)JSSetProxyMethodDefinitions::JSSetProxy_remove, METH_O, "Remove a value from the Set, raise KeyError if it is not a member."},
+  {"pop", (PyCFunction)JSSetProxyMethodDefinitions::JSSetProxy_pop, METH_NOARGS, "Remove and return the oldest value, raise KeyError if the Set is empty."},
+  {"clear", (PyCFunction)JSSetProxyMethodDefinitions::JSSetProxy_clear_method, METH_NOARGS, "Remove all values from the Set."},
+  {"isdisjoint", (PyCFunction)JSSetProxyMethodDefinitions::JSSetProxy_isdisjoint, METH_O, "Return True if the Set has no value in common with other."},
+  {NULL, NULL}  /* sentinel */
+};
+
+/**
+ * @brief Struct for the JSSetProxyType, used by all JSSetProxy objects
+ */
+extern PyTypeObject JSSetProxyType;
+
+#endif
@@ -66,7 +66,7 @@ bool enqueuePromiseJob(JSContext *cx, JS::HandleObject promise,
 
 /**
  * @brief Run all jobs in the queue. Running one job may enqueue others; continue to
- * run jobs until the queue is empty.
+ * run jobs until the queue is empty. Also backs `pm.runMicrotasks()`.
  *
  * Calling this method at the wrong time can break the web. The HTML spec
  * indicates exactly when the job queue should be drained (in HTML jargon,
@@ -88,6 +88,7 @@ bool empty() const override;
 
 /**
  * @return true if the job queue stopped draining, which results in `empty()` being false after `runJobs()`.
+ * Draining stops when a job throws.
  */
 bool isDrainingStopped() const override;
 
@@ -107,11 +108,49 @@ void queueFinalizationRegistryCallback(JSFunction *callback);
  */
 bool runFinalizationRegistryCallbacks(JSContext *cx);
 
+/**
+ * @brief Run every queued promise job in FIFO order, including the jobs enqueued by the jobs being run,
+ * until the queue is empty (a microtask checkpoint).
+ * Does nothing when called from a job, the ongoing drain runs the rest of the queue in order.
+ *
+ * @param cx - javascript context pointer
+ * @return true if all jobs ran, false if a job threw, with the Python error indicator set.
+ * The jobs that haven't run yet are kept in the queue.
+ */
+bool drainJobs(JSContext *cx);
+
+/**
+ * @brief Schedule a single drain of the job queue on the running Python event-loop,
+ * unless one is already pending on that loop or the queue is being drained right now
+ * @return success
+ */
+bool scheduleDrain();
+
+/**
+ * @brief Schedule a drain on the running Python event-loop if PythonMonkey's job queue has jobs left over,
+ * e.g. enqueued while no event-loop was running
+ * @return success, false with a RuntimeError set if no event-loop is running
+ */
+static bool scheduleDrainIfPending();
+
 private:
 
 using FunctionVector = JS::GCVector<JSFunction *, 0, js::SystemAllocPolicy>;
 JS::PersistentRooted<FunctionVector> *finalizationRegistryCallbacks;
 
+using JobVector = JS::GCVector<JSObject *, 0, js::SystemAllocPolicy>;
+JS::PersistentRooted<JobVector> *jobs; /**< the native FIFO of pending promise jobs */
+
+PyObject *drainCallback = nullptr; /**< the Python callable sent to the event-loop to drain the job queue, created once */
+PyObject *drainScheduledOn = nullptr; /**< the event-loop a drain is currently pending on, if any */
+bool draining = false; /**< whether the job queue is being drained right now */
+bool drainingStopped = false; /**< whether the last drain was stopped by a job that threw */
+
+/**
+ * @brief The debuggee's job queue, set aside by `saveJobQueue()` while a Debugger hook runs, and put back when destroyed
+ */
+class SavedQueue;
+
 /**
  * @brief Capture this JobQueue's current job queue as a SavedJobQueue and return it,
  * leaving the JobQueue's job queue empty. Destroying the returned object
@@ -124,7 +163,8 @@ JS::PersistentRooted<FunctionVector> *finalizationRegistryCallbacks;
 js::UniquePtr<JS::JobQueue::SavedJobQueue> saveJobQueue(JSContext *) override;
 
 /**
- * @brief The callback for dispatching an off-thread promise to the event loop
+ * @brief The callback for dispatching an off-thread promise to the event loop.
+ * Dispatchables are queued without taking the GIL, and handed to the main event-loop by a single long-lived dispatcher thread
  *          see https://hg.mozilla.org/releases/mozilla-esr102/file/tip/js/public/Promise.h#l580
  *              https://hg.mozilla.org/releases/mozilla-esr102/file/tip/js/src/vm/OffThreadPromiseRuntimeState.cpp#l160
  * @param closure - closure, currently the javascript context
@@ -133,6 +173,12 @@ js::UniquePtr<JS::JobQueue::SavedJobQueue> saveJobQueue(JSContext *) override;
  */
 static bool dispatchToEventLoop(void *closure, JS::Dispatchable *dispatchable);
 
+/**
+ * @brief The dispatcher thread doesn't survive `os.fork()`, reset its state in the child and start it again if needed.
+ * Registered with `os.register_at_fork` by `init()`.
+ */
+static void afterForkInChild();
+
 /**
  * @brief The callback that gets invoked whenever a Promise is rejected without a rejection handler (uncaught/unhandled exception)
  *          see https://hg.mozilla.org/releases/mozilla-esr102/file/tip/js/public/Promise.h#l268
@@ -149,12 +195,4 @@ static void promiseRejectionTracker(JSContext *cx, bool mutedErrors,
 
 }; // class
 
-/**
- * @brief Send job to the Python event-loop on main thread
- * (Thread-Safe)
- * @param pyFunc - the Python job function
- * @return success
- */
-bool sendJobToMainLoop(PyObject *pyFunc);
-
 #endif
\ No newline at end of file
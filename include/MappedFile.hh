@@ -0,0 +1,69 @@
+/**
+ * @file MappedFile.hh
+ * @brief A read-only memory mapping of a source file, so that JS source can be compiled without being copied into a buffer first
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Distributive Corp.
+ *
+ */
+
+#ifndef PythonMonkey_MappedFile_
+#define PythonMonkey_MappedFile_
+
+#include <cstddef>
+
+/**
+ * @brief A read-only, private memory mapping of a regular file, unmapped by the destructor
+ */
+class MappedFile {
+public:
+  MappedFile() = default;
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+  ~MappedFile();
+
+  /**
+   * @brief Map the file at `path`
+   *
+   * @param path - the file path, in the filesystem encoding (UTF-8 on Windows)
+   * @return success, or false with a Python OSError set
+   */
+  bool open(const char *path);
+
+  /**
+   * @brief Map the file open as `fd`, from its current position, like reading the rest of it would
+   *
+   * @param fd - an open file descriptor, which the caller keeps owning
+   * @return false without any error set if `fd` is not a regular file (a pipe, a tty...) or could not be mapped
+   */
+  bool map(int fd);
+
+  /**
+   * @return whether a file is mapped
+   */
+  bool mapped() const {
+    return isMapped;
+  }
+
+  /**
+   * @return the mapped bytes, from the start position
+   */
+  const char *data() const {
+    return length > offset ? (const char *)address + offset : "";
+  }
+
+  /**
+   * @return the number of mapped bytes, from the start position
+   */
+  size_t size() const {
+    return length > offset ? length - offset : 0;
+  }
+
+private:
+  void *address = nullptr;
+  size_t length = 0; // of the whole file
+  size_t offset = 0; // the start position
+  bool isMapped = false;
+};
+
+#endif
@@ -0,0 +1,62 @@
+/**
+ * @file ModuleLoader.hh
+ * @brief The ES module loader: resolves `import` specifiers to file URLs, loads and parses module files on helper threads, and keeps the module map
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Distributive Corp.
+ *
+ */
+
+#ifndef PythonMonkey_ModuleLoader_
+#define PythonMonkey_ModuleLoader_
+
+#include <jsapi.h>
+#include <js/CompileOptions.h>
+
+#include <Python.h>
+
+/**
+ * @brief Implements SpiderMonkey's module load hook for both static `import` declarations and dynamic `import()`.
+ * Modules are identified by the `file://` URL of their absolute path, and each one is compiled and evaluated once.
+ * While an event-loop is running, the files of a module graph are read and parsed in parallel on loader threads,
+ * and the imports waiting on them are finished on the event-loop; without one they are loaded synchronously.
+ * Relative specifiers (`./`, `../`) resolve against the importing module, or the current directory for a classic script.
+ */
+class ModuleLoader {
+public:
+  /**
+   * @brief Install the module load and `import.meta` hooks
+   *
+   * @param cx - javascript context pointer
+   */
+  static void init(JSContext *cx);
+
+  /**
+   * @brief Drop the module map, must be called before the context is destroyed
+   */
+  static void clear();
+
+  /**
+   * @brief Import a module, like the dynamic `import()` of a classic script
+   *
+   * @param cx - javascript context pointer
+   * @param specifier - the module specifier, a Python str
+   * @return PyObject* - an awaitable of the module namespace, which settles once the module graph has been
+   * loaded and evaluated, including any top-level await. Without a running event-loop, the job queue is drained
+   * and the namespace itself is returned. NULL on error
+   */
+  static PyObject *importModule(JSContext *cx, PyObject *specifier);
+
+  /**
+   * @brief Compile source code as a module, and import it. Every call creates a new module, which leaves the module map once its import settles
+   *
+   * @param cx - javascript context pointer
+   * @param options - the compile options, imports resolve against the directory of their filename
+   * @param chars - the UTF-8 source text
+   * @param length - the length of the source text in bytes
+   * @return PyObject* - the module namespace or an awaitable of it, like importModule. NULL with an error set
+   */
+  static PyObject *evalModule(JSContext *cx, const JS::ReadOnlyCompileOptions &options, const char *chars, size_t length);
+};
+
+#endif
@@ -26,18 +26,40 @@ public:
    *
    * @param cx - javascript context pointer
    * @param promise - JS::PromiseObject to be coerced
+   * @param settleInJob - if true, return an asyncio.Future settled in a promise reaction job, even if the Promise is already settled
    *
-   * @returns PyObject* pointer to the resulting PyObject
+   * @returns PyObject* pointer to the resulting PyObject, a JSPromiseProxy unless `settleInJob`
    */
-  static PyObject *getPyObject(JSContext *cx, JS::HandleObject promise);
+  static PyObject *getPyObject(JSContext *cx, JS::HandleObject promise, bool settleInJob = false);
+
+  /**
+   * @brief Convert a JS Promise for an iterator result `{ value, done }` (from an async iterator's `next()`) to a Python awaitable
+   * that resolves to the `value`, or raises StopAsyncIteration once `done`
+   *
+   * @param cx - javascript context pointer
+   * @param promise - the JS Promise returned by `next()`
+   *
+   * @returns PyObject* pointer to the resulting JSPromiseProxy
+   */
+  static PyObject *getIteratorResultPyObject(JSContext *cx, JS::HandleObject promise);
+
+  /**
+   * @brief What the JS Promise converted from a Python awaitable resolves to
+   */
+  enum ResolveAs {
+    VALUE,                // the awaited value
+    ITERATOR_RESULT,      // `{ value, done: false }`, or `{ value: undefined, done: true }` if the awaitable raises StopAsyncIteration, for `__anext__()`
+    DONE_ITERATOR_RESULT  // `{ value, done: true }`, for `aclose()`
+  };
 
   /**
    * @brief Convert a Python [awaitable](https://docs.python.org/3/library/asyncio-task.html#awaitables) object to JS Promise
    *
    * @param cx - javascript context pointer
    * @param pyObject - the python awaitable to be converted
+   * @param resolveAs - what the JS Promise resolves to
    */
-  static JSObject *toJsPromise(JSContext *cx, PyObject *pyObject);
+  static JSObject *toJsPromise(JSContext *cx, PyObject *pyObject, ResolveAs resolveAs = VALUE);
 };
 
 /**
@@ -50,7 +72,7 @@ bool PythonAwaitable_Check(PyObject *obj);
  * @brief Callback to resolve or reject the JS Promise when the Future is done
  * @see https://docs.python.org/3.9/library/asyncio-future.html#asyncio.Future.add_done_callback
  *
- * @param futureCallbackTuple - tuple( javascript context pointer, rooted JS Promise object )
+ * @param futureCallbackTuple - tuple( javascript context pointer, rooted JS Promise object, PromiseType::ResolveAs )
  * @param args - Args tuple. The callback is called with the Future object as its only argument
  */
 static PyObject *futureOnDoneCallback(PyObject *futureCallbackTuple, PyObject *args);
@@ -0,0 +1,39 @@
+/**
+ * @file PyAsyncIterableProxyHandler.hh
+ * @brief Struct for creating JS proxy objects for Python async iterators, such as async generators
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Distributive Corp.
+ *
+ */
+
+#ifndef PythonMonkey_PyAsyncIterableProxy_
+#define PythonMonkey_PyAsyncIterableProxy_
+
+
+#include "include/PyObjectProxyHandler.hh"
+
+
+/**
+ * @brief This struct is the ProxyHandler for JS Proxy async iterators pythonmonkey creates to handle coercion from python async iterables to JS Objects.
+ * The proxy wraps the original Python object, `[Symbol.asyncIterator]()` calls its `__aiter__()`.
+ * Every `next()` awaits `__anext__()` once, so the Python side only produces a value when JS asks for it.
+ *
+ */
+struct PyAsyncIterableProxyHandler : public PyObjectProxyHandler {
+public:
+  PyAsyncIterableProxyHandler() : PyObjectProxyHandler(&family) {};
+  static const char family;
+
+  bool getOwnPropertyDescriptor(
+    JSContext *cx, JS::HandleObject proxy, JS::HandleId id,
+    JS::MutableHandle<mozilla::Maybe<JS::PropertyDescriptor>> desc
+  ) const override;
+};
+
+/**
+ * @brief Check if the object can be used in Python `async for` statement
+ */
+bool PythonAsyncIterable_Check(PyObject *obj);
+
+#endif
@@ -50,4 +50,15 @@ bool keyToId(PyObject *key, JS::MutableHandleId idp);
 
 bool idToIndex(JSContext *cx, JS::HandleId id, Py_ssize_t *index);
 
+/**
+ * @brief Create a JS iterator result object `{ value, done }`.
+ * The keys are atomized once and always defined in the same order, so all the results share a single shape.
+ *
+ * @param cx - javascript context pointer
+ * @param value - the `value` property
+ * @param done - the `done` property
+ * @return JSObject* - the result object, or nullptr on error
+ */
+JSObject *newIteratorResult(JSContext *cx, JS::HandleValue value, bool done);
+
 #endif
\ No newline at end of file
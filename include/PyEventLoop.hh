@@ -14,8 +14,11 @@
 #include <Python.h>
 #include <jsapi.h>
 #include <vector>
+#include <deque>
+#include <optional>
 #include <utility>
 #include <atomic>
+#include <mutex>
 
 struct PyEventLoop {
 public:
@@ -32,23 +35,26 @@ public:
    * @see https://docs.python.org/3/library/asyncio-eventloop.html#asyncio.Handle
    */
   struct AsyncHandle {
-    using id_t = uint32_t;
+    using id_t = uint64_t; // a `timeoutID` stays below 2^53, so that a JS number holds it exactly
   public:
     explicit AsyncHandle(PyObject *handle) : _handle(handle) {};
     AsyncHandle(const AsyncHandle &old) = delete; // forbid copy-initialization
-    AsyncHandle(AsyncHandle &&old) : _handle(std::exchange(old._handle, nullptr)), _refed(old._refed.exchange(false)), _debugInfo(std::exchange(old._debugInfo, nullptr)) {}; // clear the moved-from object
+    AsyncHandle(AsyncHandle &&old) : _handle(std::exchange(old._handle, nullptr)), _refed(old._refed.exchange(false)), _debugInfo(std::exchange(old._debugInfo, nullptr)),
+      _timerScheduled(std::exchange(old._timerScheduled, false)), _timerCancelled(std::exchange(old._timerCancelled, false)) {}; // clear the moved-from object
     ~AsyncHandle() {
-      if (Py_IsInitialized()) { // the Python runtime has already been finalized when `_timeoutIdMap` is cleared at exit
+      if (Py_IsInitialized()) { // the Python runtime has already been finalized when `_timerSlots` is cleared at exit
         Py_XDECREF(_handle);
+        Py_XDECREF(_debugInfo);
       }
     }
 
     /**
-     * @brief Create a new `AsyncHandle` without an associated `asyncio.Handle` Python object
+     * @brief Create a new `AsyncHandle` without an associated `asyncio.Handle` Python object.
+     * The state of the job is tracked natively, for timers kept in a `TimerWheel`.
      * @return the timeoutId
      */
     static inline id_t newEmpty() {
-      auto handle = AsyncHandle(Py_None);
+      auto handle = AsyncHandle(nullptr);
       return AsyncHandle::getUniqueId(std::move(handle));
     }
 
@@ -67,21 +73,24 @@ public:
     bool _finishedOrCancelled();
 
     /**
-     * @brief Get the unique `timeoutID` for JS `setTimeout`/`clearTimeout` methods
+     * @brief Get the unique `timeoutID` for JS `setTimeout`/`clearTimeout` methods (Thread-Safe)
+     * The slots of released timers are reused, and the `timeoutID` is tagged with the slot's generation,
+     * so that a stale `timeoutID` never refers to a newer timer.
      * @see https://developer.mozilla.org/en-US/docs/Web/API/setTimeout#return_value
      */
-    static inline id_t getUniqueId(AsyncHandle &&handle) {
-      // TODO (Tom Tang): mutex lock
-      _timeoutIdMap.push_back(std::move(handle));
-      return _timeoutIdMap.size() - 1; // the index in `_timeoutIdMap`
-    }
-    static inline AsyncHandle *fromId(id_t timeoutID) {
-      try {
-        return &_timeoutIdMap.at(timeoutID);
-      } catch (...) { // std::out_of_range&
-        return nullptr; // invalid timeoutID
-      }
-    }
+    static id_t getUniqueId(AsyncHandle &&handle);
+
+    /**
+     * @brief Get the `AsyncHandle` of a live timer (Thread-Safe)
+     * @return nullptr if the `timeoutID` is invalid, or stale because the timer has been released
+     */
+    static AsyncHandle *fromId(id_t timeoutID);
+
+    /**
+     * @brief Release a finished or cancelled timer, so that its slot can be reused (Thread-Safe)
+     * Does nothing on invalid or stale `timeoutID`s.
+     */
+    static void releaseId(id_t timeoutID);
 
     /**
      * @brief Cancel all pending event-loop jobs.
@@ -93,8 +102,9 @@ public:
      * @brief Get the underlying `asyncio.Handle` Python object
      */
     inline PyObject *getHandleObject() const {
-      Py_INCREF(_handle); // otherwise the object would be GC-ed as the AsyncHandle destructor decreases the reference count
-      return _handle;
+      PyObject *handle = _handle ? _handle : Py_None; // no `asyncio.Handle` for timers in a `TimerWheel`
+      Py_INCREF(handle); // otherwise the object would be GC-ed as the AsyncHandle destructor decreases the reference count
+      return handle;
     }
 
     /**
@@ -116,11 +126,9 @@ public:
      * @brief Ref the timer so that the event-loop won't exit as long as the timer is active
      */
     inline void addRef() {
-      if (!_refed) {
-        _refed = true;
-        if (!_finishedOrCancelled()) { // noop if the timer is finished or canceled
-          PyEventLoop::_locker->incCounter();
-        }
+      if (!_refed && !_finishedOrCancelled()) { // noop if the timer is finished or canceled
+        _refed = true; // only refed once the counter is incremented, so that `removeRef()` stays balanced
+        PyEventLoop::_locker->incCounter();
       }
     }
 
@@ -145,15 +153,22 @@ public:
     }
 
     /**
-     * @brief Get an iterator for the `AsyncHandle`s of all timers
+     * @brief Set if a timer without an `asyncio.Handle` is waiting in its `TimerWheel` to be executed
      */
-    static inline auto &getAllTimers() {
-      return _timeoutIdMap;
+    inline void setTimerScheduled(bool scheduled) {
+      _timerScheduled = scheduled;
     }
+
+    /**
+     * @brief Get the `AsyncHandle`s of all live timers, in no particular order
+     */
+    static std::vector<AsyncHandle *> getAllTimers();
   protected:
     PyObject *_handle;
     std::atomic_bool _refed = false;
     PyObject *_debugInfo = nullptr;
+    bool _timerScheduled = false; // only used without an `asyncio.Handle`
+    bool _timerCancelled = false; // only used without an `asyncio.Handle`
   };
 
   /**
@@ -276,33 +291,50 @@ public:
     }
 
     /**
-     * @brief Increment the counter for the number of our job functions in the Python event-loop
+     * @brief Increment the counter for the number of our job functions in the Python event-loop.
+     * Purely atomic, the `_queueIsEmpty` flag is brought up to date by `prepareWait()`.
      */
     inline void incCounter() {
       _counter++;
-      Py_XDECREF(PyObject_CallMethod(_queueIsEmpty, "clear", NULL)); // _queueIsEmpty.clear()
     }
 
     /**
      * @brief Decrement the counter for the number of our job functions in the Python event-loop
      */
     inline void decCounter() {
-      _counter--;
-      if (_counter == 0) { // no job queueing
-        // Notify that the queue is empty and awake (unblock) the event-loop shield
-        Py_XDECREF(PyObject_CallMethod(_queueIsEmpty, "set", NULL)); // _queueIsEmpty.set()
-      } else if (_counter < 0) { // something went wrong
+      int counter = --_counter;
+      if (counter == 0) { // no job queueing
+        if (_waiting.exchange(false)) { // only touch the Python `asyncio.Event` if the event-loop shield is being awaited
+          // Notify that the queue is empty and awake (unblock) the event-loop shield
+          Py_XDECREF(PyObject_CallMethod(_queueIsEmpty, "set", NULL)); // _queueIsEmpty.set()
+        }
+      } else if (counter < 0) { // something went wrong
         PyErr_SetString(PyExc_RuntimeError, "Event-loop job counter went below zero.");
       }
     }
 
     /**
-     * @brief An `asyncio.Event` instance to notify that there are no queued asynchronous jobs
+     * @brief Bring the `_queueIsEmpty` flag up to date before awaiting it.
+     * The flag is then set as soon as the counter drops to zero.
+     */
+    inline void prepareWait() {
+      _waiting = true;
+      if (_counter == 0) {
+        Py_XDECREF(PyObject_CallMethod(_queueIsEmpty, "set", NULL)); // _queueIsEmpty.set()
+      } else {
+        Py_XDECREF(PyObject_CallMethod(_queueIsEmpty, "clear", NULL)); // _queueIsEmpty.clear()
+      }
+    }
+
+    /**
+     * @brief An `asyncio.Event` instance to notify that there are no queued asynchronous jobs,
+     * only kept up to date while being awaited, see `prepareWait()`
      * @see https://docs.python.org/3/library/asyncio-sync.html#asyncio.Event
      */
     PyObject *_queueIsEmpty = nullptr;
   protected:
     std::atomic_int _counter = 0;
+    std::atomic_bool _waiting = false; // whether the event-loop shield is being awaited
   };
 
   static inline PyEventLoop::Lock *_locker;
@@ -327,8 +359,26 @@ private:
   static PyThreadState *_getMainThread();
   static inline PyThreadState *_getCurrentThread();
 
+  /**
+   * @brief A `timeoutID` is made of the slot index in its low bits and the slot's generation in its high bits,
+   * which allows for about 4 million live timers at once, and 2^31 reuses of a slot before its generation wraps
+   */
+  static constexpr unsigned TIMER_ID_BITS = 53;
+  static constexpr unsigned TIMER_SLOT_BITS = 22;
+  static constexpr AsyncHandle::id_t TIMER_SLOT_MASK = (AsyncHandle::id_t(1) << TIMER_SLOT_BITS) - 1;
+  static constexpr AsyncHandle::id_t TIMER_MAX_GENERATION = (AsyncHandle::id_t(1) << (TIMER_ID_BITS - TIMER_SLOT_BITS)) - 1;
+
+  struct TimerSlot {
+    std::optional<AsyncHandle> handle; // empty if the slot is free
+    AsyncHandle::id_t generation = 1; // never 0, so that a `timeoutID` is always positive
+    size_t livePos = 0; // the position of this slot in `_liveTimers`
+  };
+
   // TODO (Tom Tang): use separate pools of IDs for different global objects
-  static inline std::vector<AsyncHandle> _timeoutIdMap;
+  static inline std::mutex _timersMutex;
+  static inline std::deque<TimerSlot> _timerSlots; // a slab of timers, growing the deque doesn't move existing slots
+  static inline std::deque<AsyncHandle::id_t> _freeTimerSlots; // indices of free slots in `_timerSlots`, reused oldest first
+  static inline std::vector<AsyncHandle::id_t> _liveTimers; // indices of occupied slots in `_timerSlots`, for iterating over live timers only
 };
 
 #endif
\ No newline at end of file
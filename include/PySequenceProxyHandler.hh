@@ -0,0 +1,58 @@
+/**
+ * @file PySequenceProxyHandler.hh
+ * @brief Struct for creating read-only JS Array-like proxy objects for Python tuples, ranges and other sequences
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Distributive Corp.
+ *
+ */
+
+#ifndef PythonMonkey_PySequenceProxy_
+#define PythonMonkey_PySequenceProxy_
+
+#include "include/PyBaseProxyHandler.hh"
+
+
+/**
+ * @brief This struct is the ProxyHandler for JS Proxy Objects pythonmonkey creates
+ *    to handle coercion from read-only python sequences (tuple, range, collections.abc.Sequence) to JS Array-like objects.
+ * `length` and indexed access go straight to the sequence (`sq_item`), so a `range(10**9)` is never materialized.
+ * Listing all of its keys (`Object.keys`) would, so that throws a RangeError past 2**24 items.
+ * The prototype is Array.prototype, whose methods are generic over `length` and indexes.
+ */
+struct PySequenceProxyHandler : public PyBaseProxyHandler {
+public:
+  PySequenceProxyHandler() : PyBaseProxyHandler(&family) {};
+  static const char family;
+
+  /**
+   * @brief Handles python object reference count when JS Proxy object is finalized
+   *
+   * @param gcx pointer to JS::GCContext
+   * @param proxy the proxy object being finalized
+   */
+  void finalize(JS::GCContext *gcx, JSObject *proxy) const override;
+
+  bool getOwnPropertyDescriptor(
+    JSContext *cx, JS::HandleObject proxy, JS::HandleId id,
+    JS::MutableHandle<mozilla::Maybe<JS::PropertyDescriptor>> desc
+  ) const override;
+
+  bool defineProperty(
+    JSContext *cx, JS::HandleObject proxy, JS::HandleId id,
+    JS::Handle<JS::PropertyDescriptor> desc, JS::ObjectOpResult &result
+  ) const override;
+
+  bool ownPropertyKeys(JSContext *cx, JS::HandleObject proxy, JS::MutableHandleIdVector props) const override;
+  bool delete_(JSContext *cx, JS::HandleObject proxy, JS::HandleId id, JS::ObjectOpResult &result) const override;
+  bool isArray(JSContext *cx, JS::HandleObject proxy, JS::IsArrayAnswer *answer) const override;
+  bool getBuiltinClass(JSContext *cx, JS::HandleObject proxy, js::ESClass *cls) const override;
+};
+
+/**
+ * @brief Check if the object is a read-only sequence: a tuple, a range, or an instance of collections.abc.Sequence
+ * that is not a collections.abc.MutableSequence. Mutable sequences keep the generic Python object proxy.
+ */
+bool PythonSequence_Check(PyObject *obj);
+
+#endif
@@ -0,0 +1,34 @@
+/**
+ * @file PySetProxyHandler.hh
+ * @brief Struct for creating JS Set-like proxy objects for Python sets and frozensets
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Distributive Corp.
+ *
+ */
+
+#ifndef PythonMonkey_PySetProxy_
+#define PythonMonkey_PySetProxy_
+
+
+#include "include/PyObjectProxyHandler.hh"
+
+
+/**
+ * @brief This struct is the ProxyHandler for JS Proxy Sets pythonmonkey creates to handle coercion from python sets to JS Objects.
+ * `has`, `size` and friends go straight to the Python set, nothing is copied.
+ * frozensets don't get the mutating methods (`add`, `delete`, `clear`).
+ *
+ */
+struct PySetProxyHandler : public PyObjectProxyHandler {
+public:
+  PySetProxyHandler() : PyObjectProxyHandler(&family) {};
+  static const char family;
+
+  bool getOwnPropertyDescriptor(
+    JSContext *cx, JS::HandleObject proxy, JS::HandleId id,
+    JS::MutableHandle<mozilla::Maybe<JS::PropertyDescriptor>> desc
+  ) const override;
+};
+
+#endif
@@ -0,0 +1,95 @@
+/**
+ * @file StencilCache.hh
+ * @brief An on-disk cache of compiled JS scripts (SpiderMonkey stencils encoded with XDR), keyed by a hash of the source and compile options
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Distributive Corp.
+ *
+ */
+
+#ifndef PythonMonkey_StencilCache_
+#define PythonMonkey_StencilCache_
+
+#include <jsapi.h>
+#include <js/CompileOptions.h>
+#include <js/experimental/JSStencil.h>
+#include <mozilla/RefPtr.h>
+
+#include <Python.h>
+
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Compiles global scripts through a directory of `<sha256>.stencil` files.
+ * The key covers the source text, the options that change the compiled code (filename, line, column, strictness, ...)
+ * and the build id of the engine, so a stale or foreign file is never decoded.
+ * Any failure of the cache itself (I/O, a corrupt file) falls back to a normal compilation.
+ */
+class StencilCache {
+public:
+  /**
+   * @brief Register the build id op that XDR decoding checks, must be called once before any use of the cache
+   */
+  static void init();
+
+  /**
+   * @brief Set the cache directory, created if missing
+   *
+   * @param path - the directory, or None to disable the cache
+   * @return success, or false with the Python error indicator set
+   */
+  static bool setDirectory(PyObject *path);
+
+  /**
+   * @return whether a cache directory is set
+   */
+  static bool enabled() {
+    return !directory.empty();
+  }
+
+  /**
+   * @brief Get the cache counters
+   *
+   * @return PyObject* - a new dict of `directory`, `hits`, `misses`, `writes` and `errors`, or NULL on error
+   */
+  static PyObject *stats();
+
+  /**
+   * @brief Get the stencil of a global script from the cache, or compile it and store it in the cache
+   *
+   * @param cx - javascript context pointer
+   * @param options - the compile options, these are part of the key
+   * @param chars - the UTF-8 source text
+   * @param length - the length of the source text in bytes
+   * @return the stencil, or nullptr with a pending JS exception if the script doesn't compile
+   */
+  static already_AddRefed<JS::Stencil> getStencil(JSContext *cx, const JS::ReadOnlyCompileOptions &options, const char *chars, size_t length);
+
+  /**
+   * @brief Compile a global script through the cache, the drop-in replacement of `JS::Compile`
+   *
+   * @param cx - javascript context pointer
+   * @param options - the compile options, these are part of the key
+   * @param chars - the UTF-8 source text
+   * @param length - the length of the source text in bytes
+   * @return the script, or nullptr with a pending JS exception
+   */
+  static JSScript *compile(JSContext *cx, const JS::ReadOnlyCompileOptions &options, const char *chars, size_t length);
+
+private:
+  static std::string directory;
+  static uint64_t hits;
+  static uint64_t misses;
+  static uint64_t writes;
+  static uint64_t errors; // unreadable, corrupt or unwritable cache files
+
+  /**
+   * @brief Get the path of the cache file for this source text and these options
+   *
+   * @return false if the key could not be computed, the script is then compiled without the cache
+   */
+  static bool cachePath(const JS::ReadOnlyCompileOptions &options, const char *chars, size_t length, std::string &path);
+};
+
+#endif
@@ -0,0 +1,111 @@
+/**
+ * @file TimerWheel.hh
+ * @brief A hierarchical timer wheel for JS timers (setTimeout/setInterval), driven by a single asyncio `call_at`
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Distributive Corp.
+ *
+ */
+
+#ifndef PythonMonkey_TimerWheel_
+#define PythonMonkey_TimerWheel_
+
+#include "include/PyEventLoop.hh"
+
+#include <Python.h>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Timers of one Python event-loop, kept natively in 4 levels of 256 slots at a 1ms resolution.
+ * Only the earliest deadline is scheduled on the event-loop (with `loop.call_at`), and all timers expiring
+ * by then fire in the same callback.
+ * @see http://www.cs.columbia.edu/~nahum/w6998/papers/sosp87-timing-wheels.pdf
+ */
+class TimerWheel {
+public:
+  using id_t = PyEventLoop::AsyncHandle::id_t;
+
+  /**
+   * @brief Get the timer wheel of a Python event-loop, creating it on first use
+   * @param loop - the Python event-loop
+   * @return nullptr on error, with the Python error indicator set
+   */
+  static TimerWheel *forLoop(PyObject *loop);
+
+  /**
+   * @brief Schedule the job function of a timer
+   * @param timeoutID - the timer, the job is dropped once this `timeoutID` gets released or cancelled
+   * @param jobFn - the job function, a new reference is kept until the timer finishes
+   * @param delaySeconds - the job function will be called after the given number of seconds
+   * @param repeat - if true, the job will be executed repeatedly on a fixed interval
+   * @return success, or false with the Python error indicator set
+   */
+  bool schedule(id_t timeoutID, PyObject *jobFn, double delaySeconds, bool repeat);
+
+private:
+  static constexpr unsigned LEVELS = 4;
+  static constexpr unsigned SLOT_BITS = 8;
+  static constexpr uint64_t SLOTS = 1u << SLOT_BITS;
+  static constexpr uint64_t SLOT_MASK = SLOTS - 1;
+  static constexpr uint64_t MAX_DELTA = (uint64_t(1) << (LEVELS * SLOT_BITS)) - 1; // about 49 days, longer timers are cascaded again
+
+  struct Entry {
+    id_t timeoutID;
+    uint64_t deadline; // in milliseconds on the event-loop's clock
+    uint64_t intervalMs;
+    bool repeat;
+    PyObject *jobFn; // strong reference
+  };
+  using Bucket = std::vector<Entry>;
+
+  explicit TimerWheel(PyObject *loop);
+  ~TimerWheel();
+
+  /**
+   * @return the current time of the event-loop's clock, in milliseconds, or `UINT64_MAX` on error
+   */
+  uint64_t currentTick();
+
+  void insert(Entry &&entry);
+  void cascade(unsigned level, uint64_t tick);
+  void advanceTo(uint64_t target, std::vector<Entry> &expired);
+  bool runTimer(Entry &entry);
+
+  /**
+   * @brief Get the earliest tick at which the wheel needs to run, either to fire or to cascade timers
+   * @return `UINT64_MAX` if the wheel is empty
+   */
+  uint64_t nextWakeUp() const;
+
+  /**
+   * @brief Make sure the event-loop calls `fire` by the next wake-up
+   */
+  bool arm();
+
+  /**
+   * @brief Drop the entries of timers that have been cancelled or released, once they make up most of the wheel
+   */
+  void sweep();
+
+  /**
+   * @brief The `loop.call_at` callback: run all expired timers and re-arm the wheel
+   */
+  static PyObject *fire(PyObject *wheelPtr, PyObject *unused);
+
+  PyObject *_loop; // strong reference
+  PyObject *_fireCallback;
+  PyObject *_armedHandle = nullptr; // the pending `asyncio.TimerHandle`, if any
+  uint64_t _armedTick = UINT64_MAX;
+  uint64_t _now; // every timer up to this tick has been processed
+  std::array<std::array<Bucket, SLOTS>, LEVELS> _levels;
+  std::array<size_t, LEVELS> _levelSizes = {};
+  size_t _size = 0;
+  size_t _sweepThreshold = 1024;
+
+  static inline std::vector<TimerWheel *> _wheels;
+};
+
+#endif
@@ -11,13 +11,38 @@
 #include <jsapi.h>
 #include <Python.h>
 
+#include <string>
+
 namespace InternalBinding {
   extern JSFunctionSpec utils[];
   extern JSFunctionSpec timers[];
+  extern JSFunctionSpec fs[];
+
+  /**
+   * @brief An entry of the internalBinding registry, see `namespaces` in src/internalBinding.cc
+   */
+  struct Namespace {
+    const char *name;
+    JSFunctionSpec *methods;
+  };
 }
 
 JSObject *createInternalBindingsForNamespace(JSContext *cx, JSFunctionSpec *methodSpecs);
-JSObject *getInternalBindingsByNamespace(JSContext *cx, JSLinearString *namespaceStr);
+
+/**
+ * @brief Look a namespace up in the internalBinding registry
+ *
+ * @return the functions of the namespace, or nullptr if there is no such namespace
+ */
+JSFunctionSpec *findInternalBindingNamespace(const std::string &name);
+
+/**
+ * @brief Get the object of an internalBinding namespace, built the first time it is asked for
+ *
+ * @param cache - the namespace objects already built, by name
+ * @return the namespace object, or nullptr if there is no such namespace or with a pending JS exception
+ */
+JSObject *getInternalBindingsByNamespace(JSContext *cx, JS::HandleObject cache, JS::HandleString namespaceStr);
 
 JSFunction *createInternalBinding(JSContext *cx);
 PyObject *getInternalBindingPyFn(JSContext *cx);
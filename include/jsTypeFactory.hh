@@ -64,6 +64,14 @@ JS::Value jsTypeFactory(JSContext *cx, PyObject *object);
  */
 JS::Value jsTypeFactorySafe(JSContext *cx, PyObject *object);
 
+/**
+ * @brief Move the Python exception on the Python error stack to the pending JS exception
+ *
+ * @param cx - Pointer to the JSContext
+ * @return false if the Python exception is a SystemExit, which is left on the Python error stack
+ */
+bool setPyException(JSContext *cx);
+
 /**
  * @brief Helper function for jsTypeFactory to create a JSFunction* through JS_NewFunction that knows how to call a python function.
  *
@@ -0,0 +1,33 @@
+/**
+ * @file registerAtFork.hh
+ * @brief Register native fork handlers with Python's `os.register_at_fork`, so that the threads PythonMonkey starts can be reset in a forked child
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Distributive Corp.
+ *
+ */
+
+#ifndef PythonMonkey_registerAtFork_
+#define PythonMonkey_registerAtFork_
+
+#include <Python.h>
+
+/**
+ * @brief Register the given handlers with `os.register_at_fork`, a NULL handler is left out.
+ * The handlers are called with the GIL held, and without arguments. Does nothing on Windows, which has no fork.
+ *
+ * @param before - called in the parent process before forking
+ * @param afterInParent - called in the parent process after forking
+ * @param afterInChild - called in the child process, where only the forking thread survives
+ * @return success, or false with the Python error indicator set
+ */
+bool registerAtFork(PyCFunction before, PyCFunction afterInParent, PyCFunction afterInChild);
+
+/**
+ * @brief Register `afterInChild` with `os.register_at_fork(after_in_child=...)`, see `registerAtFork`
+ *
+ * @return success, or false with the Python error indicator set
+ */
+bool registerAfterForkInChild(PyCFunction afterInChild);
+
+#endif
@@ -8,10 +8,20 @@ import importlib.metadata
 __version__ = importlib.metadata.version(__name__)
 del importlib
 
-# Load the module by default to expose global APIs
-# builtin_modules
-require("console")
-require("base64")
-require("timers")
-require("url")
-require("XMLHttpRequest")
+# JS Map and Set proxies work like Python's own mappings and sets
+import collections.abc
+collections.abc.MutableMapping.register(JSMapProxy)
+collections.abc.MutableSet.register(JSSetProxy)
+del collections
+
+# Expose the global APIs of the builtin_modules
+# Each module is loaded the first time one of its globals is used
+bootstrap.defineLazyGlobals(createRequire(__file__), {
+  'console': ['console'],
+  'base64': ['atob', 'btoa'],
+  'timers': ['setTimeout', 'clearTimeout', 'setImmediate', 'clearImmediate', 'setInterval', 'clearInterval'],
+  'dom-exception': ['DOMException'],
+  'event-target': ['Event', 'EventTarget'],
+  'url': ['URL', 'URLSearchParams'],
+  'XMLHttpRequest': ['XMLHttpRequest', 'XMLHttpRequestEventTarget', 'XMLHttpRequestUpload', 'ProgressEvent'],
+})
@@ -76,4 +76,52 @@ declare function internalBinding(namespace: "timers"): {
   getAllRefedTimersDebugInfo(): TimerDebugInfo[];
 };
 
+declare function internalBinding(namespace: "fs"): {
+  /**
+   * stat(2) a path, a path found missing is remembered until its directory is modified
+   * @return the `st_mode` of the file, `undefined` if it doesn't exist
+   */
+  stat(path: string): number | undefined;
+
+  /**
+   * Whether a path exists, through the same cache of missing paths as `stat`
+   */
+  exists(path: string): boolean;
+
+  /**
+   * Read a UTF-8 file into a string, decoded straight from the file bytes
+   * @return `undefined` if the file can't be opened
+   */
+  readFile(path: string): string | undefined;
+
+  /**
+   * The modification time of a path, in an unspecified unit, only meant to be compared for equality
+   * @return `undefined` if it doesn't exist
+   */
+  mtime(path: string): number | undefined;
+
+  /**
+   * Read files on background threads, for `readFile` to take them from memory if unmodified.
+   * The first existing regular file of each group of candidate paths is read.
+   */
+  prefetch(candidateGroups: string[][]): void;
+
+  /**
+   * The number of groups still being prefetched, of prefetched files not read yet, and of reads served from memory
+   */
+  prefetchStats(): { pending: number, prefetched: number, hits: number };
+
+  /**
+   * Between these calls, the directory of a path remembered as missing is only checked once for modifications.
+   * No file may be created while a resolution is in progress.
+   */
+  beginResolution(): void;
+  endResolution(): void;
+
+  /**
+   * Forget the missing paths and the prefetched files
+   */
+  clearCache(): void;
+};
+
 export = internalBinding;
@@ -162,7 +162,7 @@ function setTimeout(handler, delayMs = 0, ...args)
  */
 function clearTimeout(timeoutId) 
 {
-  // silently does nothing when an invalid timeoutId (should be a Timeout instance or an int32 value) is passed in
+  // silently does nothing when an invalid timeoutId (should be a Timeout instance or an integer) is passed in
   if (!(timeoutId instanceof Timeout) && !Number.isInteger(timeoutId))
     return;
 
@@ -4,6 +4,7 @@ stub file for type hints & documentations for the native module
 """
 
 import typing as _typing
+import os as _os
 
 
 class EvalOptions(_typing.TypedDict, total=False):
@@ -16,13 +17,94 @@ class EvalOptions(_typing.TypedDict, total=False):
   strict: bool
   module: bool
   fromPythonFrame: bool
+  cache: bool
 
 # pylint: disable=redefined-builtin
 
 
-def eval(code: str, evalOpts: EvalOptions = {}, /) -> _typing.Any:
+def eval(code: _typing.Union[str, bytes, bytearray, memoryview, _os.PathLike, _typing.IO], evalOpts: EvalOptions = {}, /) -> _typing.Any:
   """
-  JavaScript evaluator in Python
+  JavaScript evaluator in Python.
+  `code` is JS source as a str, UTF-8 bytes-like object, path or open file; paths and regular files are memory-mapped.
+  """
+
+
+def importModule(specifier: str, /) -> _typing.Union[_typing.Awaitable[_typing.Dict[str, _typing.Any]], _typing.Dict[str, _typing.Any]]:
+  """
+  Import an ES module like a dynamic `import()`, and return an awaitable of its namespace.
+  Without a running event-loop, the module is evaluated synchronously and its namespace is returned.
+  Relative specifiers resolve against the current directory.
+  """
+
+
+class CompileOptions(_typing.TypedDict, total=False):
+  filename: str
+  lineno: int
+  column: int
+  mutedErrors: bool
+  noScriptRval: bool
+  strict: bool
+  cache: bool  # compile only
+
+
+class CompileFunctionOptions(_typing.TypedDict, total=False):
+  name: str
+  filename: str
+  lineno: int
+  column: int
+  mutedErrors: bool
+  strict: bool
+
+
+class CompiledScript():
+  """
+  A compiled JavaScript script, which can be run any number of times with `run`
+  """
+
+
+def compile(code: str, options: CompileOptions = {}, /) -> CompiledScript:
+  """
+  Compile JavaScript once, so that it can be run any number of times with `run` without being parsed again
+  """
+
+
+def compileFunction(argNames: _typing.Sequence[str], body: str, options: CompileFunctionOptions = {}, /) -> _typing.Callable[..., _typing.Any]:
+  """
+  Compile a JavaScript function from its argument names and body, like `new Function(...argNames, body)`
+  """
+
+
+def compileAsync(code: str, options: CompileOptions = {}, /) -> _typing.Awaitable[CompiledScript]:
+  """
+  Compile JavaScript on a helper thread, so that the event-loop keeps running while large code is parsed.
+  Syntax errors are raised as SpiderMonkeyError when awaited.
+  """
+
+
+def run(script: CompiledScript, /) -> _typing.Any:
+  """
+  Run a compiled script in the global scope, and return the value of its last expression
+  """
+
+
+class CompileCacheStats(_typing.TypedDict):
+  directory: _typing.Optional[str]
+  hits: int
+  misses: int
+  writes: int
+  errors: int
+
+
+def setCompileCacheDir(path: _typing.Union[str, _os.PathLike, None], /) -> None:
+  """
+  Set the directory of the compiled script cache used by `eval(code, {'cache': True})` and `require`,
+  None disables it. Defaults to the PYTHONMONKEY_CACHE_DIR environment variable.
+  """
+
+
+def compileCacheStats() -> CompileCacheStats:
+  """
+  The directory and the hit, miss, write and error counters of the compiled script cache
   """
 
 
@@ -63,6 +145,16 @@ def stop() -> None:
   """
 
 
+def runMicrotasks() -> None:
+  """
+  Synchronously run all pending promise jobs (microtasks), without spinning the Python event-loop.
+
+  Jobs enqueued while running are run as well. If a job throws, draining stops,
+  the error is raised, and the jobs that haven't run yet are kept in the queue.
+  Called from a job, it does nothing: the ongoing drain runs the remaining jobs in order.
+  """
+
+
 def runProgramModule(filename: str, argv: _typing.List[str], extraPaths: _typing.List[str] = []) -> None:
   """
   Load and evaluate a program (main) module. Program modules must be written in JavaScript.
@@ -118,6 +210,24 @@ class JSMethodProxy(JSFunctionProxy, object):
   def __init__(self) -> None: "deleted"
 
 
+class JSPromiseProxy(_typing.Awaitable[_typing.Any]):
+  """
+  JavaScript Promise proxy, awaitable and usable wherever asyncio expects a Future
+  Cancelling it only stops the awaiting, the JavaScript Promise keeps running
+  """
+
+  def __init__(self) -> None: "deleted"
+  def __await__(self) -> _typing.Generator[_typing.Any, None, _typing.Any]: ...
+  def get_loop(self) -> _typing.Any: ...
+  def done(self) -> bool: ...
+  def cancelled(self) -> bool: ...
+  def result(self) -> _typing.Any: ...
+  def exception(self) -> _typing.Optional[BaseException]: ...
+  def add_done_callback(self, fn: _typing.Callable[["JSPromiseProxy"], object], *, context: _typing.Any = None) -> None: ...
+  def remove_done_callback(self, fn: _typing.Callable[["JSPromiseProxy"], object]) -> int: ...
+  def cancel(self, msg: _typing.Any = None) -> bool: ...
+
+
 class JSObjectProxy(dict):
   """
   JavaScript Object proxy dict
@@ -126,6 +236,33 @@ class JSObjectProxy(dict):
   def __init__(self) -> None: "deleted"
 
 
+class JSObjectAsyncIterableProxy(JSObjectProxy):
+  """
+  JavaScript Object proxy dict for async iterables (with a `[Symbol.asyncIterator]` method), usable in `async for`
+  """
+
+  def __aiter__(self) -> "JSObjectAsyncIterableProxy": ...
+  def __anext__(self) -> JSPromiseProxy: ...
+
+
+class JSMapProxy(_typing.MutableMapping[_typing.Any, _typing.Any]):
+  """
+  JavaScript Map proxy
+  Lookups go straight to the JS Map, JS object keys are looked up by identity
+  """
+
+  def __init__(self) -> None: "deleted"
+
+
+class JSSetProxy(_typing.MutableSet[_typing.Any]):
+  """
+  JavaScript Set proxy
+  Membership tests go straight to the JS Set, set operators return Python sets
+  """
+
+  def __init__(self) -> None: "deleted"
+
+
 class JSArrayProxy(list):
   """
   JavaScript Array proxy
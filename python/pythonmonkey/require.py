@@ -59,7 +59,7 @@ node_modules = os.path.abspath(
     "node_modules"
   )
 )
-evalOpts = {'filename': __file__, 'fromPythonFrame': True}  # type: pm.EvalOptions
+evalOpts = {'filename': __file__, 'fromPythonFrame': True, 'cache': True}  # type: pm.EvalOptions
 
 # Force to use UTF-8 encoding
 # Windows may use other encodings / code pages that have many characters missing/unrepresentable
@@ -108,7 +108,7 @@ globalThis.python.exit = pm.eval("""'use strict';
 # innermost code in ctx-module, without forcing ourselves to expose this minimalist code to
 # userland-require
 bootstrap = pm.eval("""
-'use strict'; (function IIFE(python) {
+'use strict'; (function IIFE(python, internalBinding) {
 
 const bootstrap = {
   modules: {
@@ -133,7 +133,7 @@ bootstrap.require = function bootstrapRequire(mid)
 
 bootstrap.modules.vm.runInContext = function runInContext(code, _unused_contextifiedObject, options)
 {
-  var evalOptions = {};
+  var evalOptions = { cache: true }; /* module code goes through the compiled script cache, when pm.setCompileCacheDir() set one */
 
   if (arguments.length === 2)
     options = arguments[2];
@@ -200,10 +200,17 @@ bootstrap.modules.debug = function debug(selector)
 
 /**
  * The fs module is like the Node.js fs module, except it only implements exactly what the ctx-module
- * module requires to load CommonJS modules. It is augmented heavily below by Python methods.
+ * module requires to load CommonJS modules. The file system access is native, in internalBinding('fs'),
+ * which remembers the paths that didn't exist, until their directory is modified, as module resolution
+ * probes the same misses repeatedly.
  */
+const fsBinding = internalBinding('fs');
 bootstrap.modules.fs = {
   constants: { S_IFDIR: 16384 },
+  statSync_inner: function statSync_inner(filename) {
+    const mode = fsBinding.stat(filename);
+    return typeof mode === 'undefined' ? false : { mode };
+  },
   statSync: function statSync(filename) {
     const ret = bootstrap.modules.fs.statSync_inner(filename);
     if (ret)
@@ -213,34 +220,249 @@ bootstrap.modules.fs = {
     err.code='ENOENT';
     throw err;
   },
+  existsSync: function existsSync(filename) {
+    return fsBinding.exists(filename);
+  },
+  readFileSync: function readFileSync(filename, charset) {
+    if (charset && !/^utf-?8$/i.test(charset))
+      return python.readFileSync(filename, charset); /* decoded by Python */
+
+    const contents = fsBinding.readFile(filename);
+    if (typeof contents === 'string')
+    {
+      if (bootstrap.prefetchRequires && filename.endsWith('.js'))
+        bootstrap.prefetchDependencies(filename, contents);
+      return contents;
+    }
+
+    const err = new Error('could not read file: ' + filename);
+    err.code='ENOENT';
+    throw err;
+  },
 };
 
+function dirnameOf(filename)
+{
+  return filename.slice(0, filename.lastIndexOf('/')) || '/';
+}
+
+/** Resolve the . and .. segments of a path */
+function normalizePath(path)
+{
+  const segments = [];
+  for (let segment of path.split('/'))
+  {
+    if (segment === '..' && segments.length > 1)
+      segments.pop();
+    else if (segment !== '.' && (segment !== '' || segments.length === 0))
+      segments.push(segment);
+  }
+  return segments.join('/') || '/';
+}
+
+function isAbsolutePath(filename)
+{
+  return filename.startsWith('/') || /^[A-Za-z]:\\//.test(filename);
+}
+
+/**
+ * Module filenames resolved by require(), keyed by the directory of the requiring module and the module
+ * identifier, then by the search paths of the require, so that the modules of a directory which require
+ * the same identifier only resolve it once. An entry is trusted while neither that directory nor the
+ * resolved file were modified; a module added in another directory of the search path is only seen once
+ * this map is cleared.
+ */
+bootstrap.resolutionCache = new Map();
+
+/**
+ * @param {string} dirname       the directory of the requiring module
+ * @param {string} id            the module identifier
+ * @param {string} [searchPaths] the search paths of the require, see searchPathsOf; any of them when
+ *                               undefined, which is only good enough for a hint such as prefetching
+ * @returns {string|undefined} the cached filename
+ */
+bootstrap.lookupResolution = function lookupResolution(dirname, id, searchPaths)
+{
+  const entries = bootstrap.resolutionCache.get(dirname + '\\0' + id);
+  if (!entries)
+    return undefined;
+  const candidates = typeof searchPaths === 'undefined' ? entries.values() : [entries.get(searchPaths)];
+  for (let entry of candidates)
+  {
+    if (entry && fsBinding.mtime(dirname) === entry.dirMtime && fsBinding.mtime(entry.filename) === entry.fileMtime)
+      return entry.filename;
+  }
+  return undefined;
+}
+
+/**
+ * The directories a require of the module searches for identifiers which are not paths. They are read
+ * on every require, as createRequire adds its extraPaths after the module got its require.
+ */
+function searchPathsOf(module, require)
+{
+  return (module.paths || []).concat(require.path || []).join('\\0');
+}
+
+/**
+ * Replace the require function of a module with one which goes through the resolution cache. Modules
+ * are then required by their resolved filename, which ctx-module finds without probing.
+ *
+ * @param {object} module     the CtxModule
+ * @param {string} filename   the filename of the module
+ */
+bootstrap.cacheResolutions = function cacheResolutions(module, filename)
+{
+  const require = module.require;
+  const descriptor = Object.getOwnPropertyDescriptor(module, 'require');
+  if (!filename || require.cachesResolutions || (descriptor && !descriptor.writable && !descriptor.set))
+    return;
+
+  const dirname = dirnameOf(filename);
+  function cachingRequire(id)
+  {
+    const searchPaths = searchPathsOf(module, require);
+    const cached = bootstrap.lookupResolution(dirname, id, searchPaths);
+    if (cached)
+      return require(cached);
+
+    let resolved;
+    fsBinding.beginResolution(); /* each directory is checked once for the misses cached in it */
+    try
+    {
+      resolved = require.resolve(id);
+    }
+    catch
+    {
+      return require(id); /* throws the MODULE_NOT_FOUND error */
+    }
+    finally
+    {
+      fsBinding.endResolution();
+    }
+    if (typeof resolved !== 'string' || !isAbsolutePath(resolved))
+      return require(id); /* not a file */
+
+    const key = dirname + '\\0' + id;
+    if (!bootstrap.resolutionCache.has(key))
+      bootstrap.resolutionCache.set(key, new Map());
+    bootstrap.resolutionCache.get(key).set(searchPaths, {
+      filename: resolved,
+      dirMtime: fsBinding.mtime(dirname),
+      fileMtime: fsBinding.mtime(resolved),
+    });
+    return require(resolved);
+  }
+  Object.setPrototypeOf(cachingRequire, require); /* cache, path, extensions, resolve... */
+  cachingRequire.cachesResolutions = true;
+  module.require = cachingRequire;
+}
+
+/**
+ * Wrap a require.extensions loader so that the modules it loads get a resolution caching require
+ */
+bootstrap.cachingLoader = function cachingLoader(loader)
+{
+  if (loader.cachesResolutions)
+    return loader;
+  function loadWithCachingRequire(module, filename)
+  {
+    bootstrap.cacheResolutions(module, filename);
+    return loader.apply(this, arguments);
+  }
+  loadWithCachingRequire.cachesResolutions = true;
+  return loadWithCachingRequire;
+}
+
+/**
+ * While a module is read, start reading the modules it requires on background threads, so they are
+ * already in memory when it requires them. The require() calls are found with a regular expression, a
+ * dependency which is never actually required is read for nothing. Identifiers which are not paths are
+ * only prefetched once the resolution cache knows them. Only reading is done ahead, compiling still
+ * happens on require as the module wrapper of ctx-module is part of the compiled source.
+ */
+bootstrap.prefetchRequires = true;
+
+bootstrap.prefetchDependencies = function prefetchDependencies(filename, contents)
+{
+  const dirname = dirnameOf(filename);
+  const groups = [];
+  for (let match of contents.matchAll(/\\brequire\\s*\\(\\s*(['"])([^'"\\n]+)\\1\\s*\\)/g))
+  {
+    const id = match[2];
+    if (id.startsWith('./') || id.startsWith('../') || isAbsolutePath(id))
+    {
+      const base = normalizePath(isAbsolutePath(id) ? id : dirname + '/' + id);
+      groups.push([base, base + '.js', base + '/index.js']); /* in the order of resolution, directories are skipped */
+    }
+    else
+    {
+      const cached = bootstrap.lookupResolution(dirname, id);
+      if (cached && cached.endsWith('.js'))
+        groups.push([cached]);
+    }
+  }
+  if (groups.length)
+    fsBinding.prefetch(groups);
+}
+
 /* Modules which will be available to all requires */
 bootstrap.builtinModules = { debug: bootstrap.modules.debug };
 
-return bootstrap;
-})(globalThis.python)""", evalOpts)
+/**
+ * Define globals which load the module providing them the first time one of them is read, so that a
+ * process only pays for the builtin modules it actually uses. Assigning one of these globals before
+ * it is read replaces it without loading the module.
+ *
+ * @param {function} require       the require function used to load the modules
+ * @param {object}   lazyGlobals   module identifier => array of the names of the globals it defines
+ */
+bootstrap.defineLazyGlobals = function defineLazyGlobals(require, lazyGlobals)
+{
+  for (const mid in lazyGlobals)
+  {
+    const names = Array.from(lazyGlobals[mid]);
+    const getters = {};
 
+    function load()
+    {
+      /* the modules only define a global which doesn't exist yet, so the accessors must go first */
+      for (let name of names)
+      {
+        const descriptor = Object.getOwnPropertyDescriptor(globalThis, name);
+        if (descriptor && descriptor.get === getters[name])
+          delete globalThis[name];
+      }
+      require(mid);
+    }
 
-def statSync_inner(filename: str) -> Union[Dict[str, int], bool]:
-  """
-  Inner function for statSync.
+    for (let name of names)
+    {
+      if (Object.getOwnPropertyDescriptor(globalThis, name))
+        continue;
+      getters[name] = function lazyGlobalGetter() {
+        load();
+        return globalThis[name];
+      };
+      Object.defineProperty(globalThis, name, {
+        get: getters[name],
+        set: function lazyGlobalSetter(value) {
+          Object.defineProperty(globalThis, name, { value, writable: true, enumerable: true, configurable: true });
+        },
+        enumerable: true,
+        configurable: true,
+      });
+    }
+  }
+}
 
-  Returns:
-      Union[Dict[str, int], False]: The mode of the file or False if the file doesn't exist.
-  """
-  from os import stat
-  filename = os.path.normpath(filename)
-  if (os.path.exists(filename)):
-    sb = stat(filename)
-    return {'mode': sb.st_mode}
-  else:
-    return False
+return bootstrap;
+})""", evalOpts)(globalThis.python, pm.internalBinding)
 
 
 def readFileSync(filename, charset) -> str:
   """
-  Utility function for reading files.
+  Utility function for reading files in charsets other than UTF-8, which internalBinding('fs') reads natively.
   Returns:
       str: The contents of the file
   """
@@ -249,14 +471,7 @@ def readFileSync(filename, charset) -> str:
     return fileHnd.read()
 
 
-def existsSync(filename: str) -> bool:
-  filename = os.path.normpath(filename)
-  return os.path.exists(filename)
-
-
-bootstrap.modules.fs.statSync_inner = statSync_inner
-bootstrap.modules.fs.readFileSync = readFileSync
-bootstrap.modules.fs.existsSync = existsSync
+globalThis.python.readFileSync = readFileSync
 
 # Read ctx-module module from disk and invoke so that this file is the "main module" and ctx-module has
 # require and exports symbols injected from the bootstrap object above. Current PythonMonkey bugs
@@ -271,7 +486,7 @@ with open(node_modules + "/ctx-module/ctx-module.js", "r") as ctxModuleSource:
 {
 """ + ctxModuleSource.read() + """
 })
-""", {'filename': node_modules + "/ctx-module/ctx-module.js", 'lineno': 0})
+""", {'filename': node_modules + "/ctx-module/ctx-module.js", 'lineno': 0, 'cache': True})
 initCtxModule(bootstrap.require, bootstrap.modules['ctx-module'])
 
 
@@ -352,7 +567,9 @@ function createRequireInner(filename, bootstrap, extraPaths, isMain)
   for (let ext in module.require.extensions)
     delete module.require.extensions[ext];
   module.require.extensions['.py'] = loadPythonModule;
-  Object.assign(module.require.extensions, extCopy);
+  for (let ext in extCopy)
+    module.require.extensions[ext] = bootstrap.cachingLoader(extCopy[ext]);
+  bootstrap.cacheResolutions(module, filename);
 
   if (isMain)
   {
@@ -393,7 +610,11 @@ def createRequire(filename, extraPaths: Union[List[str], Literal[False]] = False
 
 
 bootstrap.requireFromDisk = createRequireInner(None, bootstrap, '', False)
-bootstrap.inspect = bootstrap.requireFromDisk('util').inspect
+# util is big, it is only loaded once debug output needs to inspect a value
+pm.eval("""(bootstrap) => Object.defineProperty(bootstrap, 'inspect', {
+  get: () => bootstrap.requireFromDisk('util').inspect,
+  configurable: true,
+})""", evalOpts)(bootstrap)
 
 # API: pm.runProgramModule
 
@@ -411,7 +632,7 @@ def runProgramModule(filename, argv, extraPaths=[]):
   globalThis.__filename = fullFilename
   globalThis.__dirname = os.path.dirname(fullFilename)
   with open(fullFilename, encoding="utf-8", mode="r") as mainModuleSource:
-    pm.eval(mainModuleSource.read(), {'filename': fullFilename, 'noScriptRval': True})
+    pm.eval(mainModuleSource.read(), {'filename': fullFilename, 'noScriptRval': True, 'cache': True})
     # forcibly run in file mode. We shouldn't be getting the last expression of the script as the result value.
 
 # The pythonmonkey require export. Every time it is used, the stack is inspected so that the filename
@@ -0,0 +1,365 @@
+/**
+ * @file CompiledScript.cc
+ * @brief CompiledScript is a custom C-implemented python type. It holds a compiled JS script (a SpiderMonkey stencil) that can be run any number of times.
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Distributive Corp.
+ *
+ */
+
+#include "include/CompiledScript.hh"
+
+#include "include/modules/pythonmonkey/pythonmonkey.hh"
+#include "include/PyEventLoop.hh"
+#include "include/pyshim.hh"
+#include "include/registerAtFork.hh"
+#include "include/setSpiderMonkeyException.hh"
+#include "include/StencilCache.hh"
+
+#include <jsapi.h>
+#include <js/experimental/CompileScript.h>
+#include <js/experimental/JSStencil.h>
+#include <js/SourceText.h>
+
+#include <Python.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+
+// private
+// The number of scripts compiled at once, more `compileAsync` calls wait in the queue
+static constexpr size_t COMPILE_THREAD_COUNT = 4;
+
+// private
+// The native stack a helper thread may use for parsing, below the smallest default thread stack (512KiB on macOS)
+static constexpr size_t HELPER_THREAD_STACK_QUOTA = 400 * 1024;
+
+// private
+/**
+ * @brief A compilation running on a helper thread. The helper thread only touches `source`, `settings`, `fc` and `stencil`,
+ * everything else is used with the GIL held on the event-loop thread.
+ */
+struct CompileJob {
+  std::string source; // UTF-8, copied so that the Python str can go away
+  CompiledScriptSettings settings;
+  PyObject *future; // strong reference
+  JS::FrontendContext *fc = nullptr;
+  RefPtr<JS::Stencil> stencil;
+};
+
+void CompiledScriptSettings::apply(JS::CompileOptions &options) const {
+  options.setFileAndLine(filename.c_str(), lineno)
+  .setColumn(JS::ColumnNumberOneOrigin(column))
+  .setMutedErrors(mutedErrors)
+  .setNoScriptRval(noScriptRval);
+  if (strict) {
+    options.setForceStrictMode();
+  }
+}
+
+// private
+static void destroyJob(CompileJob *job) {
+  if (job->fc) {
+    JS::DestroyFrontendContext(job->fc);
+  }
+  Py_XDECREF(job->future);
+  delete job;
+}
+
+// private
+/**
+ * @brief Settle the Future of a finished compilation, runs on the event-loop thread
+ */
+static PyObject *finishCompilation(PyObject *jobPtr, PyObject *Py_UNUSED(unused)) {
+  CompileJob *job = (CompileJob *)PyLong_AsVoidPtr(jobPtr);
+  PyEventLoop::Future future(job->future); // takes over the reference
+  job->future = nullptr;
+
+  if (!future.isCancelled()) {
+    if (job->stencil) {
+      PyObject *script = CompiledScriptMethodDefinitions::CompiledScript_create(job->stencil.forget(), job->settings.filename.c_str());
+      if (script) {
+        future.setResult(script);
+        Py_DECREF(script);
+      }
+    } else {
+      if (job->fc && JS::HadFrontendErrors(job->fc)) {
+        // report the syntax errors the same way `pm.eval` would
+        JS::CompileOptions options(GLOBAL_CX);
+        job->settings.apply(options);
+        JS::ConvertFrontendErrorsToRuntimeErrors(GLOBAL_CX, job->fc, options);
+        setSpiderMonkeyException(GLOBAL_CX);
+      } else {
+        PyErr_NoMemory();
+      }
+      PyObject *type, *value, *traceback;
+      PyErr_Fetch(&type, &value, &traceback);
+      PyErr_NormalizeException(&type, &value, &traceback);
+      if (value) {
+        future.setException(value);
+      }
+      Py_XDECREF(type);
+      Py_XDECREF(value);
+      Py_XDECREF(traceback);
+    }
+  }
+
+  destroyJob(job);
+  if (PyErr_Occurred()) {
+    return NULL;
+  }
+  Py_RETURN_NONE;
+}
+static PyMethodDef finishCompilationDef = {"finishCompilation", finishCompilation, METH_NOARGS, NULL};
+
+// private
+static std::mutex compileQueueLock;
+static std::condition_variable compileThreadsStopped;
+static std::deque<CompileJob *> compileQueue;
+static size_t compileThreads = 0;
+static bool shuttingDown = false; // set at interpreter exit, the helper threads then never take the GIL again
+
+// private
+static void compileOnHelperThread(CompileJob *job) {
+  job->fc = JS::NewFrontendContext();
+  if (job->fc) {
+    JS::SetNativeStackQuota(job->fc, HELPER_THREAD_STACK_QUOTA);
+    JS::CompileOptions options((JS::CompileOptions::ForFrontendContext()));
+    job->settings.apply(options);
+    JS::SourceText<mozilla::Utf8Unit> source;
+    if (source.init(job->fc, job->source.data(), job->source.size(), JS::SourceOwnership::Borrowed)) {
+      JS::CompilationStorage compileStorage;
+      job->stencil = JS::CompileGlobalScriptToStencil(job->fc, options, source, compileStorage);
+    }
+  }
+  job->source.clear();
+  job->source.shrink_to_fit(); // the stencil keeps its own copy of the source
+}
+
+// private
+/**
+ * @brief Hand the result over to the event-loop the Future belongs to, `call_soon_threadsafe` wakes it up through its own self-pipe
+ */
+static void postToLoop(CompileJob *job) {
+  PyGILState_STATE gstate = PyGILState_Ensure();
+  PyObject *jobPtr = PyLong_FromVoidPtr(job);
+  PyObject *callback = jobPtr ? PyCFunction_New(&finishCompilationDef, jobPtr) : NULL;
+  Py_XDECREF(jobPtr);
+  PyObject *loop = PyObject_CallMethod(job->future, "get_loop", NULL);
+  PyObject *handle = (loop && callback) ? PyObject_CallMethod(loop, "call_soon_threadsafe", "O", callback) : NULL;
+  if (!handle) {
+    PyErr_Clear(); // the event-loop is closed
+    destroyJob(job);
+  }
+  Py_XDECREF(handle);
+  Py_XDECREF(loop);
+  Py_XDECREF(callback);
+  PyGILState_Release(gstate);
+}
+
+// private
+static void compileThreadMain() {
+  std::unique_lock<std::mutex> lock(compileQueueLock);
+  while (!shuttingDown && !compileQueue.empty()) {
+    CompileJob *job = compileQueue.front();
+    compileQueue.pop_front();
+    lock.unlock();
+    compileOnHelperThread(job);
+    lock.lock();
+    if (shuttingDown) {
+      break; // nobody is left to await it, the job is leaked as freeing it needs the GIL
+    }
+    // `stopCompileThreads` waits for this thread with the GIL released, so the interpreter isn't finalizing yet
+    lock.unlock();
+    postToLoop(job);
+    lock.lock();
+  }
+  compileThreads--;
+  compileThreadsStopped.notify_all();
+}
+
+// private
+/**
+ * @brief Registered with `atexit`: drop the queued compilations and wait for the running ones,
+ * so that no helper thread calls `PyGILState_Ensure` once the interpreter is finalizing
+ */
+static PyObject *stopCompileThreads(PyObject *Py_UNUSED(self), PyObject *Py_UNUSED(_)) {
+  std::deque<CompileJob *> dropped;
+  {
+    std::lock_guard<std::mutex> lock(compileQueueLock);
+    shuttingDown = true;
+    dropped.swap(compileQueue);
+  }
+  for (CompileJob *job : dropped) {
+    destroyJob(job);
+  }
+
+  Py_BEGIN_ALLOW_THREADS
+  {
+    std::unique_lock<std::mutex> lock(compileQueueLock);
+    compileThreadsStopped.wait(lock, []() { return compileThreads == 0; });
+  }
+  Py_END_ALLOW_THREADS
+  Py_RETURN_NONE;
+}
+static PyMethodDef stopCompileThreadsDef = {"stopCompileThreads", stopCompileThreads, METH_NOARGS, NULL};
+
+// private
+/**
+ * @brief The compile threads don't survive `os.fork()`, and one of them may have held `compileQueueLock`.
+ * The child starts over with a new lock and an empty queue, the compilations queued in the parent are leaked.
+ */
+static PyObject *afterForkInChild(PyObject *Py_UNUSED(self), PyObject *Py_UNUSED(_)) {
+  new (&compileQueueLock) std::mutex();
+  new (&compileThreadsStopped) std::condition_variable();
+  new (&compileQueue) std::deque<CompileJob *>();
+  compileThreads = 0;
+  Py_RETURN_NONE;
+}
+
+// private
+/**
+ * @brief Register `stopCompileThreads` with `atexit` and `afterForkInChild` with `os.register_at_fork`, once, before the first compile thread starts
+ *
+ * @return success, or false with the Python error indicator set
+ */
+static bool registerHandlers() {
+  static bool registered = false;
+  if (registered) {
+    return true;
+  }
+
+  PyObject *atexit = PyImport_ImportModule("atexit");
+  PyObject *stop = atexit ? PyCFunction_New(&stopCompileThreadsDef, NULL) : NULL;
+  PyObject *result = stop ? PyObject_CallMethod(atexit, "register", "O", stop) : NULL;
+  Py_XDECREF(atexit);
+  Py_XDECREF(stop);
+  if (!result) {
+    return false;
+  }
+  Py_DECREF(result);
+
+  if (!registerAfterForkInChild(afterForkInChild)) {
+    return false;
+  }
+
+  registered = true;
+  return true;
+}
+
+// private
+/**
+ * @brief Queue a compilation, a new compile thread is only started while there are fewer than `COMPILE_THREAD_COUNT`
+ *
+ * @return false if the interpreter is exiting, the job is then left to the caller
+ */
+static bool enqueueCompilation(CompileJob *job) {
+  std::lock_guard<std::mutex> lock(compileQueueLock);
+  if (shuttingDown) {
+    return false;
+  }
+  compileQueue.push_back(job);
+  if (compileThreads < COMPILE_THREAD_COUNT) {
+    compileThreads++;
+    std::thread(compileThreadMain).detach();
+  }
+  return true;
+}
+
+PyObject *CompiledScriptMethodDefinitions::CompiledScript_create(already_AddRefed<JS::Stencil> stencil, const char *filename) {
+  RefPtr<JS::Stencil> ownedStencil = stencil;
+  CompiledScript *self = (CompiledScript *)CompiledScriptType.tp_alloc(&CompiledScriptType, 0);
+  if (!self) {
+    return NULL;
+  }
+  self->filename = PyUnicode_FromString(filename);
+  if (!self->filename) {
+    Py_DECREF(self);
+    return NULL;
+  }
+  self->stencil = ownedStencil.forget().take();
+  return (PyObject *)self;
+}
+
+PyObject *CompiledScriptMethodDefinitions::compile(JSContext *cx, PyObject *source, const CompiledScriptSettings &settings, bool useCache) {
+  Py_ssize_t length;
+  const char *chars = PyUnicode_AsUTF8AndSize(source, &length);
+  if (!chars) {
+    return NULL;
+  }
+
+  JS::CompileOptions options(cx);
+  settings.apply(options);
+  RefPtr<JS::Stencil> stencil;
+  if (useCache) {
+    stencil = StencilCache::getStencil(cx, options, chars, length);
+  } else {
+    JS::SourceText<mozilla::Utf8Unit> sourceText;
+    if (sourceText.init(cx, chars, length, JS::SourceOwnership::Borrowed)) {
+      stencil = JS::CompileGlobalScriptToStencil(cx, options, sourceText);
+    }
+  }
+  if (!stencil) {
+    setSpiderMonkeyException(cx);
+    return NULL;
+  }
+  return CompiledScript_create(stencil.forget(), settings.filename.c_str());
+}
+
+void CompiledScriptMethodDefinitions::CompiledScript_dealloc(CompiledScript *self) {
+  if (self->stencil) {
+    JS::StencilRelease(self->stencil);
+  }
+  delete self->script;
+  Py_XDECREF(self->filename);
+  Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+PyObject *CompiledScriptMethodDefinitions::CompiledScript_repr(CompiledScript *self) {
+  return PyUnicode_FromFormat("<pythonmonkey.CompiledScript %R>", self->filename);
+}
+
+PyObject *CompiledScriptMethodDefinitions::compileAsync(PyObject *source, CompiledScriptSettings &&settings) {
+  Py_ssize_t length;
+  const char *chars = PyUnicode_AsUTF8AndSize(source, &length);
+  if (!chars) {
+    return NULL;
+  }
+
+  PyEventLoop loop = PyEventLoop::getRunningLoop();
+  if (!loop.initialized()) {
+    return NULL;
+  }
+  if (!registerHandlers()) {
+    return NULL;
+  }
+  PyEventLoop::Future future = loop.createFuture();
+  if (PyErr_Occurred()) {
+    return NULL;
+  }
+  PyObject *futureObj = future.getFutureObject();
+
+  CompileJob *job = new CompileJob{std::string(chars, length), std::move(settings), futureObj};
+  if (!enqueueCompilation(job)) {
+    destroyJob(job);
+    PyErr_SetString(PyExc_RuntimeError, "cannot compile asynchronously while the interpreter is exiting");
+    return NULL;
+  }
+  return future.getFutureObject();
+}
+
+JSScript *CompiledScriptMethodDefinitions::instantiate(JSContext *cx, CompiledScript *self) {
+  if (!self->script) {
+    JS::InstantiateOptions options;
+    JSScript *script = JS::InstantiateGlobalStencil(cx, options, self->stencil);
+    if (!script) {
+      return nullptr;
+    }
+    self->script = new JS::PersistentRootedScript(cx, script); // not compiled as run-once, so it can be executed again
+  }
+  return *self->script;
+}
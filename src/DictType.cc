@@ -17,7 +17,11 @@
 
 
 PyObject *DictType::getPyObject(JSContext *cx, JS::Handle<JS::Value> jsObject) {
-  JSObjectProxy *proxy = (JSObjectProxy *)PyObject_CallObject((PyObject *)&JSObjectProxyType, NULL);
+  return DictType::getPyObject(cx, jsObject, &JSObjectProxyType);
+}
+
+PyObject *DictType::getPyObject(JSContext *cx, JS::Handle<JS::Value> jsObject, PyTypeObject *proxyType) {
+  JSObjectProxy *proxy = (JSObjectProxy *)PyObject_CallObject((PyObject *)proxyType, NULL);
   if (proxy != NULL) {
     JS::RootedObject obj(cx);
     JS_ValueToObject(cx, jsObject, &obj);
@@ -0,0 +1,165 @@
+/**
+ * @file HelperThreadPool.cc
+ * @brief The thread pool running SpiderMonkey's helper thread tasks (background GC, off-thread compilation...), owned by PythonMonkey so that it survives `os.fork()`
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Distributive Corp.
+ *
+ */
+
+#include "include/HelperThreadPool.hh"
+#include "include/registerAtFork.hh"
+
+#include <js/HelperThreadAPI.h>
+
+#include <Python.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <thread>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+// private
+// The stack SpiderMonkey expects of a helper thread, the same as its own thread pool uses
+static constexpr size_t HELPER_THREAD_STACK_SIZE = 2048 * 1024;
+
+// private
+/**
+ * @brief The state of the pool. The mutex and condition variable are constructed in place,
+ * so that they can be constructed again in a forked child, where the threads that used them are gone.
+ */
+static struct {
+  alignas(std::mutex) unsigned char lockStorage[sizeof(std::mutex)];
+  alignas(std::condition_variable) unsigned char conditionStorage[sizeof(std::condition_variable)];
+  std::deque<JS::HelperThreadTask *> tasks;
+  size_t threadCount = 0;
+  size_t running = 0; // tasks being run by a helper thread
+  bool paused = false; // for a fork
+  bool initialized = false;
+
+  std::mutex &lock() {
+    return *reinterpret_cast<std::mutex *>(lockStorage);
+  }
+  std::condition_variable &condition() {
+    return *reinterpret_cast<std::condition_variable *>(conditionStorage);
+  }
+} pool;
+
+#ifndef _WIN32
+// private
+static void *helperThreadMain(void *) {
+  std::unique_lock<std::mutex> lock(pool.lock());
+  for (;;) {
+    pool.condition().wait(lock, [] { return !pool.paused && !pool.tasks.empty(); });
+    JS::HelperThreadTask *task = pool.tasks.front();
+    pool.tasks.pop_front();
+    pool.running++;
+    lock.unlock();
+    JS::RunHelperThreadTask(task);
+    lock.lock();
+    pool.running--;
+    if (pool.paused && pool.running == 0) {
+      pool.condition().notify_all(); // beforeFork is waiting
+    }
+  }
+  return nullptr;
+}
+
+// private
+static void startHelperThreads() {
+  pthread_attr_t attr;
+  pthread_attr_init(&attr);
+  pthread_attr_setstacksize(&attr, HELPER_THREAD_STACK_SIZE);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+  for (size_t i = 0; i < pool.threadCount; i++) {
+    pthread_t thread;
+    pthread_create(&thread, &attr, helperThreadMain, nullptr);
+  }
+  pthread_attr_destroy(&attr);
+}
+
+// private
+static void dispatchTask(JS::HelperThreadTask *task) {
+  {
+    std::lock_guard<std::mutex> lock(pool.lock());
+    pool.tasks.push_back(task);
+  }
+  pool.condition().notify_one();
+}
+#endif
+
+void HelperThreadPool::init() {
+#ifndef _WIN32
+  new (pool.lockStorage) std::mutex();
+  new (pool.conditionStorage) std::condition_variable();
+  pool.threadCount = std::clamp<size_t>(std::thread::hardware_concurrency(), 2, 8);
+  pool.initialized = true;
+  JS::SetHelperThreadTaskCallback(dispatchTask, pool.threadCount, HELPER_THREAD_STACK_SIZE);
+  startHelperThreads();
+#endif
+}
+
+void HelperThreadPool::beforeFork() {
+  if (!pool.initialized) {
+    return;
+  }
+  // The GIL stays held, helper thread tasks never need it, and no other Python thread can start JS meanwhile
+  std::unique_lock<std::mutex> lock(pool.lock());
+  pool.paused = true;
+  pool.condition().wait(lock, [] { return pool.running == 0; });
+  lock.release(); // held across the fork, so that no other thread can be holding it when the child is created
+}
+
+void HelperThreadPool::afterForkInParent() {
+  if (!pool.initialized) {
+    return;
+  }
+  pool.paused = false;
+  pool.lock().unlock();
+  pool.condition().notify_all();
+}
+
+void HelperThreadPool::afterForkInChild() {
+#ifndef _WIN32
+  if (!pool.initialized) {
+    return;
+  }
+  // The helper threads didn't survive the fork, and may have been waiting on the condition variable
+  new (pool.lockStorage) std::mutex();
+  new (pool.conditionStorage) std::condition_variable();
+  pool.running = 0;
+  pool.paused = false;
+  startHelperThreads();
+#endif
+}
+
+// private
+static PyObject *beforeForkHandler(PyObject *Py_UNUSED(self), PyObject *Py_UNUSED(_)) {
+  HelperThreadPool::beforeFork();
+  Py_RETURN_NONE;
+}
+
+// private
+static PyObject *afterForkInParentHandler(PyObject *Py_UNUSED(self), PyObject *Py_UNUSED(_)) {
+  HelperThreadPool::afterForkInParent();
+  Py_RETURN_NONE;
+}
+
+// private
+static PyObject *afterForkInChildHandler(PyObject *Py_UNUSED(self), PyObject *Py_UNUSED(_)) {
+  HelperThreadPool::afterForkInChild();
+  Py_RETURN_NONE;
+}
+
+bool HelperThreadPool::registerForkHandlers() {
+  if (!pool.initialized) {
+    return true;
+  }
+  return registerAtFork(beforeForkHandler, afterForkInParentHandler, afterForkInChildHandler);
+}
@@ -25,6 +25,10 @@
 #include <Python.h>
 #include "include/pyshim.hh"
 
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
 
 void JSArrayProxyMethodDefinitions::JSArrayProxy_dealloc(JSArrayProxy *self)
 {
@@ -83,17 +87,93 @@ PyObject *JSArrayProxyMethodDefinitions::JSArrayProxy_get(JSArrayProxy *self, Py
 }
 
 // private
-static PyObject *list_slice(JSArrayProxy *self, Py_ssize_t ilow, Py_ssize_t ihigh)
+// reads count elements of jsArray, every step elements starting at start, appending them to elements
+static bool array_read_range(JS::HandleObject jsArray, Py_ssize_t start, Py_ssize_t count, Py_ssize_t step, JS::RootedValueVector &elements)
 {
-  JS::Rooted<JS::ValueArray<2>> jArgs(GLOBAL_CX);
-  jArgs[0].setInt32(ilow);
-  jArgs[1].setInt32(ihigh);
-  JS::RootedValue jReturnedArray(GLOBAL_CX);
-  if (!JS_CallFunctionName(GLOBAL_CX, *(self->jsArray), "slice", jArgs, &jReturnedArray)) {
+  size_t offset = elements.length();
+  if (!elements.growBy(count)) {
+    PyErr_NoMemory();
+    return false;
+  }
+
+  for (Py_ssize_t index = 0, cur = start; index < count; index++, cur += step) {
+    if (!JS_GetElement(GLOBAL_CX, jsArray, cur, elements[offset + index])) {
+      PyErr_Format(PyExc_SystemError, "%s JSAPI call failed", JSArrayProxyType.tp_name);
+      return false;
+    }
+  }
+  return true;
+}
+
+// private
+// writes elements into jsArray, every step elements starting at start. The array must already have the required length
+static bool array_write_range(JS::HandleObject jsArray, Py_ssize_t start, Py_ssize_t step, JS::HandleValueArray elements)
+{
+  for (size_t index = 0, cur = start; index < elements.length(); index++, cur += step) {
+    if (!JS_SetElement(GLOBAL_CX, jsArray, cur, elements[index])) {
+      PyErr_Format(PyExc_SystemError, "%s JSAPI call failed", JSArrayProxyType.tp_name);
+      return false;
+    }
+  }
+  return true;
+}
+
+// private
+// converts the items of a python iterable to JS values once, up front, so that bulk mutations can then be done in a single pass.
+// JSArrayProxy values are copied straight from the underlying JSArray.
+static bool iterable_to_values(PyObject *iterable, JS::RootedValueVector &elements, const char *errorMessage)
+{
+  if (PyObject_TypeCheck(iterable, &JSArrayProxyType)) {
+    JSArrayProxy *other = (JSArrayProxy *)iterable;
+    return array_read_range(*(other->jsArray), 0, JSArrayProxyMethodDefinitions::JSArrayProxy_length(other), 1, elements);
+  }
+
+  PyObject *seq = PySequence_Fast(iterable, errorMessage);
+  if (!seq) {
+    return false;
+  }
+
+  Py_ssize_t seqLength = PySequence_Fast_GET_SIZE(seq);
+  if (!elements.reserve(elements.length() + seqLength)) {
+    Py_DECREF(seq);
+    PyErr_NoMemory();
+    return false;
+  }
+
+  PyObject **seqItems = PySequence_Fast_ITEMS(seq);
+  for (Py_ssize_t index = 0; index < seqLength; index++) {
+    elements.infallibleAppend(jsTypeFactory(GLOBAL_CX, seqItems[index]));
+    if (PyErr_Occurred()) { // the item could not be converted, nothing has been mutated yet
+      Py_DECREF(seq);
+      return false;
+    }
+  }
+
+  Py_DECREF(seq);
+  return true;
+}
+
+// private
+static PyObject *array_from_values(JS::HandleValueArray elements)
+{
+  JS::RootedObject jArray(GLOBAL_CX, JS::NewArrayObject(GLOBAL_CX, elements));
+  if (!jArray) {
     PyErr_Format(PyExc_SystemError, "%s JSAPI call failed", JSArrayProxyType.tp_name);
     return NULL;
   }
-  return pyTypeFactory(GLOBAL_CX, jReturnedArray);
+
+  JS::RootedValue jArrayValue(GLOBAL_CX, JS::ObjectValue(*jArray));
+  return pyTypeFactory(GLOBAL_CX, jArrayValue);
+}
+
+// private
+static PyObject *list_slice(JSArrayProxy *self, Py_ssize_t ilow, Py_ssize_t ihigh)
+{
+  JS::RootedValueVector elements(GLOBAL_CX);
+  if (ihigh > ilow && !array_read_range(*(self->jsArray), ilow, ihigh - ilow, 1, elements)) {
+    return NULL;
+  }
+  return array_from_values(elements);
 }
 
 PyObject *JSArrayProxyMethodDefinitions::JSArrayProxy_get_subscript(JSArrayProxy *self, PyObject *key)
@@ -124,7 +204,7 @@ PyObject *JSArrayProxyMethodDefinitions::JSArrayProxy_get_subscript(JSArrayProxy
     return pyTypeFactory(GLOBAL_CX, value);
   }
   else if (PySlice_Check(key)) {
-    Py_ssize_t start, stop, step, slicelength, index;
+    Py_ssize_t start, stop, step, slicelength;
 
     if (PySlice_Unpack(key, &start, &stop, &step) < 0) {
       return NULL;
@@ -139,18 +219,11 @@ PyObject *JSArrayProxyMethodDefinitions::JSArrayProxy_get_subscript(JSArrayProxy
       return list_slice(self, start, stop);
     }
     else {
-      JS::RootedObject jCombinedArray(GLOBAL_CX, JS::NewArrayObject(GLOBAL_CX, slicelength));
-
-      JS::RootedValue elementVal(GLOBAL_CX);
-      for (size_t cur = start, index = 0; index < slicelength; cur += (size_t)step, index++) {
-        JS_GetElement(GLOBAL_CX, *(self->jsArray), cur, &elementVal);
-        JS_SetElement(GLOBAL_CX, jCombinedArray, index, elementVal);
+      JS::RootedValueVector elements(GLOBAL_CX);
+      if (!array_read_range(*(self->jsArray), start, slicelength, step, elements)) {
+        return NULL;
       }
-
-      JS::RootedValue jCombinedArrayValue(GLOBAL_CX);
-      jCombinedArrayValue.setObjectOrNull(jCombinedArray);
-
-      return pyTypeFactory(GLOBAL_CX, jCombinedArrayValue);
+      return array_from_values(elements);
     }
   }
   else {
@@ -165,43 +238,12 @@ PyObject *JSArrayProxyMethodDefinitions::JSArrayProxy_get_subscript(JSArrayProxy
 // private
 static int list_ass_slice(JSArrayProxy *self, Py_ssize_t ilow, Py_ssize_t ihigh, PyObject *v)
 {
-  /* Because [X]DECREF can recursively invoke list operations on
-     this list, we must postpone all [X]DECREF activity until
-     after the list is back in its canonical shape.  Therefore
-     we must allocate an additional array, 'recycle', into which
-     we temporarily copy the items that are deleted from the
-     list. :-( */
-  PyObject **item;
-  PyObject **vitem = NULL;
-  PyObject *v_as_SF = NULL;   /* PySequence_Fast(v) */
-  Py_ssize_t n;   /* # of elements in replacement list */
-  Py_ssize_t norig;   /* # of elements in list getting replaced */
-  Py_ssize_t d;   /* Change in size */
-  Py_ssize_t k;
-  size_t s;
-  int result = -1;              /* guilty until proved innocent */
-#define b ((PyListObject *)v)
   Py_ssize_t selfLength = JSArrayProxyMethodDefinitions::JSArrayProxy_length(self);
-  if (v == NULL) {
-    n = 0;
-  }
-  else {
-    if ((PyListObject *)self == b) {
-      /* Special case "a[i:j] = a" -- copy b first */
-      v = list_slice(self, 0, selfLength);
-      if (v == NULL) {
-        return result;
-      }
-      result = list_ass_slice(self, ilow, ihigh, v);
-      Py_DECREF(v);
-      return result;
-    }
-    v_as_SF = PySequence_Fast(v, "can only assign an iterable");
-    if (v_as_SF == NULL) {
-      return result;
-    }
-    n = PySequence_Fast_GET_SIZE(v_as_SF);
-    vitem = PySequence_Fast_ITEMS(v_as_SF);
+
+  // convert the replacement items up front, this also takes care of "a[i:j] = a" since a is read before being modified
+  JS::RootedValueVector replacement(GLOBAL_CX);
+  if (v != NULL && !iterable_to_values(v, replacement, "can only assign an iterable")) {
+    return -1;
   }
 
   if (ilow < 0) {
@@ -218,49 +260,36 @@ static int list_ass_slice(JSArrayProxy *self, Py_ssize_t ilow, Py_ssize_t ihigh,
     ihigh = selfLength;
   }
 
-  norig = ihigh - ilow;
-  assert(norig >= 0);
-  d = n - norig;
+  Py_ssize_t n = replacement.length();   /* # of elements in replacement list */
+  Py_ssize_t d = n - (ihigh - ilow);     /* Change in size */
 
   if (selfLength + d == 0) {
-    Py_XDECREF(v_as_SF);
     JSArrayProxyMethodDefinitions::JSArrayProxy_clear_method(self);
     return 0;
   }
 
-  if (d < 0) {   /* Delete -d items */
-    JS::RootedValue elementVal(GLOBAL_CX);
-    for (size_t index = ihigh, count = 0; count < selfLength - ihigh; index++, count++) {
-      JS_GetElement(GLOBAL_CX, *(self->jsArray), index, &elementVal);
-      JS_SetElement(GLOBAL_CX, *(self->jsArray), index+d, elementVal);
+  if (d != 0) {
+    // move the tail of the array to its new position in a single pass
+    JS::RootedValueVector tail(GLOBAL_CX);
+    if (!array_read_range(*(self->jsArray), ihigh, selfLength - ihigh, 1, tail)) {
+      return -1;
     }
 
-    JS::SetArrayLength(GLOBAL_CX, *(self->jsArray), selfLength + d);
-  }
-  else if (d > 0) { /* Insert d items */
-    k = selfLength;
-
-    JS::SetArrayLength(GLOBAL_CX, *(self->jsArray), k + d);
-
-    selfLength = k + d;
+    if (!JS::SetArrayLength(GLOBAL_CX, *(self->jsArray), selfLength + d)) {
+      PyErr_Format(PyExc_SystemError, "%s JSAPI call failed", JSArrayProxyType.tp_name);
+      return -1;
+    }
 
-    JS::RootedValue elementVal(GLOBAL_CX);
-    for (size_t index = ihigh, count = 0; count < k - ihigh; index++, count++) {
-      JS_GetElement(GLOBAL_CX, *(self->jsArray), index, &elementVal);
-      JS_SetElement(GLOBAL_CX, *(self->jsArray), index+d, elementVal);
+    if (!array_write_range(*(self->jsArray), ihigh + d, 1, tail)) {
+      return -1;
     }
   }
 
-  JS::RootedValue elementVal(GLOBAL_CX);
-  for (k = 0; k < n; k++, ilow++) {
-    elementVal.set(jsTypeFactory(GLOBAL_CX, vitem[k]));
-    JS_SetElement(GLOBAL_CX, *(self->jsArray), ilow, elementVal);
+  if (!array_write_range(*(self->jsArray), ilow, 1, replacement)) {
+    return -1;
   }
 
-  result = 0;
-  Py_XDECREF(v_as_SF);
-  return result;
-#undef b
+  return 0;
 }
 
 int JSArrayProxyMethodDefinitions::JSArrayProxy_assign_key(JSArrayProxy *self, PyObject *key, PyObject *value)
@@ -318,9 +347,6 @@ int JSArrayProxyMethodDefinitions::JSArrayProxy_assign_key(JSArrayProxy *self, P
 
     if (value == NULL) {
       /* delete slice */
-      size_t cur;
-      Py_ssize_t i;
-
       if (slicelength <= 0) {
         return 0;
       }
@@ -331,80 +357,53 @@ int JSArrayProxyMethodDefinitions::JSArrayProxy_assign_key(JSArrayProxy *self, P
         step = -step;
       }
 
-      /* drawing pictures might help understand these for
-         loops. Basically, we memmove the parts of the
-         list that are *not* part of the slice: step-1
-         items for each item that is part of the slice,
-         and then tail end of the list that was not
-         covered by the slice */
-      JS::RootedValue elementVal(GLOBAL_CX);
-      for (cur = start, i = 0; cur < (size_t)stop; cur += step, i++) {
-        Py_ssize_t lim = step - 1;
-
-        if (cur + step >= (size_t)selfSize) {
-          lim = selfSize - cur - 1;
-        }
+      // keep every element from start onwards that is not part of the slice, then write them back compacted
+      JS::RootedValueVector remaining(GLOBAL_CX);
+      if (!array_read_range(*(self->jsArray), start, selfSize - start, 1, remaining)) {
+        return -1;
+      }
 
-        for (size_t index = cur, count = 0; count < lim; index++, count++) {
-          JS_GetElement(GLOBAL_CX, *(self->jsArray), index + 1, &elementVal);
-          JS_SetElement(GLOBAL_CX, *(self->jsArray), index - i, elementVal);
+      size_t kept = 0;
+      for (size_t index = 0; index < remaining.length(); index++) {
+        if (index % step != 0 || index / step >= (size_t)slicelength) {
+          remaining[kept++].set(remaining[index].get());
         }
       }
+      remaining.shrinkBy(remaining.length() - kept);
 
-      cur = start + (size_t)slicelength * step;
-
-      if (cur < (size_t)selfSize) {
-        for (size_t index = cur, count = 0; count < selfSize - cur; index++, count++) {
-          JS_GetElement(GLOBAL_CX, *(self->jsArray), index, &elementVal);
-          JS_SetElement(GLOBAL_CX, *(self->jsArray), index - slicelength, elementVal);
-        }
+      if (!array_write_range(*(self->jsArray), start, 1, remaining)) {
+        return -1;
       }
 
-      JS::SetArrayLength(GLOBAL_CX, *(self->jsArray), selfSize - slicelength);
+      if (!JS::SetArrayLength(GLOBAL_CX, *(self->jsArray), selfSize - slicelength)) {
+        PyErr_Format(PyExc_SystemError, "%s JSAPI call failed", JSArrayProxyType.tp_name);
+        return -1;
+      }
 
       return 0;
     }
     else {
       /* assign slice */
-      PyObject *ins, *seq;
-      PyObject **seqitems, **selfitems;
-      Py_ssize_t i;
-      size_t cur;
-
-      /* protect against a[::-1] = a */
-      if ((PyListObject *)self == (PyListObject *)value) {
-        seq = list_slice((JSArrayProxy *)value, 0, JSArrayProxy_length((JSArrayProxy *)value));
-      }
-      else {
-        seq = PySequence_Fast(value, "must assign iterable to extended slice");
-      }
-
-      if (!seq) {
+      // converting value first protects against a[::-1] = a
+      JS::RootedValueVector replacement(GLOBAL_CX);
+      if (!iterable_to_values(value, replacement, "must assign iterable to extended slice")) {
         return -1;
       }
 
-      if (PySequence_Fast_GET_SIZE(seq) != slicelength) {
+      if ((Py_ssize_t)replacement.length() != slicelength) {
         PyErr_Format(PyExc_ValueError, "attempt to assign sequence of size %zd to extended slice of size %zd",
-          PySequence_Fast_GET_SIZE(seq), slicelength);
-        Py_DECREF(seq);
+          (Py_ssize_t)replacement.length(), slicelength);
         return -1;
       }
 
       if (!slicelength) {
-        Py_DECREF(seq);
         return 0;
       }
 
-      seqitems = PySequence_Fast_ITEMS(seq);
-
-      JS::RootedValue elementVal(GLOBAL_CX);
-      for (cur = start, i = 0; i < slicelength; cur += (size_t)step, i++) {
-        elementVal.set(jsTypeFactory(GLOBAL_CX, seqitems[i]));
-        JS_SetElement(GLOBAL_CX, *(self->jsArray), cur, elementVal);
+      if (!array_write_range(*(self->jsArray), start, step, replacement)) {
+        return -1;
       }
 
-      Py_DECREF(seq);
-
       return 0;
     }
   }
@@ -632,32 +631,20 @@ PyObject *JSArrayProxyMethodDefinitions::JSArrayProxy_concat(JSArrayProxy *self,
     }
   }
 
-  JS::RootedObject jCombinedArray(GLOBAL_CX, JS::NewArrayObject(GLOBAL_CX, (size_t)sizeSelf + (size_t)sizeValue));
-
-  JS::RootedValue elementVal(GLOBAL_CX);
-
-  for (Py_ssize_t inputIdx = 0; inputIdx < sizeSelf; inputIdx++) {
-    JS_GetElement(GLOBAL_CX, *(self->jsArray), inputIdx, &elementVal);
-    JS_SetElement(GLOBAL_CX, jCombinedArray, inputIdx, elementVal);
+  JS::RootedValueVector elements(GLOBAL_CX);
+  if (!elements.reserve((size_t)sizeSelf + (size_t)sizeValue)) {
+    return PyErr_NoMemory();
   }
 
-  if (PyObject_TypeCheck(value, &JSArrayProxyType)) {
-    for (Py_ssize_t inputIdx = 0; inputIdx < sizeValue; inputIdx++) {
-      JS_GetElement(GLOBAL_CX, *(((JSArrayProxy *)value)->jsArray), inputIdx, &elementVal);
-      JS_SetElement(GLOBAL_CX, jCombinedArray, sizeSelf + inputIdx, elementVal);
-    }
-  } else {
-    for (Py_ssize_t inputIdx = 0; inputIdx < sizeValue; inputIdx++) {
-      PyObject *item = PyList_GetItem(value, inputIdx);
-      elementVal.set(jsTypeFactory(GLOBAL_CX, item));
-      JS_SetElement(GLOBAL_CX, jCombinedArray, sizeSelf + inputIdx, elementVal);
-    }
+  if (!array_read_range(*(self->jsArray), 0, sizeSelf, 1, elements)) {
+    return NULL;
   }
 
-  JS::RootedValue jCombinedArrayValue(GLOBAL_CX);
-  jCombinedArrayValue.setObjectOrNull(jCombinedArray);
+  if (!iterable_to_values(value, elements, "can only concatenate list to list")) {
+    return NULL;
+  }
 
-  return pyTypeFactory(GLOBAL_CX, jCombinedArrayValue);
+  return array_from_values(elements);
 }
 
 PyObject *JSArrayProxyMethodDefinitions::JSArrayProxy_repeat(JSArrayProxy *self, Py_ssize_t n) {
@@ -670,21 +657,23 @@ PyObject *JSArrayProxyMethodDefinitions::JSArrayProxy_repeat(JSArrayProxy *self,
     return PyErr_NoMemory();
   }
 
-  JS::RootedObject jCombinedArray(GLOBAL_CX, JS::NewArrayObject(GLOBAL_CX, input_size * n));
-  // repeat within new array
-  // one might think of using copyWithin but in SpiderMonkey it's implemented in JS!
-  JS::RootedValue elementVal(GLOBAL_CX);
-  for (Py_ssize_t inputIdx = 0; inputIdx < input_size; inputIdx++) {
-    JS_GetElement(GLOBAL_CX, *(self->jsArray), inputIdx, &elementVal);
-    for (Py_ssize_t repeatIdx = 0; repeatIdx < n; repeatIdx++) {
-      JS_SetElement(GLOBAL_CX, jCombinedArray, repeatIdx * input_size + inputIdx, elementVal);
-    }
+  // read the source elements once, then lay down the copies back to back
+  JS::RootedValueVector elements(GLOBAL_CX);
+  if (!elements.reserve(input_size * n)) {
+    return PyErr_NoMemory();
+  }
+
+  if (!array_read_range(*(self->jsArray), 0, input_size, 1, elements)) {
+    return NULL;
   }
 
-  JS::RootedValue jCombinedArrayValue(GLOBAL_CX);
-  jCombinedArrayValue.setObjectOrNull(jCombinedArray);
+  for (Py_ssize_t repeatIdx = 1; repeatIdx < n; repeatIdx++) {
+    for (Py_ssize_t inputIdx = 0; inputIdx < input_size; inputIdx++) {
+      elements.infallibleAppend(elements[inputIdx].get());
+    }
+  }
 
-  return pyTypeFactory(GLOBAL_CX, jCombinedArrayValue);
+  return array_from_values(elements);
 }
 
 int JSArrayProxyMethodDefinitions::JSArrayProxy_contains(JSArrayProxy *self, PyObject *element) {
@@ -706,20 +695,11 @@ int JSArrayProxyMethodDefinitions::JSArrayProxy_contains(JSArrayProxy *self, PyO
 }
 
 PyObject *JSArrayProxyMethodDefinitions::JSArrayProxy_inplace_concat(JSArrayProxy *self, PyObject *value) {
-  Py_ssize_t selfLength = JSArrayProxy_length(self);
-  Py_ssize_t valueLength = Py_SIZE(value);
-
-  // allocate extra spacePy_SIZE
-  JS::SetArrayLength(GLOBAL_CX, *(self->jsArray), selfLength + valueLength);
-
-  JS::RootedValue jValue(GLOBAL_CX, jsTypeFactory(GLOBAL_CX, value));
-  JS::RootedObject jRootedValue = JS::RootedObject(GLOBAL_CX, jValue.toObjectOrNull());
-
-  JS::RootedValue elementVal(GLOBAL_CX);
-  for (Py_ssize_t inputIdx = 0; inputIdx < valueLength; inputIdx++) {
-    JS_GetElement(GLOBAL_CX, jRootedValue, inputIdx, &elementVal);
-    JS_SetElement(GLOBAL_CX, *(self->jsArray), selfLength + inputIdx, elementVal);
+  PyObject *result = JSArrayProxy_extend(self, value);
+  if (!result) {
+    return NULL;
   }
+  Py_DECREF(result);
 
   Py_INCREF(self);
   return (PyObject *)self;
@@ -742,15 +722,21 @@ PyObject *JSArrayProxyMethodDefinitions::JSArrayProxy_inplace_repeat(JSArrayProx
     return PyErr_NoMemory();
   }
 
-  JS::SetArrayLength(GLOBAL_CX, *(self->jsArray), input_size * n);
-
   // repeat within self
   // one might think of using copyWithin but in SpiderMonkey it's implemented in JS!
-  JS::RootedValue elementVal(GLOBAL_CX);
-  for (Py_ssize_t inputIdx = 0; inputIdx < input_size; inputIdx++) {
-    JS_GetElement(GLOBAL_CX, *(self->jsArray), inputIdx, &elementVal);
-    for (Py_ssize_t repeatIdx = 0; repeatIdx < n; repeatIdx++) {
-      JS_SetElement(GLOBAL_CX, *(self->jsArray), repeatIdx * input_size + inputIdx, elementVal);
+  JS::RootedValueVector elements(GLOBAL_CX);
+  if (!array_read_range(*(self->jsArray), 0, input_size, 1, elements)) {
+    return NULL;
+  }
+
+  if (!JS::SetArrayLength(GLOBAL_CX, *(self->jsArray), input_size * n)) {
+    PyErr_Format(PyExc_SystemError, "%s JSAPI call failed", JSArrayProxyType.tp_name);
+    return NULL;
+  }
+
+  for (Py_ssize_t repeatIdx = 1; repeatIdx < n; repeatIdx++) {
+    if (!array_write_range(*(self->jsArray), repeatIdx * input_size, 1, elements)) {
+      return NULL;
     }
   }
 
@@ -764,15 +750,7 @@ PyObject *JSArrayProxyMethodDefinitions::JSArrayProxy_clear_method(JSArrayProxy
 }
 
 PyObject *JSArrayProxyMethodDefinitions::JSArrayProxy_copy(JSArrayProxy *self) {
-  JS::Rooted<JS::ValueArray<2>> jArgs(GLOBAL_CX);
-  jArgs[0].setInt32(0);
-  jArgs[1].setInt32(JSArrayProxy_length(self));
-  JS::RootedValue jReturnedArray(GLOBAL_CX);
-  if (!JS_CallFunctionName(GLOBAL_CX, *(self->jsArray), "slice", jArgs, &jReturnedArray)) {
-    PyErr_Format(PyExc_SystemError, "%s JSAPI call failed", JSArrayProxyType.tp_name);
-    return NULL;
-  }
-  return pyTypeFactory(GLOBAL_CX, jReturnedArray);
+  return list_slice(self, 0, JSArrayProxy_length(self));
 }
 
 PyObject *JSArrayProxyMethodDefinitions::JSArrayProxy_append(JSArrayProxy *self, PyObject *value) {
@@ -835,65 +813,42 @@ PyObject *JSArrayProxyMethodDefinitions::JSArrayProxy_insert(JSArrayProxy *self,
 }
 
 PyObject *JSArrayProxyMethodDefinitions::JSArrayProxy_extend(JSArrayProxy *self, PyObject *iterable) {
-  if (PyList_CheckExact(iterable) || PyTuple_CheckExact(iterable) || (PyObject *)self == iterable) {
-    iterable = PySequence_Fast(iterable, "argument must be iterable");
-    if (!iterable) {
-      return NULL;
-    }
+  JS::RootedValueVector elements(GLOBAL_CX);
 
-    Py_ssize_t n = PySequence_Fast_GET_SIZE(iterable);
-    if (n == 0) {
-      /* short circuit when iterable is empty */
-      Py_DECREF(iterable);
-      Py_RETURN_NONE;
-    }
-
-    Py_ssize_t m = JSArrayProxy_length(self);
-
-    JS::SetArrayLength(GLOBAL_CX, *(self->jsArray), m + n);
-
-    // populate the end of self with iterable's items.
-    PyObject **src = PySequence_Fast_ITEMS(iterable);
-    for (Py_ssize_t i = 0; i < n; i++) {
-      PyObject *o = src[i];
-      JS::RootedValue jValue(GLOBAL_CX, jsTypeFactory(GLOBAL_CX, o));
-      JS_SetElement(GLOBAL_CX, *(self->jsArray), m + i, jValue);
+  if (PyList_CheckExact(iterable) || PyTuple_CheckExact(iterable) || PyObject_TypeCheck(iterable, &JSArrayProxyType)) {
+    if (!iterable_to_values(iterable, elements, "argument must be iterable")) {
+      return NULL;
     }
-
-    Py_DECREF(iterable);
   }
   else {
     PyObject *it = PyObject_GetIter(iterable);
     if (it == NULL) {
       return NULL;
     }
-    PyObject *(*iternext)(PyObject *) = *Py_TYPE(it)->tp_iternext;
+    bool converted = iterable_to_values(it, elements, "argument must be iterable");
+    Py_DECREF(it);
+    if (!converted) {
+      return NULL;
+    }
+  }
 
-    Py_ssize_t len = JSArrayProxy_length(self);
+  if (elements.length() == 0) {
+    /* short circuit when iterable is empty */
+    Py_RETURN_NONE;
+  }
 
-    for (;; ) {
-      PyObject *item = iternext(it);
-      if (item == NULL) {
-        if (PyErr_Occurred()) {
-          if (PyErr_ExceptionMatches(PyExc_StopIteration)) {
-            PyErr_Clear();
-          }
-          else {
-            Py_DECREF(it);
-            return NULL;
-          }
-        }
-        break;
-      }
+  // grow once, then populate the end of self with iterable's items
+  Py_ssize_t selfLength = JSArrayProxy_length(self);
 
-      JS::SetArrayLength(GLOBAL_CX, *(self->jsArray), len + 1);
-      JS::RootedValue jValue(GLOBAL_CX, jsTypeFactory(GLOBAL_CX, item));
-      JS_SetElement(GLOBAL_CX, *(self->jsArray), len, jValue);
-      len++;
-    }
+  if (!JS::SetArrayLength(GLOBAL_CX, *(self->jsArray), selfLength + elements.length())) {
+    PyErr_Format(PyExc_SystemError, "%s JSAPI call failed", JSArrayProxyType.tp_name);
+    return NULL;
+  }
 
-    Py_DECREF(it);
+  if (!array_write_range(*(self->jsArray), selfLength, 1, elements)) {
+    return NULL;
   }
+
   Py_RETURN_NONE;
 }
 
@@ -1076,61 +1031,95 @@ PyObject *JSArrayProxyMethodDefinitions::JSArrayProxy_reverse(JSArrayProxy *self
 }
 
 // private
-static bool sort_compare_key_func(JSContext *cx, unsigned argc, JS::Value *vp) {
-  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+// a stable bottom-up merge sort of a permutation. `lessThan` returns 1, 0, or -1 on error, which stops the sort right away.
+// Unlike std::stable_sort, an inconsistent ordering (NaN keys, a user-defined __lt__) can only produce some permutation, never undefined behavior.
+template<typename LessThan>
+static bool merge_sort(std::vector<Py_ssize_t> &order, LessThan lessThan) {
+  size_t length = order.size();
+  std::vector<Py_ssize_t> merged(length);
+  for (size_t width = 1; width < length; width *= 2) {
+    for (size_t low = 0; low < length; low += 2 * width) {
+      size_t mid = std::min(low + width, length);
+      size_t high = std::min(low + 2 * width, length);
+      size_t left = low, right = mid, out = low;
+      while (left < mid && right < high) {
+        int cmp = lessThan(order[right], order[left]); // only a strictly smaller right element goes first, so the sort is stable
+        if (cmp < 0) {
+          return false;
+        }
+        merged[out++] = cmp > 0 ? order[right++] : order[left++];
+      }
+      while (left < mid) {
+        merged[out++] = order[left++];
+      }
+      while (right < high) {
+        merged[out++] = order[right++];
+      }
+    }
+    order.swap(merged);
+  }
+  return true;
+}
 
-  JS::RootedObject callee(cx, &args.callee());
+// private
+// decorate-sort-undecorate: the key function is called exactly once per element, the resulting keys are
+// ordered natively with python rich comparison, and the permutation is written back to the JSArray in one pass
+static PyObject *sort_with_key_func(JSArrayProxy *self, PyObject *keyfunc, bool reverse) {
+  Py_ssize_t selfLength = JSArrayProxyMethodDefinitions::JSArrayProxy_length(self);
 
-  JS::RootedValue keyFunc(cx);
-  if (!JS_GetProperty(cx, callee, "_key_func_param", &keyFunc)) {
-    PyErr_Format(PyExc_SystemError, "%s JSAPI call failed", JSArrayProxyType.tp_name);
-    return false;
+  JS::RootedValueVector elements(GLOBAL_CX);
+  if (!elements.resize(selfLength)) {
+    return PyErr_NoMemory();
   }
-  PyObject *keyfunc = (PyObject *)keyFunc.toPrivate();
 
-  JS::RootedValue reverseValue(cx);
-  if (!JS_GetProperty(cx, callee, "_reverse_param", &reverseValue)) {
-    PyErr_Format(PyExc_SystemError, "%s JSAPI call failed", JSArrayProxyType.tp_name);
-    return false;
-  }
-  bool reverse = reverseValue.toBoolean();
+  std::vector<PyObject *> keys;
+  keys.reserve(selfLength);
 
-  JS::RootedValue elementVal0(cx, args[0]);
-  PyObject *args_0 = pyTypeFactory(cx, elementVal0);
-  PyObject *args_0_result = PyObject_CallFunction(keyfunc, "O", args_0);
-  Py_DECREF(args_0);
-  if (!args_0_result) {
-    return false;
+  for (Py_ssize_t index = 0; index < selfLength; index++) {
+    if (!JS_GetElement(GLOBAL_CX, *(self->jsArray), index, elements[index])) {
+      PyErr_Format(PyExc_SystemError, "%s JSAPI call failed", JSArrayProxyType.tp_name);
+      goto error;
+    }
+    PyObject *item = pyTypeFactory(GLOBAL_CX, elements[index]);
+    PyObject *key = PyObject_CallOneArg(keyfunc, item);
+    Py_DECREF(item);
+    if (!key) {
+      goto error;
+    }
+    keys.push_back(key);
   }
 
-  JS::RootedValue elementVal1(cx, args[1]);
-  PyObject *args_1 = pyTypeFactory(cx, elementVal1);
-  PyObject *args_1_result = PyObject_CallFunction(keyfunc, "O", args_1);
-  Py_DECREF(args_1);
-  if (!args_1_result) {
-    return false;
-  }
+  {
+    std::vector<Py_ssize_t> order(selfLength);
+    std::iota(order.begin(), order.end(), 0);
 
-  int cmp = PyObject_RichCompareBool(args_0_result, args_1_result, Py_LT);
-  if (cmp > 0) {
-    args.rval().setInt32(reverse ? 1 : -1);
-  } else if (cmp == 0) {
-    cmp = PyObject_RichCompareBool(args_0_result, args_1_result, Py_EQ);
-    if (cmp > 0) {
-      args.rval().setInt32(0);
-    }
-    else if (cmp == 0) {
-      args.rval().setInt32(reverse ? -1 : 1);
+    // comparing as (b < a) when reversed keeps equal keys in their original order, same as list.sort
+    bool sorted = merge_sort(order, [&](Py_ssize_t a, Py_ssize_t b) {
+      return reverse ? PyObject_RichCompareBool(keys[b], keys[a], Py_LT) : PyObject_RichCompareBool(keys[a], keys[b], Py_LT);
+    });
+
+    if (!sorted) {
+      goto error;
     }
-    else {
-      return false;
+
+    for (Py_ssize_t index = 0; index < selfLength; index++) {
+      if (!JS_SetElement(GLOBAL_CX, *(self->jsArray), index, elements[order[index]])) {
+        PyErr_Format(PyExc_SystemError, "%s JSAPI call failed", JSArrayProxyType.tp_name);
+        goto error;
+      }
     }
   }
-  else {
-    return false;
+
+  for (PyObject *key : keys) {
+    Py_DECREF(key);
   }
+  Py_RETURN_NONE;
 
-  return true;
+error:
+  for (PyObject *key : keys) {
+    Py_DECREF(key);
+  }
+  return NULL;
 }
 
 // private
@@ -1196,41 +1185,8 @@ PyObject *JSArrayProxyMethodDefinitions::JSArrayProxy_sort(JSArrayProxy *self, P
         // we got a python key function, check if two-argument js style or standard python 1-arg
         PyObject *code = PyFunction_GetCode(keyfunc);
         if (((PyCodeObject *)code)->co_argcount == 1) {
-          // adapt to python style, provide js-style comp wrapper that does it the python way, which is < based with calls to keyFunc
-          JS::RootedObject funObj(GLOBAL_CX, JS_GetFunctionObject(JS_NewFunction(GLOBAL_CX, sort_compare_key_func, 2, 0, NULL)));
-
-          JS::RootedValue privateValue(GLOBAL_CX, JS::PrivateValue(keyfunc));
-          if (!JS_SetProperty(GLOBAL_CX, funObj, "_key_func_param", privateValue)) {  // JS::SetReservedSlot(functionObj, KeyFuncSlot, JS::PrivateValue(keyfunc)); does not work
-            PyErr_Format(PyExc_SystemError, "%s JSAPI call failed", JSArrayProxyType.tp_name);
-            return NULL;
-          }
-
-          JS::RootedValue reverseValue(GLOBAL_CX);
-          reverseValue.setBoolean(reverse);
-          if (!JS_SetProperty(GLOBAL_CX, funObj, "_reverse_param", reverseValue)) {
-            PyErr_Format(PyExc_SystemError, "%s JSAPI call failed", JSArrayProxyType.tp_name);
-            return NULL;
-          }
-
-          JS::Rooted<JS::ValueArray<1>> jArgs(GLOBAL_CX);
-          jArgs[0].setObject(*funObj);
-          if (!JS_CallFunctionName(GLOBAL_CX, *(self->jsArray), "sort", jArgs, &jReturnedArray)) {
-            if (!PyErr_Occurred()) {
-              PyErr_Format(PyExc_SystemError, "%s JSAPI call failed", JSArrayProxyType.tp_name);
-            }
-            return NULL;
-          }
-
-          // cleanup
-          if (!JS_DeleteProperty(GLOBAL_CX, funObj, "_key_func_param")) {
-            PyErr_Format(PyExc_SystemError, "%s JSAPI call failed", JSArrayProxyType.tp_name);
-            return NULL;
-          }
-
-          if (!JS_DeleteProperty(GLOBAL_CX, funObj, "_reverse_param")) {
-            PyErr_Format(PyExc_SystemError, "%s JSAPI call failed", JSArrayProxyType.tp_name);
-            return NULL;
-          }
+          // python style key function, compute the keys once per element and sort on them
+          return sort_with_key_func(self, keyfunc, reverse);
         }
         else {
           // two-arg js-style
@@ -1259,29 +1215,7 @@ PyObject *JSArrayProxyMethodDefinitions::JSArrayProxy_sort(JSArrayProxy *self, P
         }
       }
       else if (PyCFunction_Check(keyfunc)) {
-        JS::RootedObject funObj(GLOBAL_CX, JS_GetFunctionObject(JS_NewFunction(GLOBAL_CX, sort_compare_key_func, 2, 0, NULL)));
-
-        JS::RootedValue privateValue(GLOBAL_CX, JS::PrivateValue(keyfunc));
-        if (!JS_SetProperty(GLOBAL_CX, funObj, "_key_func_param", privateValue)) {  // JS::SetReservedSlot(functionObj, KeyFuncSlot, JS::PrivateValue(keyfunc)); does not work
-          PyErr_Format(PyExc_SystemError, "%s JSAPI call failed", JSArrayProxyType.tp_name);
-          return NULL;
-        }
-
-        JS::RootedValue reverseValue(GLOBAL_CX);
-        reverseValue.setBoolean(reverse);
-        if (!JS_SetProperty(GLOBAL_CX, funObj, "_reverse_param", reverseValue)) {
-          PyErr_Format(PyExc_SystemError, "%s JSAPI call failed", JSArrayProxyType.tp_name);
-          return NULL;
-        }
-
-        JS::Rooted<JS::ValueArray<1>> jArgs(GLOBAL_CX);
-        jArgs[0].setObject(*funObj);
-        if (!JS_CallFunctionName(GLOBAL_CX, *(self->jsArray), "sort", jArgs, &jReturnedArray)) {
-          if (!PyErr_Occurred()) {
-            PyErr_Format(PyExc_SystemError, "%s JSAPI call failed", JSArrayProxyType.tp_name);
-          }
-          return NULL;
-        }
+        return sort_with_key_func(self, keyfunc, reverse);
       }
       else {
         PyErr_Format(PyExc_TypeError, "'%.200s' object is not callable", Py_TYPE(keyfunc)->tp_name);
@@ -0,0 +1,458 @@
+/**
+ * @file JSMapProxy.cc
+ * @brief JSMapProxy is a custom C-implemented python type. It acts as a proxy for JS Maps from Spidermonkey, and behaves like a collections.abc.MutableMapping would.
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Distributive Corp.
+ *
+ */
+
+#include "include/JSMapProxy.hh"
+
+#include "include/JSObjectIterProxy.hh"
+#include "include/modules/pythonmonkey/pythonmonkey.hh"
+#include "include/jsTypeFactory.hh"
+#include "include/pyTypeFactory.hh"
+#include "include/setSpiderMonkeyException.hh"
+
+#include <jsapi.h>
+#include <js/MapAndSet.h>
+
+#include <Python.h>
+#include "include/pyshim.hh"
+
+
+// private
+/**
+ * @brief Convert a Python key to a JS value, the same way it would be passed to a JS function
+ *
+ * @return false with a Python exception set on error
+ */
+static bool keyToValue(JSContext *cx, PyObject *key, JS::MutableHandleValue keyValue) {
+  keyValue.set(jsTypeFactory(cx, key));
+  return !PyErr_Occurred();
+}
+
+// private
+/**
+ * @brief Look up `key` in the JS Map. `*found` is false, and `*value` NULL, if the key is absent
+ *
+ * @return false with a Python exception set on error
+ */
+static bool lookup(JSMapProxy *self, PyObject *key, PyObject **value, bool *found) {
+  JS::RootedObject map(GLOBAL_CX, *(self->jsMap));
+  JS::RootedValue keyValue(GLOBAL_CX);
+  if (!keyToValue(GLOBAL_CX, key, &keyValue)) {
+    return false;
+  }
+
+  JS::RootedValue jsValue(GLOBAL_CX);
+  if (!JS::MapGet(GLOBAL_CX, map, keyValue, &jsValue)) {
+    setSpiderMonkeyException(GLOBAL_CX);
+    return false;
+  }
+  *found = true;
+  if (jsValue.isUndefined() && !JS::MapHas(GLOBAL_CX, map, keyValue, found)) { // only an `undefined` value needs telling apart from a missing key
+    setSpiderMonkeyException(GLOBAL_CX);
+    return false;
+  }
+
+  *value = NULL;
+  if (*found) {
+    *value = pyTypeFactory(GLOBAL_CX, jsValue);
+    if (!*value) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// private
+/**
+ * @brief Remove `key` from the JS Map, `*found` tells whether it was present
+ *
+ * @return false with a Python exception set on error
+ */
+static bool deleteKey(JSMapProxy *self, PyObject *key, bool *found) {
+  JS::RootedObject map(GLOBAL_CX, *(self->jsMap));
+  JS::RootedValue keyValue(GLOBAL_CX);
+  if (!keyToValue(GLOBAL_CX, key, &keyValue)) {
+    return false;
+  }
+  if (!JS::MapDelete(GLOBAL_CX, map, keyValue, found)) {
+    setSpiderMonkeyException(GLOBAL_CX);
+    return false;
+  }
+  return true;
+}
+
+// private
+/**
+ * @brief An iterator over the JS Map's entries, as (key, value) tuples
+ */
+static PyObject *iterEntries(JSMapProxy *self) {
+  JS::RootedObject map(GLOBAL_CX, *(self->jsMap));
+  JS::RootedValue entries(GLOBAL_CX);
+  if (!JS::MapEntries(GLOBAL_CX, map, &entries)) {
+    setSpiderMonkeyException(GLOBAL_CX);
+    return NULL;
+  }
+  JS::RootedObject entriesObj(GLOBAL_CX, &entries.toObject());
+  return JSObjectIterProxyMethodDefinitions::JSObjectIterProxy_fromJSIterator(GLOBAL_CX, (PyObject *)self, entriesObj, KIND_JS_ENTRIES);
+}
+
+// private
+/**
+ * @brief Create a `collections.abc` view, such as KeysView, over the JSMapProxy
+ */
+static PyObject *newView(JSMapProxy *self, const char *viewName) {
+  PyObject *abcModule = PyImport_ImportModule("collections.abc");
+  if (!abcModule) {
+    return NULL;
+  }
+  PyObject *view = PyObject_CallMethod(abcModule, viewName, "O", self);
+  Py_DECREF(abcModule);
+  return view;
+}
+
+PyObject *JSMapProxyMethodDefinitions::JSMapProxy_create(JSContext *cx, JS::HandleObject map) {
+  JSMapProxy *self = (JSMapProxy *)JSMapProxyType.tp_alloc(&JSMapProxyType, 0);
+  if (!self) {
+    return NULL;
+  }
+  self->jsMap = new JS::PersistentRootedObject(cx, map);
+  return (PyObject *)self;
+}
+
+void JSMapProxyMethodDefinitions::JSMapProxy_dealloc(JSMapProxy *self) {
+  delete self->jsMap;
+  Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+Py_ssize_t JSMapProxyMethodDefinitions::JSMapProxy_length(JSMapProxy *self) {
+  JS::RootedObject map(GLOBAL_CX, *(self->jsMap));
+  return JS::MapSize(GLOBAL_CX, map);
+}
+
+PyObject *JSMapProxyMethodDefinitions::JSMapProxy_get(JSMapProxy *self, PyObject *key) {
+  PyObject *value;
+  bool found;
+  if (!lookup(self, key, &value, &found)) {
+    return NULL;
+  }
+  if (!found) {
+    PyErr_SetObject(PyExc_KeyError, key);
+  }
+  return value;
+}
+
+int JSMapProxyMethodDefinitions::JSMapProxy_assign(JSMapProxy *self, PyObject *key, PyObject *value) {
+  if (!value) { // delete
+    bool found;
+    if (!deleteKey(self, key, &found)) {
+      return -1;
+    }
+    if (!found) {
+      PyErr_SetObject(PyExc_KeyError, key);
+      return -1;
+    }
+    return 0;
+  }
+
+  JS::RootedObject map(GLOBAL_CX, *(self->jsMap));
+  JS::RootedValue keyValue(GLOBAL_CX);
+  if (!keyToValue(GLOBAL_CX, key, &keyValue)) {
+    return -1;
+  }
+  JS::RootedValue jsValue(GLOBAL_CX, jsTypeFactory(GLOBAL_CX, value));
+  if (PyErr_Occurred()) {
+    return -1;
+  }
+  if (!JS::MapSet(GLOBAL_CX, map, keyValue, jsValue)) {
+    setSpiderMonkeyException(GLOBAL_CX);
+    return -1;
+  }
+  return 0;
+}
+
+int JSMapProxyMethodDefinitions::JSMapProxy_contains(JSMapProxy *self, PyObject *key) {
+  JS::RootedObject map(GLOBAL_CX, *(self->jsMap));
+  JS::RootedValue keyValue(GLOBAL_CX);
+  if (!keyToValue(GLOBAL_CX, key, &keyValue)) {
+    return -1;
+  }
+  bool found;
+  if (!JS::MapHas(GLOBAL_CX, map, keyValue, &found)) {
+    setSpiderMonkeyException(GLOBAL_CX);
+    return -1;
+  }
+  return found;
+}
+
+PyObject *JSMapProxyMethodDefinitions::JSMapProxy_iter(JSMapProxy *self) {
+  JS::RootedObject map(GLOBAL_CX, *(self->jsMap));
+  JS::RootedValue keys(GLOBAL_CX);
+  if (!JS::MapKeys(GLOBAL_CX, map, &keys)) {
+    setSpiderMonkeyException(GLOBAL_CX);
+    return NULL;
+  }
+  JS::RootedObject keysObj(GLOBAL_CX, &keys.toObject());
+  return JSObjectIterProxyMethodDefinitions::JSObjectIterProxy_fromJSIterator(GLOBAL_CX, (PyObject *)self, keysObj, KIND_JS_ITERATOR);
+}
+
+PyObject *JSMapProxyMethodDefinitions::JSMapProxy_repr(JSMapProxy *self) {
+  // Like `collections.Counter`: JSMapProxy({key: value, ...}), keys may be unhashable JS objects so no dict is built
+  int status = Py_ReprEnter((PyObject *)self);
+  if (status != 0) {
+    return status > 0 ? PyUnicode_FromString("JSMapProxy({...})") : NULL;
+  }
+
+  PyObject *parts = PyList_New(0);
+  PyObject *entries = parts ? iterEntries(self) : NULL;
+  PyObject *result = NULL;
+  if (entries) {
+    PyObject *entry;
+    while ((entry = PyIter_Next(entries))) {
+      PyObject *part = PyUnicode_FromFormat("%R: %R", PyTuple_GET_ITEM(entry, 0), PyTuple_GET_ITEM(entry, 1));
+      Py_DECREF(entry);
+      if (!part || PyList_Append(parts, part) < 0) {
+        Py_XDECREF(part);
+        break;
+      }
+      Py_DECREF(part);
+    }
+    Py_DECREF(entries);
+  }
+
+  if (parts && !PyErr_Occurred()) {
+    PyObject *separator = PyUnicode_FromString(", ");
+    PyObject *joined = separator ? PyUnicode_Join(separator, parts) : NULL;
+    if (joined) {
+      result = PyUnicode_FromFormat("JSMapProxy({%U})", joined);
+      Py_DECREF(joined);
+    }
+    Py_XDECREF(separator);
+  }
+  Py_XDECREF(parts);
+  Py_ReprLeave((PyObject *)self);
+  return result;
+}
+
+PyObject *JSMapProxyMethodDefinitions::JSMapProxy_richcompare(JSMapProxy *self, PyObject *other, int op) {
+  if ((op != Py_EQ && op != Py_NE) || !(PyDict_Check(other) || PyObject_TypeCheck(other, &JSMapProxyType))) {
+    Py_RETURN_NOTIMPLEMENTED;
+  }
+
+  Py_ssize_t otherLength = PyObject_Length(other);
+  if (otherLength < 0) {
+    return NULL;
+  }
+  bool isEqual = JSMapProxy_length(self) == otherLength;
+
+  if (isEqual) {
+    PyObject *entries = iterEntries(self);
+    if (!entries) {
+      return NULL;
+    }
+    PyObject *entry;
+    while (isEqual && (entry = PyIter_Next(entries))) {
+      PyObject *otherValue = PyObject_GetItem(other, PyTuple_GET_ITEM(entry, 0));
+      if (!otherValue) {
+        if (!PyErr_ExceptionMatches(PyExc_KeyError) && !PyErr_ExceptionMatches(PyExc_TypeError)) { // an unhashable key can't be in a dict
+          Py_DECREF(entry);
+          Py_DECREF(entries);
+          return NULL;
+        }
+        PyErr_Clear();
+        isEqual = false;
+      }
+      else {
+        int cmp = PyObject_RichCompareBool(PyTuple_GET_ITEM(entry, 1), otherValue, Py_EQ);
+        Py_DECREF(otherValue);
+        if (cmp < 0) {
+          Py_DECREF(entry);
+          Py_DECREF(entries);
+          return NULL;
+        }
+        isEqual = cmp;
+      }
+      Py_DECREF(entry);
+    }
+    Py_DECREF(entries);
+    if (PyErr_Occurred()) {
+      return NULL;
+    }
+  }
+
+  if (isEqual == (op == Py_EQ)) {
+    Py_RETURN_TRUE;
+  }
+  Py_RETURN_FALSE;
+}
+
+PyObject *JSMapProxyMethodDefinitions::JSMapProxy_keys(JSMapProxy *self, PyObject *Py_UNUSED(ignored)) {
+  return newView(self, "KeysView");
+}
+
+PyObject *JSMapProxyMethodDefinitions::JSMapProxy_values(JSMapProxy *self, PyObject *Py_UNUSED(ignored)) {
+  return newView(self, "ValuesView");
+}
+
+PyObject *JSMapProxyMethodDefinitions::JSMapProxy_items(JSMapProxy *self, PyObject *Py_UNUSED(ignored)) {
+  return newView(self, "ItemsView");
+}
+
+PyObject *JSMapProxyMethodDefinitions::JSMapProxy_get_method(JSMapProxy *self, PyObject *const *args, Py_ssize_t nargs) {
+  if (!_PyArg_CheckPositional("get", nargs, 1, 2)) {
+    return NULL;
+  }
+  PyObject *defaultValue = nargs < 2 ? Py_None : args[1];
+
+  PyObject *value;
+  bool found;
+  if (!lookup(self, args[0], &value, &found)) {
+    return NULL;
+  }
+  if (!found) {
+    Py_INCREF(defaultValue);
+    value = defaultValue;
+  }
+  return value;
+}
+
+PyObject *JSMapProxyMethodDefinitions::JSMapProxy_pop_method(JSMapProxy *self, PyObject *const *args, Py_ssize_t nargs) {
+  if (!_PyArg_CheckPositional("pop", nargs, 1, 2)) {
+    return NULL;
+  }
+
+  PyObject *value;
+  bool found;
+  if (!lookup(self, args[0], &value, &found)) {
+    return NULL;
+  }
+  if (!found) {
+    if (nargs < 2) {
+      PyErr_SetObject(PyExc_KeyError, args[0]);
+      return NULL;
+    }
+    Py_INCREF(args[1]);
+    return args[1];
+  }
+
+  if (!deleteKey(self, args[0], &found)) {
+    Py_DECREF(value);
+    return NULL;
+  }
+  return value;
+}
+
+PyObject *JSMapProxyMethodDefinitions::JSMapProxy_popitem_method(JSMapProxy *self, PyObject *Py_UNUSED(ignored)) {
+  PyObject *entries = iterEntries(self);
+  if (!entries) {
+    return NULL;
+  }
+  PyObject *entry = PyIter_Next(entries);
+  Py_DECREF(entries);
+  if (!entry) {
+    if (!PyErr_Occurred()) {
+      PyErr_SetString(PyExc_KeyError, "popitem(): Map is empty");
+    }
+    return NULL;
+  }
+
+  bool found;
+  if (!deleteKey(self, PyTuple_GET_ITEM(entry, 0), &found)) {
+    Py_DECREF(entry);
+    return NULL;
+  }
+  return entry;
+}
+
+PyObject *JSMapProxyMethodDefinitions::JSMapProxy_setdefault_method(JSMapProxy *self, PyObject *const *args, Py_ssize_t nargs) {
+  if (!_PyArg_CheckPositional("setdefault", nargs, 1, 2)) {
+    return NULL;
+  }
+  PyObject *defaultValue = nargs < 2 ? Py_None : args[1];
+
+  PyObject *value;
+  bool found;
+  if (!lookup(self, args[0], &value, &found)) {
+    return NULL;
+  }
+  if (found) {
+    return value;
+  }
+
+  if (JSMapProxy_assign(self, args[0], defaultValue) < 0) {
+    return NULL;
+  }
+  Py_INCREF(defaultValue);
+  return defaultValue;
+}
+
+PyObject *JSMapProxyMethodDefinitions::JSMapProxy_update_method(JSMapProxy *self, PyObject *args, PyObject *kwargs) {
+  PyObject *arg = NULL;
+  if (!PyArg_UnpackTuple(args, "update", 0, 1, &arg)) {
+    return NULL;
+  }
+
+  if (arg != NULL) {
+    // a mapping has `keys()`, otherwise an iterable of key/value pairs
+    PyObject *pairs = PyObject_HasAttrString(arg, "keys") ? PyMapping_Items(arg) : PyObject_GetIter(arg);
+    if (!pairs) {
+      return NULL;
+    }
+    PyObject *iterator = PyObject_GetIter(pairs);
+    Py_DECREF(pairs);
+    if (!iterator) {
+      return NULL;
+    }
+
+    PyObject *pair;
+    while ((pair = PyIter_Next(iterator))) {
+      PyObject *key, *value;
+      PyObject *fast = PySequence_Fast(pair, "update(): cannot convert sequence element to a key/value pair");
+      Py_DECREF(pair);
+      if (!fast) {
+        break;
+      }
+      if (PySequence_Fast_GET_SIZE(fast) != 2) {
+        PyErr_Format(PyExc_ValueError, "update(): sequence element has length %zd; 2 is required", PySequence_Fast_GET_SIZE(fast));
+        Py_DECREF(fast);
+        break;
+      }
+      key = PySequence_Fast_GET_ITEM(fast, 0);
+      value = PySequence_Fast_GET_ITEM(fast, 1);
+      int result = JSMapProxy_assign(self, key, value);
+      Py_DECREF(fast);
+      if (result < 0) {
+        break;
+      }
+    }
+    Py_DECREF(iterator);
+    if (PyErr_Occurred()) {
+      return NULL;
+    }
+  }
+
+  if (kwargs != NULL) {
+    PyObject *key, *value;
+    Py_ssize_t pos = 0;
+    while (PyDict_Next(kwargs, &pos, &key, &value)) {
+      if (JSMapProxy_assign(self, key, value) < 0) {
+        return NULL;
+      }
+    }
+  }
+
+  Py_RETURN_NONE;
+}
+
+PyObject *JSMapProxyMethodDefinitions::JSMapProxy_clear_method(JSMapProxy *self, PyObject *Py_UNUSED(ignored)) {
+  JS::RootedObject map(GLOBAL_CX, *(self->jsMap));
+  if (!JS::MapClear(GLOBAL_CX, map)) {
+    setSpiderMonkeyException(GLOBAL_CX);
+    return NULL;
+  }
+  Py_RETURN_NONE;
+}
@@ -18,6 +18,7 @@
 #include "include/pyTypeFactory.hh"
 
 #include "include/PyDictProxyHandler.hh"
+#include "include/setSpiderMonkeyException.hh"
 
 #include <jsapi.h>
 
@@ -26,9 +27,76 @@
 #include <Python.h>
 
 
+// private
+/**
+ * @brief Read `done` and `value` off an iterator result `{ value, done }`
+ *
+ * @return false with a Python exception set on error
+ */
+static bool unpackIteratorResult(JSContext *cx, JS::HandleValue result, JS::MutableHandleValue value, bool *done) {
+  if (!result.isObject()) {
+    PyErr_SetString(PyExc_TypeError, "iterator result is not an object");
+    return false;
+  }
+
+  JS::RootedObject resultObj(cx, &result.toObject());
+  JS::RootedValue doneValue(cx);
+  if (!JS_GetProperty(cx, resultObj, "done", &doneValue)) {
+    setSpiderMonkeyException(cx);
+    return false;
+  }
+  *done = JS::ToBoolean(doneValue);
+  if (*done) {
+    return true;
+  }
+
+  if (!JS_GetProperty(cx, resultObj, "value", value)) {
+    setSpiderMonkeyException(cx);
+    return false;
+  }
+  return true;
+}
+
+// private
+/**
+ * @brief Convert a `[key, value]` entry, as yielded by `Map.prototype.entries`, to a (key, value) tuple
+ */
+static PyObject *entryToTuple(JSContext *cx, JS::HandleValue entry) {
+  if (!entry.isObject()) {
+    PyErr_SetString(PyExc_TypeError, "iterator entry is not an object");
+    return NULL;
+  }
+
+  JS::RootedObject entryObj(cx, &entry.toObject());
+  JS::RootedValue key(cx);
+  JS::RootedValue value(cx);
+  if (!JS_GetElement(cx, entryObj, 0, &key) || !JS_GetElement(cx, entryObj, 1, &value)) {
+    setSpiderMonkeyException(cx);
+    return NULL;
+  }
+
+  PyObject *pyKey = pyTypeFactory(cx, key);
+  if (!pyKey) {
+    return NULL;
+  }
+  PyObject *pyValue = pyTypeFactory(cx, value);
+  if (!pyValue) {
+    Py_DECREF(pyKey);
+    return NULL;
+  }
+  PyObject *tuple = PyTuple_Pack(2, pyKey, pyValue);
+  Py_DECREF(pyKey);
+  Py_DECREF(pyValue);
+  return tuple;
+}
+
 void JSObjectIterProxyMethodDefinitions::JSObjectIterProxy_dealloc(JSObjectIterProxy *self)
 {
   delete self->it.props;
+  if (self->it.kind == KIND_JS_ITERATOR || self->it.kind == KIND_JS_ENTRIES) {
+    delete self->it.jsIterator;
+    delete self->it.nextMethod;
+  }
   PyObject_GC_UnTrack(self);
   Py_XDECREF(self->it.di_dict);
   PyObject_GC_Del(self);
@@ -55,7 +123,32 @@ PyObject *JSObjectIterProxyMethodDefinitions::JSObjectIterProxy_nextkey(JSObject
     return NULL;
   }
 
-  if (self->it.reversed) {
+  if (self->it.kind == KIND_JS_ITERATOR || self->it.kind == KIND_JS_ENTRIES) {
+    // Like `JS::ForOfIterator::next`: call the `next` method, no Python object is created except for the value
+    JS::RootedValue iterator(GLOBAL_CX, JS::ObjectValue(**(self->it.jsIterator)));
+    JS::RootedValue result(GLOBAL_CX);
+    if (!JS::Call(GLOBAL_CX, iterator, *(self->it.nextMethod), JS::HandleValueArray::empty(), &result)) {
+      setSpiderMonkeyException(GLOBAL_CX);
+      return NULL;
+    }
+    if (self->it.kind == KIND_JS_ITERATOR) {
+      PyObject *value = iteratorResultValue(GLOBAL_CX, result);
+      if (value || PyErr_Occurred()) {
+        return value;
+      }
+    }
+    else {
+      JS::RootedValue entry(GLOBAL_CX);
+      bool done;
+      if (!unpackIteratorResult(GLOBAL_CX, result, &entry, &done)) {
+        return NULL;
+      }
+      if (!done) {
+        return entryToTuple(GLOBAL_CX, entry);
+      }
+    }
+  }
+  else if (self->it.reversed) {
     if (self->it.it_index >= 0) {
       JS::HandleId id = (*(self->it.props))[(self->it.it_index)--];
       PyObject *key = idToKey(GLOBAL_CX, id);
@@ -124,11 +217,44 @@ PyObject *JSObjectIterProxyMethodDefinitions::JSObjectIterProxy_nextkey(JSObject
 
 PyObject *JSObjectIterProxyMethodDefinitions::JSObjectIterProxy_len(JSObjectIterProxy *self) {
   Py_ssize_t len;
-  if (self->it.di_dict) {
+  if (self->it.di_dict && self->it.kind != KIND_JS_ITERATOR && self->it.kind != KIND_JS_ENTRIES) { // the length of a JS iterator is unknown
     len = JSObjectProxyMethodDefinitions::JSObjectProxy_length((JSObjectProxy *)self->it.di_dict) - self->it.it_index;
     if (len >= 0) {
       return PyLong_FromSsize_t(len);
     }
   }
   return PyLong_FromLong(0);
-}
\ No newline at end of file
+}
+
+PyObject *JSObjectIterProxyMethodDefinitions::iteratorResultValue(JSContext *cx, JS::HandleValue result) {
+  JS::RootedValue value(cx);
+  bool done;
+  if (!unpackIteratorResult(cx, result, &value, &done) || done) {
+    return NULL;
+  }
+  return pyTypeFactory(cx, value);
+}
+
+PyObject *JSObjectIterProxyMethodDefinitions::JSObjectIterProxy_fromJSIterator(JSContext *cx, PyObject *owner, JS::HandleObject jsIterator, int kind) {
+  JSObjectIterProxy *iterator = PyObject_GC_New(JSObjectIterProxy, &JSObjectIterProxyType);
+  if (iterator == NULL) {
+    return NULL;
+  }
+  iterator->it.it_index = 0;
+  iterator->it.reversed = false;
+  iterator->it.kind = kind;
+  iterator->it.props = nullptr;
+  Py_INCREF(owner);
+  iterator->it.di_dict = (PyDictObject *)owner;
+  iterator->it.jsIterator = new JS::PersistentRootedObject(cx, jsIterator);
+  iterator->it.nextMethod = new JS::PersistentRootedValue(cx);
+  PyObject_GC_Track(iterator);
+
+  // as in `JS::ForOfIterator::init`, the `next` method is looked up only once
+  if (!JS_GetProperty(cx, jsIterator, "next", iterator->it.nextMethod)) {
+    setSpiderMonkeyException(cx);
+    Py_DECREF(iterator);
+    return NULL;
+  }
+  return (PyObject *)iterator;
+}
@@ -22,9 +22,14 @@
 #include "include/PyBaseProxyHandler.hh"
 
 #include "include/JSFunctionProxy.hh"
+#include "include/DictType.hh"
+#include "include/PromiseType.hh"
+#include "include/setSpiderMonkeyException.hh"
 
 #include <jsapi.h>
 #include <jsfriendapi.h>
+#include <js/Promise.h>
+#include <js/Symbol.h>
 
 #include <Python.h>
 #include "include/pyshim.hh"
@@ -265,13 +270,13 @@ bool JSObjectProxyMethodDefinitions::JSObjectProxy_richcompare_helper(JSObjectPr
     if (!pyVal2) { // if other.key is NULL then not equal
       return false;
     }
-    if (pyVal1 && Py_TYPE(pyVal1) == &JSObjectProxyType) { // if either subvalue is a JSObjectProxy, we need to pass around our visited map
+    if (pyVal1 && PyObject_TypeCheck(pyVal1, &JSObjectProxyType)) { // if either subvalue is a JSObjectProxy, we need to pass around our visited map
       if (!JSObjectProxy_richcompare_helper((JSObjectProxy *)pyVal1, pyVal2, visited))
       {
         return false;
       }
     }
-    else if (pyVal2 && Py_TYPE(pyVal2) == &JSObjectProxyType) {
+    else if (pyVal2 && PyObject_TypeCheck(pyVal2, &JSObjectProxyType)) {
       if (!JSObjectProxy_richcompare_helper((JSObjectProxy *)pyVal2, pyVal1, visited))
       {
         return false;
@@ -286,16 +291,43 @@ bool JSObjectProxyMethodDefinitions::JSObjectProxy_richcompare_helper(JSObjectPr
 }
 
 PyObject *JSObjectProxyMethodDefinitions::JSObjectProxy_iter(JSObjectProxy *self) {
-  // key iteration
+  // JS iterables (Map, Set, generators, ...) iterate over their values as in `for...of`, other objects over their keys like a dict
+  JS::RootedObject obj(GLOBAL_CX, *(self->jsObject));
+  JS::RootedSymbol iteratorSymbol(GLOBAL_CX, JS::GetWellKnownSymbol(GLOBAL_CX, JS::SymbolCode::iterator));
+  JS::RootedId iteratorId(GLOBAL_CX, JS::PropertyKey::Symbol(iteratorSymbol));
+  JS::RootedValue iteratorFn(GLOBAL_CX);
+  if (!JS_GetPropertyById(GLOBAL_CX, obj, iteratorId, &iteratorFn)) {
+    setSpiderMonkeyException(GLOBAL_CX);
+    return NULL;
+  }
+  bool isIterable = iteratorFn.isObject() && JS::IsCallable(&iteratorFn.toObject());
+
+  if (isIterable) {
+    // GetIterator, as in `JS::ForOfIterator::init`
+    JS::RootedValue jsIterator(GLOBAL_CX);
+    if (!JS_CallFunctionValue(GLOBAL_CX, obj, iteratorFn, JS::HandleValueArray::empty(), &jsIterator)) {
+      setSpiderMonkeyException(GLOBAL_CX);
+      return NULL;
+    }
+    if (!jsIterator.isObject()) {
+      PyErr_SetString(PyExc_TypeError, "[Symbol.iterator]() did not return an object");
+      return NULL;
+    }
+    JS::RootedObject jsIteratorObj(GLOBAL_CX, &jsIterator.toObject());
+    return JSObjectIterProxyMethodDefinitions::JSObjectIterProxy_fromJSIterator(GLOBAL_CX, (PyObject *)self, jsIteratorObj, KIND_JS_ITERATOR);
+  }
+
   JSObjectIterProxy *iterator = PyObject_GC_New(JSObjectIterProxy, &JSObjectIterProxyType);
   if (iterator == NULL) {
     return NULL;
   }
   iterator->it.it_index = 0;
   iterator->it.reversed = false;
-  iterator->it.kind = KIND_KEYS;
   Py_INCREF(self);
   iterator->it.di_dict = (PyDictObject *)self;
+
+  // key iteration
+  iterator->it.kind = KIND_KEYS;
   iterator->it.props = new JS::PersistentRootedIdVector(GLOBAL_CX);
   // Get **enumerable** own properties
   if (!js::GetPropertyKeys(GLOBAL_CX, *(self->jsObject), JSITER_OWNONLY, iterator->it.props)) {
@@ -306,40 +338,58 @@ PyObject *JSObjectProxyMethodDefinitions::JSObjectProxy_iter(JSObjectProxy *self
 }
 
 PyObject *JSObjectProxyMethodDefinitions::JSObjectProxy_iter_next(JSObjectProxy *self) {
-  PyObject *key = PyUnicode_FromString("next");
-  JS::RootedId id(GLOBAL_CX);
-  if (!keyToId(key, &id)) {
-    PyErr_SetString(PyExc_SystemError, "JSObjectProxy failed type conversion");
+  // `next()` on a JS iterator
+  JS::RootedObject iterator(GLOBAL_CX, *(self->jsObject));
+  JS::RootedValue result(GLOBAL_CX);
+  if (!JS_CallFunctionName(GLOBAL_CX, iterator, "next", JS::HandleValueArray::empty(), &result)) {
+    setSpiderMonkeyException(GLOBAL_CX);
     return NULL;
   }
+  return JSObjectIterProxyMethodDefinitions::iteratorResultValue(GLOBAL_CX, result); // NULL without an exception set means StopIteration
+}
 
-  PyObject *nextFunction = getKey(self, key, id, false);
-  Py_DECREF(key);
-  if (nextFunction == NULL) {
-    PyErr_SetString(PyExc_SystemError, "JSObjectProxy could not retrieve key");
+PyObject *JSObjectProxyMethodDefinitions::JSObjectProxy_aiter(JSObjectProxy *self) {
+  JS::RootedObject obj(GLOBAL_CX, *(self->jsObject));
+  JS::RootedSymbol asyncIteratorSymbol(GLOBAL_CX, JS::GetWellKnownSymbol(GLOBAL_CX, JS::SymbolCode::asyncIterator));
+  JS::RootedId asyncIteratorId(GLOBAL_CX, JS::PropertyKey::Symbol(asyncIteratorSymbol));
+  JS::RootedValue asyncIteratorFn(GLOBAL_CX);
+  if (!JS_GetPropertyById(GLOBAL_CX, obj, asyncIteratorId, &asyncIteratorFn)) {
+    setSpiderMonkeyException(GLOBAL_CX);
     return NULL;
   }
-
-  PyObject *retVal = JSFunctionProxyMethodDefinitions::JSFunctionProxy_call(nextFunction, PyTuple_New(0), NULL);
-  Py_DECREF(nextFunction);
-  if (retVal == NULL) {
+  if (!asyncIteratorFn.isObject() || !JS::IsCallable(&asyncIteratorFn.toObject())) {
+    PyErr_SetString(PyExc_TypeError, "JSObjectProxy is not async iterable, it has no [Symbol.asyncIterator] method");
     return NULL;
   }
 
-  // check if end of iteration
-  key = PyUnicode_FromString("done");
-  PyObject *done = JSObjectProxy_get((JSObjectProxy *)retVal, key);
-  Py_DECREF(key);
-  if (done == Py_True) {
-    PyErr_SetNone(PyExc_StopIteration);
+  JS::RootedValue asyncIterator(GLOBAL_CX);
+  if (!JS_CallFunctionValue(GLOBAL_CX, obj, asyncIteratorFn, JS::HandleValueArray::empty(), &asyncIterator)) {
+    setSpiderMonkeyException(GLOBAL_CX);
+    return NULL;
+  }
+  if (!asyncIterator.isObject()) {
+    PyErr_SetString(PyExc_TypeError, "[Symbol.asyncIterator]() did not return an object");
     return NULL;
   }
+  // always the async iterable subtype, for its `__anext__`, even if the iterator has no `[Symbol.asyncIterator]` itself
+  return DictType::getPyObject(GLOBAL_CX, asyncIterator, &JSObjectAsyncIterableProxyType);
+}
 
-  key = PyUnicode_FromString("value");
-  PyObject *value = JSObjectProxy_get((JSObjectProxy *)retVal, key);
-  Py_DECREF(key);
+PyObject *JSObjectProxyMethodDefinitions::JSObjectProxy_anext(JSObjectProxy *self) {
+  JS::RootedObject asyncIterator(GLOBAL_CX, *(self->jsObject));
+  JS::RootedValue result(GLOBAL_CX);
+  if (!JS_CallFunctionName(GLOBAL_CX, asyncIterator, "next", JS::HandleValueArray::empty(), &result)) {
+    setSpiderMonkeyException(GLOBAL_CX);
+    return NULL;
+  }
 
-  return value;
+  // `next()` of a hand-written async iterator may return the iterator result itself rather than a Promise
+  JS::RootedObject promise(GLOBAL_CX, JS::CallOriginalPromiseResolve(GLOBAL_CX, result));
+  if (!promise) {
+    setSpiderMonkeyException(GLOBAL_CX);
+    return NULL;
+  }
+  return PromiseType::getIteratorResultPyObject(GLOBAL_CX, promise);
 }
 
 PyObject *JSObjectProxyMethodDefinitions::JSObjectProxy_repr(JSObjectProxy *self) {
@@ -0,0 +1,413 @@
+/**
+ * @file JSPromiseProxy.cc
+ * @brief JSPromiseProxy is a custom C-implemented python type. It acts as a proxy for JS Promises from Spidermonkey, and can be awaited like an asyncio.Future.
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Distributive Corp.
+ *
+ */
+
+#include "include/JSPromiseProxy.hh"
+#include "include/PyEventLoop.hh"
+#include "include/JobQueue.hh"
+
+#include <jsapi.h>
+
+#include <Python.h>
+#include "include/pyshim.hh"
+
+// private
+/**
+ * @brief Get an exception class from the asyncio module, `CancelledError` or `InvalidStateError`
+ * @return borrowed reference, or NULL with the Python error indicator set
+ */
+static PyObject *getAsyncioError(const char *name, PyObject **cache) {
+  if (!*cache) {
+    PyObject *asyncio = PyImport_ImportModule("asyncio");
+    if (!asyncio) {
+      return NULL;
+    }
+    *cache = PyObject_GetAttrString(asyncio, name);
+    Py_DECREF(asyncio);
+  }
+  return *cache;
+}
+
+// private
+static void setCancelledError(JSPromiseProxy *self) {
+  static PyObject *cancelledError = nullptr;
+  PyObject *errorType = getAsyncioError("CancelledError", &cancelledError);
+  if (!errorType) {
+    return;
+  }
+  if (self->cancelMessage) {
+    PyErr_SetObject(errorType, self->cancelMessage);
+  } else {
+    PyErr_SetNone(errorType);
+  }
+}
+
+// private
+static void setInvalidStateError(const char *message) {
+  static PyObject *invalidStateError = nullptr;
+  PyObject *errorType = getAsyncioError("InvalidStateError", &invalidStateError);
+  if (!errorType) {
+    return;
+  }
+  PyErr_SetString(errorType, message);
+}
+
+// private
+/**
+ * @brief Bind a JSPromiseProxy created without a running event-loop to the running one
+ *
+ * @return false with a RuntimeError set if no event-loop is running
+ */
+static bool bindLoop(JSPromiseProxy *self) {
+  if (self->loop != Py_None) {
+    return true;
+  }
+  PyEventLoop loop = PyEventLoop::getRunningLoop();
+  if (!loop.initialized()) {
+    return false;
+  }
+  Py_INCREF(loop._loop);
+  Py_SETREF(self->loop, loop._loop);
+  // the jobs that settle this promise may have been enqueued while no event-loop was running
+  return JobQueue::scheduleDrainIfPending();
+}
+
+// private
+/**
+ * @brief Schedule `callback(self)` on the event-loop, in the given `contextvars.Context`
+ */
+static bool callSoon(JSPromiseProxy *self, PyObject *callback, PyObject *context) {
+  if (!bindLoop(self)) {
+    return false;
+  }
+  // https://docs.python.org/3/library/asyncio-eventloop.html#asyncio.loop.call_soon
+  PyObject *callSoonFn = PyObject_GetAttrString(self->loop, "call_soon");
+  if (!callSoonFn) {
+    return false;
+  }
+  PyObject *args = PyTuple_Pack(2, callback, (PyObject *)self);
+  PyObject *kwargs = Py_BuildValue("{s:O}", "context", context);
+  PyObject *handle = args && kwargs ? PyObject_Call(callSoonFn, args, kwargs) : NULL;
+  Py_XDECREF(handle);
+  Py_XDECREF(kwargs);
+  Py_XDECREF(args);
+  Py_DECREF(callSoonFn);
+  return handle != NULL;
+}
+
+// private
+/**
+ * @brief Schedule all done callbacks once the JSPromiseProxy is done, clearing the callback list
+ */
+static bool scheduleCallbacks(JSPromiseProxy *self) {
+  PyObject *callback0 = self->callback0;
+  PyObject *context0 = self->context0;
+  PyObject *callbacks = self->callbacks;
+  self->callback0 = NULL;
+  self->context0 = NULL;
+  self->callbacks = NULL;
+
+  bool success = true;
+  if (callback0) {
+    success = callSoon(self, callback0, context0);
+  }
+  if (callbacks) {
+    Py_ssize_t length = PyList_GET_SIZE(callbacks);
+    for (Py_ssize_t index = 0; success && index < length; index++) {
+      PyObject *pair = PyList_GET_ITEM(callbacks, index);
+      success = callSoon(self, PyTuple_GET_ITEM(pair, 0), PyTuple_GET_ITEM(pair, 1));
+    }
+  }
+
+  Py_XDECREF(callback0);
+  Py_XDECREF(context0);
+  Py_XDECREF(callbacks);
+  return success;
+}
+
+PyObject *JSPromiseProxyMethodDefinitions::JSPromiseProxy_create(JSContext *cx, JS::HandleObject promise, PyObject *loop) {
+  JSPromiseProxy *self = (JSPromiseProxy *)JSPromiseProxyType.tp_alloc(&JSPromiseProxyType, 0);
+  if (!self) {
+    return NULL;
+  }
+  self->promise = new JS::PersistentRootedObject(cx, promise);
+  Py_INCREF(loop);
+  self->loop = loop;
+  self->state = JSPromiseProxyState::PENDING;
+  return (PyObject *)self;
+}
+
+bool JSPromiseProxyMethodDefinitions::JSPromiseProxy_settle(JSPromiseProxy *self, PyObject *value, bool rejected) {
+  if (self->state != JSPromiseProxyState::PENDING) {
+    return true; // cancelled in the meantime, the outcome is dropped like `asyncio.Future.set_result` would refuse it
+  }
+
+  Py_INCREF(value);
+  if (rejected) {
+    self->exception = value;
+  } else {
+    self->result = value;
+  }
+  self->state = JSPromiseProxyState::FINISHED;
+  return scheduleCallbacks(self);
+}
+
+void JSPromiseProxyMethodDefinitions::JSPromiseProxy_dealloc(JSPromiseProxy *self)
+{
+  PyObject_GC_UnTrack(self);
+  JSPromiseProxy_clear(self);
+  delete self->promise;
+  PyObject_GC_Del(self);
+}
+
+int JSPromiseProxyMethodDefinitions::JSPromiseProxy_traverse(JSPromiseProxy *self, visitproc visit, void *arg) {
+  Py_VISIT(self->loop);
+  Py_VISIT(self->result);
+  Py_VISIT(self->exception);
+  Py_VISIT(self->cancelMessage);
+  Py_VISIT(self->callback0);
+  Py_VISIT(self->context0);
+  Py_VISIT(self->callbacks);
+  return 0;
+}
+
+int JSPromiseProxyMethodDefinitions::JSPromiseProxy_clear(JSPromiseProxy *self) {
+  Py_CLEAR(self->loop);
+  Py_CLEAR(self->result);
+  Py_CLEAR(self->exception);
+  Py_CLEAR(self->cancelMessage);
+  Py_CLEAR(self->callback0);
+  Py_CLEAR(self->context0);
+  Py_CLEAR(self->callbacks);
+  return 0;
+}
+
+PyObject *JSPromiseProxyMethodDefinitions::JSPromiseProxy_repr(JSPromiseProxy *self) {
+  switch (self->state) {
+  case JSPromiseProxyState::PENDING:
+    return PyUnicode_FromString("<JSPromiseProxy pending>");
+  case JSPromiseProxyState::CANCELLED:
+    return PyUnicode_FromString("<JSPromiseProxy cancelled>");
+  default:
+    if (self->exception) {
+      return PyUnicode_FromFormat("<JSPromiseProxy finished exception=%R>", self->exception);
+    }
+    return PyUnicode_FromFormat("<JSPromiseProxy finished result=%R>", self->result);
+  }
+}
+
+PyObject *JSPromiseProxyMethodDefinitions::JSPromiseProxy_await(JSPromiseProxy *self) {
+  Py_INCREF(self);
+  return (PyObject *)self;
+}
+
+PyObject *JSPromiseProxyMethodDefinitions::JSPromiseProxy_iternext(JSPromiseProxy *self) {
+  // Same as `asyncio.Future.__await__`: hand ourselves to the asyncio task, which resumes the coroutine from a done callback
+  if (self->state == JSPromiseProxyState::PENDING) {
+    self->blocking = true;
+    Py_INCREF(self);
+    return (PyObject *)self;
+  }
+
+  PyObject *result = JSPromiseProxy_result(self, NULL);
+  if (!result) {
+    return NULL; // raise the rejection reason into the coroutine
+  }
+  if (result == Py_None) {
+    Py_DECREF(result);
+    return NULL; // exhausted iterator, the `await` expression evaluates to None
+  }
+
+  // The value must be wrapped in a StopIteration instance, as a tuple or an exception object would be taken for its args
+  PyObject *stopIteration = PyObject_CallOneArg(PyExc_StopIteration, result);
+  Py_DECREF(result);
+  if (stopIteration) {
+    PyErr_SetObject(PyExc_StopIteration, stopIteration);
+    Py_DECREF(stopIteration);
+  }
+  return NULL;
+}
+
+PyObject *JSPromiseProxyMethodDefinitions::JSPromiseProxy_get_blocking(JSPromiseProxy *self, void *Py_UNUSED(closure)) {
+  return PyBool_FromLong(self->blocking);
+}
+
+int JSPromiseProxyMethodDefinitions::JSPromiseProxy_set_blocking(JSPromiseProxy *self, PyObject *value, void *Py_UNUSED(closure)) {
+  if (value == NULL) {
+    PyErr_SetString(PyExc_AttributeError, "cannot delete attribute");
+    return -1;
+  }
+  int isTrue = PyObject_IsTrue(value);
+  if (isTrue < 0) {
+    return -1;
+  }
+  self->blocking = isTrue;
+  return 0;
+}
+
+PyObject *JSPromiseProxyMethodDefinitions::JSPromiseProxy_get_loop(JSPromiseProxy *self, PyObject *Py_UNUSED(ignored)) {
+  if (!bindLoop(self)) {
+    return NULL;
+  }
+  Py_INCREF(self->loop);
+  return self->loop;
+}
+
+PyObject *JSPromiseProxyMethodDefinitions::JSPromiseProxy_done(JSPromiseProxy *self, PyObject *Py_UNUSED(ignored)) {
+  return PyBool_FromLong(self->state != JSPromiseProxyState::PENDING);
+}
+
+PyObject *JSPromiseProxyMethodDefinitions::JSPromiseProxy_cancelled(JSPromiseProxy *self, PyObject *Py_UNUSED(ignored)) {
+  return PyBool_FromLong(self->state == JSPromiseProxyState::CANCELLED);
+}
+
+PyObject *JSPromiseProxyMethodDefinitions::JSPromiseProxy_result(JSPromiseProxy *self, PyObject *Py_UNUSED(ignored)) {
+  if (self->state == JSPromiseProxyState::CANCELLED) {
+    setCancelledError(self);
+    return NULL;
+  }
+  if (self->state == JSPromiseProxyState::PENDING) {
+    setInvalidStateError("Result is not ready.");
+    return NULL;
+  }
+
+  if (self->exception) {
+    PyErr_SetObject((PyObject *)Py_TYPE(self->exception), self->exception);
+    return NULL;
+  }
+  Py_INCREF(self->result);
+  return self->result;
+}
+
+PyObject *JSPromiseProxyMethodDefinitions::JSPromiseProxy_exception(JSPromiseProxy *self, PyObject *Py_UNUSED(ignored)) {
+  if (self->state == JSPromiseProxyState::CANCELLED) {
+    setCancelledError(self);
+    return NULL;
+  }
+  if (self->state == JSPromiseProxyState::PENDING) {
+    setInvalidStateError("Exception is not set.");
+    return NULL;
+  }
+
+  if (self->exception) {
+    Py_INCREF(self->exception);
+    return self->exception;
+  }
+  Py_RETURN_NONE;
+}
+
+PyObject *JSPromiseProxyMethodDefinitions::JSPromiseProxy_add_done_callback(JSPromiseProxy *self, PyObject *args, PyObject *kwargs) {
+  static const char *kwlist[] = {"", "context", NULL};
+  PyObject *callback;
+  PyObject *context = NULL;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|$O:add_done_callback", (char **)kwlist, &callback, &context)) {
+    return NULL;
+  }
+  if (!bindLoop(self)) { // the callbacks run on the loop which awaits
+    return NULL;
+  }
+
+  // https://docs.python.org/3/library/asyncio-future.html#asyncio.Future.add_done_callback
+  if (context == NULL || context == Py_None) {
+    context = PyContext_CopyCurrent();
+    if (!context) {
+      return NULL;
+    }
+  } else {
+    Py_INCREF(context);
+  }
+
+  if (self->state != JSPromiseProxyState::PENDING) {
+    bool success = callSoon(self, callback, context);
+    Py_DECREF(context);
+    if (!success) {
+      return NULL;
+    }
+    Py_RETURN_NONE;
+  }
+
+  if (!self->callback0) {
+    Py_INCREF(callback);
+    self->callback0 = callback;
+    self->context0 = context; // steals the reference
+    Py_RETURN_NONE;
+  }
+
+  PyObject *pair = PyTuple_Pack(2, callback, context);
+  Py_DECREF(context);
+  if (!pair) {
+    return NULL;
+  }
+  if (!self->callbacks) {
+    self->callbacks = PyList_New(0);
+  }
+  int status = self->callbacks ? PyList_Append(self->callbacks, pair) : -1;
+  Py_DECREF(pair);
+  if (status < 0) {
+    return NULL;
+  }
+  Py_RETURN_NONE;
+}
+
+PyObject *JSPromiseProxyMethodDefinitions::JSPromiseProxy_remove_done_callback(JSPromiseProxy *self, PyObject *fn) {
+  Py_ssize_t removed = 0;
+
+  if (self->callback0) {
+    int equal = PyObject_RichCompareBool(self->callback0, fn, Py_EQ);
+    if (equal < 0) {
+      return NULL;
+    }
+    if (equal) {
+      Py_CLEAR(self->callback0);
+      Py_CLEAR(self->context0);
+      removed++;
+    }
+  }
+
+  if (self->callbacks) {
+    PyObject *kept = PyList_New(0);
+    if (!kept) {
+      return NULL;
+    }
+    for (Py_ssize_t index = 0; index < PyList_GET_SIZE(self->callbacks); index++) {
+      PyObject *pair = PyList_GET_ITEM(self->callbacks, index);
+      int equal = PyObject_RichCompareBool(PyTuple_GET_ITEM(pair, 0), fn, Py_EQ);
+      if (equal < 0 || (!equal && PyList_Append(kept, pair) < 0)) {
+        Py_DECREF(kept);
+        return NULL;
+      }
+      removed += equal;
+    }
+    Py_SETREF(self->callbacks, kept);
+  }
+
+  return PyLong_FromSsize_t(removed);
+}
+
+PyObject *JSPromiseProxyMethodDefinitions::JSPromiseProxy_cancel(JSPromiseProxy *self, PyObject *args, PyObject *kwargs) {
+  static const char *kwlist[] = {"msg", NULL};
+  PyObject *msg = Py_None;
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|O:cancel", (char **)kwlist, &msg)) {
+    return NULL;
+  }
+
+  if (self->state != JSPromiseProxyState::PENDING) {
+    Py_RETURN_FALSE;
+  }
+
+  // Only the awaiting is cancelled, JS has no way to cancel a Promise
+  self->state = JSPromiseProxyState::CANCELLED;
+  if (msg != Py_None) {
+    Py_INCREF(msg);
+    self->cancelMessage = msg;
+  }
+  if (!scheduleCallbacks(self)) {
+    return NULL;
+  }
+  Py_RETURN_TRUE;
+}
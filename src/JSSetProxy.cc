@@ -0,0 +1,332 @@
+/**
+ * @file JSSetProxy.cc
+ * @brief JSSetProxy is a custom C-implemented python type. It acts as a proxy for JS Sets from Spidermonkey, and behaves like a collections.abc.MutableSet would.
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Distributive Corp.
+ *
+ */
+
+#include "include/JSSetProxy.hh"
+
+#include "include/JSObjectIterProxy.hh"
+#include "include/modules/pythonmonkey/pythonmonkey.hh"
+#include "include/jsTypeFactory.hh"
+#include "include/pyTypeFactory.hh"
+#include "include/setSpiderMonkeyException.hh"
+
+#include <jsapi.h>
+#include <js/MapAndSet.h>
+
+#include <Python.h>
+
+
+// private
+static bool isSetLike(PyObject *obj) {
+  return PyAnySet_Check(obj) || PyObject_TypeCheck(obj, &JSSetProxyType);
+}
+
+// private
+/**
+ * @brief `value in container`, where a value that can't be hashed is simply not in a Python set
+ *
+ * @return 1 if present, 0 if not, -1 on error
+ */
+static int contains(PyObject *container, PyObject *value) {
+  int result = PySequence_Contains(container, value);
+  if (result < 0 && PyErr_ExceptionMatches(PyExc_TypeError)) {
+    PyErr_Clear();
+    result = 0;
+  }
+  return result;
+}
+
+// private
+/**
+ * @brief Whether every value of `a` is in `b`, without hashing the values of a JSSetProxy
+ *
+ * @return 1 if a <= b, 0 if not, -1 on error
+ */
+static int isSubset(PyObject *a, PyObject *b) {
+  if (PyObject_Length(a) > PyObject_Length(b)) {
+    return PyErr_Occurred() ? -1 : 0;
+  }
+
+  PyObject *iterator = PyObject_GetIter(a);
+  if (!iterator) {
+    return -1;
+  }
+  int result = 1;
+  PyObject *value;
+  while (result == 1 && (value = PyIter_Next(iterator))) {
+    result = contains(b, value);
+    Py_DECREF(value);
+  }
+  Py_DECREF(iterator);
+  return PyErr_Occurred() ? -1 : result;
+}
+
+// private
+/**
+ * @brief Apply a Python set operator, such as PyNumber_And, with any JSSetProxy operand copied to a Python set
+ */
+static PyObject *setOperation(PyObject *self, PyObject *other, binaryfunc operation) {
+  if (!isSetLike(self) || !isSetLike(other)) {
+    Py_RETURN_NOTIMPLEMENTED;
+  }
+
+  PyObject *left = PyObject_TypeCheck(self, &JSSetProxyType) ? PySet_New(self) : (Py_INCREF(self), self);
+  if (!left) {
+    return NULL;
+  }
+  PyObject *right = PyObject_TypeCheck(other, &JSSetProxyType) ? PySet_New(other) : (Py_INCREF(other), other);
+  if (!right) {
+    Py_DECREF(left);
+    return NULL;
+  }
+  PyObject *result = operation(left, right);
+  Py_DECREF(left);
+  Py_DECREF(right);
+  return result;
+}
+
+// private
+/**
+ * @brief Convert a Python value to a JS value, the same way it would be passed to a JS function
+ *
+ * @return false with a Python exception set on error
+ */
+static bool toJsValue(JSContext *cx, PyObject *value, JS::MutableHandleValue jsValue) {
+  jsValue.set(jsTypeFactory(cx, value));
+  return !PyErr_Occurred();
+}
+
+// private
+/**
+ * @brief Remove `value` from the JS Set, `*found` tells whether it was present
+ *
+ * @return false with a Python exception set on error
+ */
+static bool deleteValue(JSSetProxy *self, PyObject *value, bool *found) {
+  JS::RootedObject set(GLOBAL_CX, *(self->jsSet));
+  JS::RootedValue jsValue(GLOBAL_CX);
+  if (!toJsValue(GLOBAL_CX, value, &jsValue)) {
+    return false;
+  }
+  if (!JS::SetDelete(GLOBAL_CX, set, jsValue, found)) {
+    setSpiderMonkeyException(GLOBAL_CX);
+    return false;
+  }
+  return true;
+}
+
+PyObject *JSSetProxyMethodDefinitions::JSSetProxy_create(JSContext *cx, JS::HandleObject set) {
+  JSSetProxy *self = (JSSetProxy *)JSSetProxyType.tp_alloc(&JSSetProxyType, 0);
+  if (!self) {
+    return NULL;
+  }
+  self->jsSet = new JS::PersistentRootedObject(cx, set);
+  return (PyObject *)self;
+}
+
+void JSSetProxyMethodDefinitions::JSSetProxy_dealloc(JSSetProxy *self) {
+  delete self->jsSet;
+  Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+Py_ssize_t JSSetProxyMethodDefinitions::JSSetProxy_length(JSSetProxy *self) {
+  JS::RootedObject set(GLOBAL_CX, *(self->jsSet));
+  return JS::SetSize(GLOBAL_CX, set);
+}
+
+int JSSetProxyMethodDefinitions::JSSetProxy_contains(JSSetProxy *self, PyObject *value) {
+  JS::RootedObject set(GLOBAL_CX, *(self->jsSet));
+  JS::RootedValue jsValue(GLOBAL_CX);
+  if (!toJsValue(GLOBAL_CX, value, &jsValue)) {
+    return -1;
+  }
+  bool found;
+  if (!JS::SetHas(GLOBAL_CX, set, jsValue, &found)) {
+    setSpiderMonkeyException(GLOBAL_CX);
+    return -1;
+  }
+  return found;
+}
+
+PyObject *JSSetProxyMethodDefinitions::JSSetProxy_iter(JSSetProxy *self) {
+  JS::RootedObject set(GLOBAL_CX, *(self->jsSet));
+  JS::RootedValue values(GLOBAL_CX);
+  if (!JS::SetValues(GLOBAL_CX, set, &values)) {
+    setSpiderMonkeyException(GLOBAL_CX);
+    return NULL;
+  }
+  JS::RootedObject valuesObj(GLOBAL_CX, &values.toObject());
+  return JSObjectIterProxyMethodDefinitions::JSObjectIterProxy_fromJSIterator(GLOBAL_CX, (PyObject *)self, valuesObj, KIND_JS_ITERATOR);
+}
+
+PyObject *JSSetProxyMethodDefinitions::JSSetProxy_repr(JSSetProxy *self) {
+  // Like `collections.Counter`: JSSetProxy({value, ...}), values may be unhashable JS objects so no set is built
+  if (JSSetProxy_length(self) == 0) {
+    return PyUnicode_FromString("JSSetProxy()");
+  }
+
+  int status = Py_ReprEnter((PyObject *)self);
+  if (status != 0) {
+    return status > 0 ? PyUnicode_FromString("JSSetProxy({...})") : NULL;
+  }
+
+  PyObject *result = NULL;
+  PyObject *values = PySequence_List((PyObject *)self);
+  if (values) {
+    PyObject *listRepr = PyObject_Repr(values);
+    PyObject *items = listRepr ? PyUnicode_Substring(listRepr, 1, PyUnicode_GET_LENGTH(listRepr) - 1) : NULL; // the list repr without the brackets
+    if (items) {
+      result = PyUnicode_FromFormat("JSSetProxy({%U})", items);
+      Py_DECREF(items);
+    }
+    Py_XDECREF(listRepr);
+    Py_DECREF(values);
+  }
+  Py_ReprLeave((PyObject *)self);
+  return result;
+}
+
+PyObject *JSSetProxyMethodDefinitions::JSSetProxy_richcompare(JSSetProxy *self, PyObject *other, int op) {
+  if (!isSetLike(other)) {
+    Py_RETURN_NOTIMPLEMENTED;
+  }
+
+  Py_ssize_t selfLength = JSSetProxy_length(self);
+  Py_ssize_t otherLength = PyObject_Length(other);
+  if (otherLength < 0) {
+    return NULL;
+  }
+
+  int result;
+  switch (op) {
+  case Py_EQ:
+  case Py_NE:
+    result = selfLength == otherLength ? isSubset((PyObject *)self, other) : 0;
+    if (result >= 0 && op == Py_NE) {
+      result = !result;
+    }
+    break;
+  case Py_LT:
+    result = selfLength < otherLength ? isSubset((PyObject *)self, other) : 0;
+    break;
+  case Py_LE:
+    result = isSubset((PyObject *)self, other);
+    break;
+  case Py_GT:
+    result = selfLength > otherLength ? isSubset(other, (PyObject *)self) : 0;
+    break;
+  case Py_GE:
+    result = isSubset(other, (PyObject *)self);
+    break;
+  default:
+    Py_RETURN_NOTIMPLEMENTED;
+  }
+
+  if (result < 0) {
+    return NULL;
+  }
+  return PyBool_FromLong(result);
+}
+
+PyObject *JSSetProxyMethodDefinitions::JSSetProxy_and(PyObject *self, PyObject *other) {
+  return setOperation(self, other, PyNumber_And);
+}
+
+PyObject *JSSetProxyMethodDefinitions::JSSetProxy_or(PyObject *self, PyObject *other) {
+  return setOperation(self, other, PyNumber_Or);
+}
+
+PyObject *JSSetProxyMethodDefinitions::JSSetProxy_subtract(PyObject *self, PyObject *other) {
+  return setOperation(self, other, PyNumber_Subtract);
+}
+
+PyObject *JSSetProxyMethodDefinitions::JSSetProxy_xor(PyObject *self, PyObject *other) {
+  return setOperation(self, other, PyNumber_Xor);
+}
+
+PyObject *JSSetProxyMethodDefinitions::JSSetProxy_add(JSSetProxy *self, PyObject *value) {
+  JS::RootedObject set(GLOBAL_CX, *(self->jsSet));
+  JS::RootedValue jsValue(GLOBAL_CX);
+  if (!toJsValue(GLOBAL_CX, value, &jsValue)) {
+    return NULL;
+  }
+  if (!JS::SetAdd(GLOBAL_CX, set, jsValue)) {
+    setSpiderMonkeyException(GLOBAL_CX);
+    return NULL;
+  }
+  Py_RETURN_NONE;
+}
+
+PyObject *JSSetProxyMethodDefinitions::JSSetProxy_discard(JSSetProxy *self, PyObject *value) {
+  bool found;
+  if (!deleteValue(self, value, &found)) {
+    return NULL;
+  }
+  Py_RETURN_NONE;
+}
+
+PyObject *JSSetProxyMethodDefinitions::JSSetProxy_remove(JSSetProxy *self, PyObject *value) {
+  bool found;
+  if (!deleteValue(self, value, &found)) {
+    return NULL;
+  }
+  if (!found) {
+    PyErr_SetObject(PyExc_KeyError, value);
+    return NULL;
+  }
+  Py_RETURN_NONE;
+}
+
+PyObject *JSSetProxyMethodDefinitions::JSSetProxy_pop(JSSetProxy *self, PyObject *Py_UNUSED(ignored)) {
+  PyObject *iterator = JSSetProxy_iter(self);
+  if (!iterator) {
+    return NULL;
+  }
+  PyObject *value = PyIter_Next(iterator);
+  Py_DECREF(iterator);
+  if (!value) {
+    if (!PyErr_Occurred()) {
+      PyErr_SetString(PyExc_KeyError, "pop from an empty set");
+    }
+    return NULL;
+  }
+
+  bool found;
+  if (!deleteValue(self, value, &found)) {
+    Py_DECREF(value);
+    return NULL;
+  }
+  return value;
+}
+
+PyObject *JSSetProxyMethodDefinitions::JSSetProxy_clear_method(JSSetProxy *self, PyObject *Py_UNUSED(ignored)) {
+  JS::RootedObject set(GLOBAL_CX, *(self->jsSet));
+  if (!JS::SetClear(GLOBAL_CX, set)) {
+    setSpiderMonkeyException(GLOBAL_CX);
+    return NULL;
+  }
+  Py_RETURN_NONE;
+}
+
+PyObject *JSSetProxyMethodDefinitions::JSSetProxy_isdisjoint(JSSetProxy *self, PyObject *other) {
+  PyObject *iterator = PyObject_GetIter(other);
+  if (!iterator) {
+    return NULL;
+  }
+  int found = 0;
+  PyObject *value;
+  while (!found && (value = PyIter_Next(iterator))) {
+    found = JSSetProxy_contains(self, value);
+    Py_DECREF(value);
+  }
+  Py_DECREF(iterator);
+  if (found < 0 || PyErr_Occurred()) {
+    return NULL;
+  }
+  return PyBool_FromLong(!found);
+}
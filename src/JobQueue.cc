@@ -12,18 +12,27 @@
 #include "include/modules/pythonmonkey/pythonmonkey.hh"
 
 #include "include/PyEventLoop.hh"
-#include "include/pyTypeFactory.hh"
 #include "include/PromiseType.hh"
+#include "include/setSpiderMonkeyException.hh"
+#include "include/registerAtFork.hh"
 
 #include <Python.h>
 
 #include <jsfriendapi.h>
 #include <mozilla/Unused.h>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <new>
 #include <stdexcept>
+#include <thread>
+#include <utility>
 
 JobQueue::JobQueue(JSContext *cx) {
   finalizationRegistryCallbacks = new JS::PersistentRooted<FunctionVector>(cx);   // Leaks but it's OK since freed at process exit
+  jobs = new JS::PersistentRooted<JobVector>(cx);   // Leaks but it's OK since freed at process exit
 }
 
 bool JobQueue::getHostDefinedData(JSContext *cx, JS::MutableHandle<JSObject *> data) const {
@@ -37,39 +46,163 @@ bool JobQueue::enqueuePromiseJob(JSContext *cx,
   [[maybe_unused]] JS::HandleObject allocationSite,
   JS::HandleObject incumbentGlobal) {
 
-  // Convert the `job` JS function to a Python function for event-loop callback
-  JS::RootedValue jobv(cx, JS::ObjectValue(*job));
-  PyObject *callback = pyTypeFactory(cx, jobv);
+  // Keep the job in our native FIFO, no Python object is created per job
+  if (!jobs->append(job)) {
+    JS_ReportOutOfMemory(cx);
+    return false;
+  }
+
+  // Inform the JS runtime that the job queue is no longer empty
+  JS::JobQueueMayNotBeEmpty(cx);
+
+  // Make sure the queue will be drained on the running Python event-loop.
+  // Without a running event-loop, the job stays queued until `pm.runMicrotasks()` is called
+  // or a job gets enqueued while an event-loop is running.
+  if (!scheduleDrain()) {
+    PyErr_Clear(); // RuntimeError: no running event-loop
+  }
+
+  return true;
+}
+
+/**
+ * @brief The Python callback sent to the event-loop, runs all the queued jobs at once
+ */
+static PyObject *drainJobQueue(PyObject *jobQueuePtr, PyObject *Py_UNUSED(_)) {
+  JobQueue *jobQueue = (JobQueue *)PyLong_AsVoidPtr(jobQueuePtr);
+  if (jobQueue->drainJobs(GLOBAL_CX)) {
+    Py_RETURN_NONE;
+  }
+
+  // A job threw. Let the event-loop report the error like it would for any other callback,
+  // and run the remaining jobs on the next loop iteration.
+  PyObject *type, *value, *traceback;
+  PyErr_Fetch(&type, &value, &traceback); // we can't call any Python code unless the error indicator is clear
+  jobQueue->scheduleDrain();
+  PyErr_Clear(); // scheduling may fail if the event-loop has stopped, the original error is the one to report
+  PyErr_Restore(type, value, traceback);
+  return NULL;
+}
+static PyMethodDef drainJobQueueDef = {"drainJobQueue", drainJobQueue, METH_NOARGS, NULL};
+
+// private
+static void wakeDispatcherIfPending();
+
+bool JobQueue::scheduleDrain() {
+  if (draining) return true; // jobs enqueued while draining run in the same checkpoint
 
-  // Send job to the running Python event-loop
   PyEventLoop loop = PyEventLoop::getRunningLoop();
   if (!loop.initialized()) return false;
 
-  // Inform the JS runtime that the job queue is no longer empty
-  JS::JobQueueMayNotBeEmpty(cx);
+  // dispatchables left behind by an event-loop that stopped can run on this one
+  wakeDispatcherIfPending();
 
-  loop.enqueue(callback);
+  if (drainScheduledOn == loop._loop) return true; // a drain is already pending on this loop
 
-  Py_DECREF(callback);
+  loop.enqueue(drainCallback);
+
+  // a drain pending on another event-loop (likely a stopped one) won't run the jobs for this loop
+  Py_XDECREF(drainScheduledOn);
+  Py_INCREF(loop._loop);
+  drainScheduledOn = loop._loop;
   return true;
 }
 
+/**
+ * @brief Call a single promise job
+ * @return false if the job threw, with the Python error indicator set
+ */
+static bool runJob(JSContext *cx, JS::HandleObject job) {
+  JSAutoRealm ar(cx, job);
+  JS::RootedValue jobValue(cx, JS::ObjectValue(*job));
+  JS::RootedValue unusedRval(cx);
+  if (!JS::Call(cx, JS::UndefinedHandleValue, jobValue, JS::HandleValueArray::empty(), &unusedRval)) {
+    setSpiderMonkeyException(cx);
+    return false;
+  }
+  return !PyErr_Occurred(); // the job may have called into Python code that raised
+}
+
+bool JobQueue::drainJobs(JSContext *cx) {
+  if (draining) {
+    // re-entered from a job (`pm.runMicrotasks()`), running the newer jobs now would overtake the rest of the current batch
+    return true;
+  }
+
+  // the pending drain, if any, is this one
+  Py_CLEAR(drainScheduledOn);
+  draining = true;
+  drainingStopped = false;
+
+  // Run the queue batch by batch. Jobs enqueued while running a batch are appended to the (now empty) queue,
+  // after every job of the current batch, so that the FIFO order is preserved.
+  bool success = true;
+  JS::Rooted<JobVector> batch(cx);
+  while (success && !jobs->empty()) {
+    std::swap(batch.get(), jobs->get());
+    for (size_t index = 0; index < batch.length(); index++) {
+      if (!runJob(cx, batch[index])) {
+        // put back the jobs that haven't run yet, ahead of the jobs enqueued meanwhile
+        JS::Rooted<JobVector> remaining(cx);
+        if (!remaining.get().append(batch.begin() + index + 1, batch.end()) || !remaining.get().appendAll(jobs->get())) {
+          JS_ReportOutOfMemory(cx);
+        } else {
+          std::swap(remaining.get(), jobs->get());
+        }
+        success = false;
+        drainingStopped = true;
+        break;
+      }
+    }
+    batch.clear();
+  }
+
+  draining = false;
+  return success;
+}
+
 void JobQueue::runJobs(JSContext *cx) {
-  // Do nothing
+  // A job that throws stops the draining, with the Python error indicator set, see `isDrainingStopped()`
+  drainJobs(cx);
 }
 
 bool JobQueue::empty() const {
-  // TODO (Tom Tang): implement using `get_running_loop` and getting job count on loop???
-  return true; // see https://hg.mozilla.org/releases/mozilla-esr128/file/tip/js/src/builtin/Promise.cpp#l6946
+  return jobs->empty(); // see https://hg.mozilla.org/releases/mozilla-esr128/file/tip/js/src/builtin/Promise.cpp#l6946
 }
 
 bool JobQueue::isDrainingStopped() const {
-  // TODO (Tom Tang): implement this by detecting if the Python event-loop is still running
-  return false;
+  return drainingStopped;
 }
 
+// Same as SpiderMonkey's own InternalJobQueue::SavedQueue, see https://hg.mozilla.org/releases/mozilla-esr128/file/tip/js/src/vm/JSContext.cpp
+class JobQueue::SavedQueue : public JS::JobQueue::SavedJobQueue {
+public:
+  SavedQueue(JSContext *cx, JobQueue *jobQueue) : jobQueue(jobQueue), saved(cx) {
+    std::swap(saved.get(), jobQueue->jobs->get());
+    std::swap(draining, jobQueue->draining);
+    std::swap(drainScheduledOn, jobQueue->drainScheduledOn);
+  }
+
+  ~SavedQueue() {
+    MOZ_ASSERT(jobQueue->jobs->empty(), "the Debugger hook must have run its own jobs");
+    std::swap(saved.get(), jobQueue->jobs->get());
+    jobQueue->draining = draining;
+    // the drain pending for the debuggee's jobs, if any, is still queued on its event-loop
+    if (drainScheduledOn) {
+      Py_XDECREF(jobQueue->drainScheduledOn);
+      jobQueue->drainScheduledOn = drainScheduledOn;
+    }
+  }
+
+private:
+  JobQueue *jobQueue;
+  JS::Rooted<JobVector> saved;
+  bool draining = false;
+  PyObject *drainScheduledOn = nullptr;
+};
+
 js::UniquePtr<JS::JobQueue::SavedJobQueue> JobQueue::saveJobQueue(JSContext *cx) {
-  auto saved = js::MakeUnique<JS::JobQueue::SavedJobQueue>();
+  auto saved = js::MakeUnique<SavedQueue>(cx, this);
   if (!saved) {
     JS_ReportOutOfMemory(cx);
     return NULL;
@@ -77,54 +210,173 @@ js::UniquePtr<JS::JobQueue::SavedJobQueue> JobQueue::saveJobQueue(JSContext *cx)
   return saved;
 }
 
+// private
+static PyObject *afterForkInChildHandler(PyObject *self, PyObject *_);
+
+// private
+static JobQueue *contextJobQueue = nullptr; // the job queue set on the JSContext by `init()`
+
+bool JobQueue::scheduleDrainIfPending() {
+  if (!contextJobQueue || contextJobQueue->jobs->empty()) {
+    return true;
+  }
+  return contextJobQueue->scheduleDrain();
+}
+
 bool JobQueue::init(JSContext *cx) {
+  PyObject *jobQueuePtr = PyLong_FromVoidPtr(this);
+  drainCallback = PyCFunction_New(&drainJobQueueDef, jobQueuePtr);
+  Py_DECREF(jobQueuePtr);
+  if (!drainCallback) return false;
+  contextJobQueue = this;
+
   JS::SetJobQueue(cx, this);
   JS::InitDispatchToEventLoop(cx, dispatchToEventLoop, cx);
   JS::SetPromiseRejectionTrackerCallback(cx, promiseRejectionTracker);
-  return true;
+  return registerAfterForkInChild(afterForkInChildHandler);
 }
 
-static PyObject *callDispatchFunc(PyObject *dispatchFuncTuple, PyObject *Py_UNUSED(unused)) {
-  JSContext *cx = (JSContext *)PyLong_AsVoidPtr(PyTuple_GetItem(dispatchFuncTuple, 0));
-  JS::Dispatchable *dispatchable = (JS::Dispatchable *)PyLong_AsVoidPtr(PyTuple_GetItem(dispatchFuncTuple, 1));
-  dispatchable->run(cx, JS::Dispatchable::NotShuttingDown);
+// private
+// Dispatchables handed over by JS helper threads, as a lock-free MPSC (multi-producer, single-consumer) stack, newest first.
+// Producers never take the GIL nor start a thread; a single long-lived dispatcher thread wakes up the Python event-loop.
+struct DispatchNode {
+  JS::Dispatchable *dispatchable;
+  DispatchNode *next;
+};
+static std::atomic<DispatchNode *> pendingDispatches = nullptr;
+static std::mutex dispatcherMutex;
+static std::condition_variable dispatcherWakeup;
+static bool dispatcherWoken = false; // guarded by `dispatcherMutex`
+static std::atomic<bool> dispatcherStarted = false;
+static JSContext *dispatcherCx = nullptr;
+static PyObject *runDispatchablesCallback = nullptr; // created once by the dispatcher thread, with the GIL held
+
+static PyObject *runDispatchables(PyObject *cxPtr, PyObject *Py_UNUSED(unused)) {
+  JSContext *cx = (JSContext *)PyLong_AsVoidPtr(cxPtr);
+
+  // take every pending dispatchable at once, and reverse the stack so that they run in FIFO order
+  DispatchNode *node = pendingDispatches.exchange(nullptr, std::memory_order_acquire);
+  DispatchNode *fifo = nullptr;
+  while (node) {
+    DispatchNode *next = node->next;
+    node->next = fifo;
+    fifo = node;
+    node = next;
+  }
+
+  while (fifo) {
+    DispatchNode *next = fifo->next;
+    fifo->dispatchable->run(cx, JS::Dispatchable::NotShuttingDown);
+    delete fifo;
+    fifo = next;
+  }
   Py_RETURN_NONE;
 }
 
-static PyMethodDef callDispatchFuncDef = {"JsDispatchCallable", callDispatchFunc, METH_NOARGS, NULL};
+static PyMethodDef runDispatchablesDef = {"JsDispatchCallable", runDispatchables, METH_NOARGS, NULL};
+
+// private
+// How often the dispatcher looks for an event-loop again while none is running to take the pending dispatchables
+static constexpr std::chrono::milliseconds DISPATCH_RETRY_INTERVAL(50);
+
+// private
+static void wakeDispatcher() {
+  {
+    std::lock_guard<std::mutex> lock(dispatcherMutex);
+    dispatcherWoken = true;
+  }
+  dispatcherWakeup.notify_one();
+}
+
+static void wakeDispatcherIfPending() {
+  if (pendingDispatches.load(std::memory_order_relaxed) != nullptr) {
+    wakeDispatcher();
+  }
+}
+
+static void dispatcherThread(JSContext *cx) {
+  bool retry = false;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(dispatcherMutex);
+      if (retry) {
+        // Producers only wake us up when the stack goes from empty to non-empty, it isn't empty yet
+        dispatcherWakeup.wait_for(lock, DISPATCH_RETRY_INTERVAL, [] { return dispatcherWoken; });
+      } else {
+        dispatcherWakeup.wait(lock, [] { return dispatcherWoken; });
+      }
+      dispatcherWoken = false;
+    }
+    if (pendingDispatches.load(std::memory_order_acquire) == nullptr) {
+      retry = false; // already run by an earlier drain
+      continue;
+    }
+
+    // Dispatchables arriving from now on are picked up by the drain enqueued below,
+    // or wake the dispatcher again if they arrive after that drain took the pending ones
+    PyGILState_STATE gstate = PyGILState_Ensure();
+    if (!runDispatchablesCallback) {
+      PyObject *cxPtr = PyLong_FromVoidPtr(cx);
+      runDispatchablesCallback = PyCFunction_New(&runDispatchablesDef, cxPtr);
+      Py_DECREF(cxPtr);
+    }
+    {
+      // Send one drain to the running Python event-loop on cx's thread (the main thread).
+      // `call_soon_threadsafe` wakes the loop up through its own self-pipe.
+      PyEventLoop loop = PyEventLoop::getMainLoop();
+      if (loop.initialized()) {
+        loop.enqueue(runDispatchablesCallback);
+      }
+      // no running event-loop, or a closed one: keep the dispatchables pending and look again shortly
+      retry = !loop.initialized() || PyErr_Occurred();
+      PyErr_Clear();
+    } // `loop` must be destructed before we hand over the GIL
+    PyGILState_Release(gstate);
+  }
+}
 
 bool JobQueue::dispatchToEventLoop(void *closure, JS::Dispatchable *dispatchable) {
   JSContext *cx = (JSContext *)closure;
 
-  // The `dispatchToEventLoop` function is running in a helper thread, so
-  // we must acquire the Python GIL (global interpreter lock)
-  //    see https://docs.python.org/3/c-api/init.html#non-python-created-threads
-  PyGILState_STATE gstate = PyGILState_Ensure();
-
-  PyObject *dispatchFuncTuple = PyTuple_Pack(2, PyLong_FromVoidPtr(cx), PyLong_FromVoidPtr(dispatchable));
-  PyObject *pyFunc = PyCFunction_New(&callDispatchFuncDef, dispatchFuncTuple);
+  // The `dispatchToEventLoop` function is running in a JS helper thread.
+  // Avoid acquiring the Python GIL or sending jobs to event-loop from here as it may cause deadlock,
+  // the long-lived dispatcher thread does that for us.
+  bool started = false;
+  if (!dispatcherStarted.load(std::memory_order_acquire) && dispatcherStarted.compare_exchange_strong(started, true)) {
+    dispatcherCx = cx;
+    std::thread(dispatcherThread, cx).detach();
+  }
 
-  // Avoid using the current, JS helper thread to send jobs to event-loop as it may cause deadlock
-  PyThread_start_new_thread((void (*)(void *)) &sendJobToMainLoop, pyFunc);
+  DispatchNode *node = new DispatchNode{dispatchable, pendingDispatches.load(std::memory_order_relaxed)};
+  while (!pendingDispatches.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {
+    // `node->next` has been updated to the current head, retry
+  }
 
-  PyGILState_Release(gstate);
+  // Only the first pending dispatchable needs to wake the dispatcher up, a single drain runs them all
+  if (node->next == nullptr) {
+    wakeDispatcher();
+  }
   return true;
 }
 
-bool sendJobToMainLoop(PyObject *pyFunc) {
-  PyGILState_STATE gstate = PyGILState_Ensure();
-
-  // Send job to the running Python event-loop on cx's thread (the main thread)
-  PyEventLoop loop = PyEventLoop::getMainLoop();
-  if (!loop.initialized()) {
-    PyGILState_Release(gstate);
-    return false;
+void JobQueue::afterForkInChild() {
+  // The dispatcher thread is gone, and may have been waiting on the condition variable with the mutex
+  new (&dispatcherMutex) std::mutex();
+  new (&dispatcherWakeup) std::condition_variable();
+  dispatcherWoken = false;
+  bool wasStarted = dispatcherStarted.exchange(false);
+  if (wasStarted && pendingDispatches.load(std::memory_order_acquire) != nullptr) {
+    // dispatchables queued before the fork, e.g. by a helper thread task the pool finished before forking
+    dispatcherStarted = true;
+    std::thread(dispatcherThread, dispatcherCx).detach();
+    wakeDispatcher();
   }
-  loop.enqueue(pyFunc);
+}
 
-  loop._loop = nullptr; // the `Py_XDECREF` Python API call in `PyEventLoop`'s destructor will not be accessible once we hand over the GIL by `PyGILState_Release`
-  PyGILState_Release(gstate);
-  return true;
+// private
+static PyObject *afterForkInChildHandler(PyObject *Py_UNUSED(self), PyObject *Py_UNUSED(_)) {
+  JobQueue::afterForkInChild();
+  Py_RETURN_NONE;
 }
 
 void JobQueue::promiseRejectionTracker(JSContext *cx,
@@ -157,7 +409,9 @@ void JobQueue::promiseRejectionTracker(JSContext *cx,
   Py_DECREF(customHandler);
 
   // Go ahead and send this unhandled Promise rejection to the exception handler on the Python event-loop
-  PyObject *pyFuture = PromiseType::getPyObject(cx, promise); // ref count == 2
+  // The Future must be settled in a promise reaction job, as the exception handler is called as soon as it is settled and released,
+  // and the handler may run JS code, which is not allowed from inside the rejection tracker
+  PyObject *pyFuture = PromiseType::getPyObject(cx, promise, /* settleInJob */ true); // ref count == 2
   // Unhandled Future object calls the event-loop exception handler in its destructor (the `__del__` magic method)
   // See https://github.com/python/cpython/blob/v3.9.16/Lib/asyncio/futures.py#L108
   //  or https://github.com/python/cpython/blob/v3.9.16/Modules/_asynciomodule.c#L1457-L1467 (It will actually use the C module by default, see futures.py#L417-L423)
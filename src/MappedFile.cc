@@ -0,0 +1,107 @@
+/**
+ * @file MappedFile.cc
+ * @brief A read-only memory mapping of a source file, so that JS source can be compiled without being copied into a buffer first
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Distributive Corp.
+ *
+ */
+
+#include "include/MappedFile.hh"
+
+#include <Python.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#include <fcntl.h>
+#include <cerrno>
+#include <string>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+  if (address) {
+#ifdef _WIN32
+    UnmapViewOfFile(address);
+#else
+    munmap(address, length);
+#endif
+  }
+}
+
+bool MappedFile::open(const char *path) {
+#ifdef _WIN32
+  // `path` is UTF-8, as Python's filesystem encoding is on Windows, while the narrow `_open` takes the ANSI code page
+  int fd = -1;
+  int wideLength = MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, path, -1, NULL, 0);
+  if (wideLength > 0) {
+    std::wstring widePath(wideLength, L'\0');
+    MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, path, -1, widePath.data(), wideLength);
+    fd = _wopen(widePath.c_str(), _O_RDONLY | _O_BINARY);
+  } else {
+    errno = EINVAL;
+  }
+#else
+  int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+#endif
+  if (fd == -1) {
+    PyErr_SetFromErrnoWithFilename(PyExc_OSError, path);
+    return false;
+  }
+  bool ok = map(fd); // the mapping stays valid after the descriptor is closed
+#ifdef _WIN32
+  _close(fd);
+#else
+  close(fd);
+#endif
+  if (!ok) {
+    PyErr_Format(PyExc_OSError, "could not map %s, it is not a regular file", path);
+  }
+  return ok;
+}
+
+bool MappedFile::map(int fd) {
+#ifdef _WIN32
+  HANDLE handle = (HANDLE)_get_osfhandle(fd);
+  LARGE_INTEGER fileSize;
+  if (handle == INVALID_HANDLE_VALUE || GetFileType(handle) != FILE_TYPE_DISK || !GetFileSizeEx(handle, &fileSize)) {
+    return false;
+  }
+  __int64 position = _lseeki64(fd, 0, SEEK_CUR);
+  length = (size_t)fileSize.QuadPart;
+  if (length > 0) {
+    HANDLE mapping = CreateFileMappingW(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mapping) {
+      return false;
+    }
+    address = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping); // the view keeps the mapping alive
+    if (!address) {
+      return false;
+    }
+  }
+#else
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode)) {
+    return false;
+  }
+  off_t position = lseek(fd, 0, SEEK_CUR);
+  length = (size_t)fileStat.st_size;
+  if (length > 0) { // an empty mapping is an error, an empty file is just empty source
+    void *newAddress = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (newAddress == MAP_FAILED) {
+      return false;
+    }
+    address = newAddress;
+    madvise(address, length, MADV_SEQUENTIAL); // the parser reads it once, front to back
+  }
+#endif
+  offset = position > 0 ? (size_t)position : 0;
+  isMapped = true;
+  return true;
+}
@@ -0,0 +1,696 @@
+/**
+ * @file ModuleLoader.cc
+ * @brief The ES module loader: resolves `import` specifiers to file URLs, loads and parses module files on helper threads, and keeps the module map
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Distributive Corp.
+ *
+ */
+
+#include "include/ModuleLoader.hh"
+
+#include "include/modules/pythonmonkey/pythonmonkey.hh"
+#include "include/PyEventLoop.hh"
+#include "include/pyTypeFactory.hh"
+#include "include/registerAtFork.hh"
+#include "include/setSpiderMonkeyException.hh"
+
+#include <jsapi.h>
+#include <jsfriendapi.h>
+#include <js/CompilationAndEvaluation.h>
+#include <js/Modules.h>
+#include <js/Promise.h>
+#include <js/SourceText.h>
+#include <js/experimental/CompileScript.h>
+#include <js/experimental/JSStencil.h>
+
+#include <Python.h>
+
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// private
+// The number of files read and parsed at once
+static constexpr size_t LOADER_THREAD_COUNT = 4;
+
+// private
+// The native stack a loader thread may use for parsing, below the smallest default thread stack (512KiB on macOS)
+static constexpr size_t LOADER_THREAD_STACK_QUOTA = 400 * 1024;
+
+// private
+static const char FILE_URL_PREFIX[] = "file://";
+
+// private
+/**
+ * @brief An import waiting on a module, the arguments of the load hook that `JS::FinishLoadingImportedModule` takes back
+ */
+struct ImportRequest {
+  JS::PersistentRootedScript referrer;
+  JS::PersistentRootedObject moduleRequest;
+  JS::PersistentRootedValue payload;
+
+  ImportRequest(JSContext *cx, JS::HandleScript referrer, JS::HandleObject moduleRequest, JS::HandleValue payload)
+    : referrer(cx, referrer), moduleRequest(cx, moduleRequest), payload(cx, payload) {}
+};
+
+// private
+/**
+ * @brief A module file being loaded. The loader thread only touches `url`, `fc`, `stencil` and `found`,
+ * everything else is used with the GIL held on the event-loop thread.
+ */
+struct LoadJob {
+  std::string url;
+  PyObject *loop; // strong reference
+  std::vector<std::unique_ptr<ImportRequest>> requests;
+  JS::FrontendContext *fc = nullptr;
+  RefPtr<JS::Stencil> stencil;
+  bool found = false;
+  bool posted = false; // handed over to the event-loop, guarded by the GIL
+};
+
+// private
+static std::unordered_map<std::string, JS::PersistentRootedObject *> moduleMap; // URL => module record
+static std::unordered_map<std::string, LoadJob *> loadingModules; // URL => the job loading it
+static JS::PersistentRootedObject *importFunction = nullptr; // `(specifier) => import(specifier)`
+static uint64_t evalModuleCount = 0;
+
+// private
+static std::mutex loadQueueLock;
+static std::condition_variable loaderThreadsStopped;
+static std::deque<LoadJob *> loadQueue;
+static size_t loaderThreads = 0;
+static bool shuttingDown = false; // set at interpreter exit, the loader threads then never take the GIL again
+static std::vector<LoadJob *> strandedLoads; // loads nobody will finish, failed on the main thread by the next import, guarded by the GIL
+
+// private
+static std::filesystem::path urlToPath(const std::string &url) {
+  std::string path = url.substr(sizeof(FILE_URL_PREFIX) - 1);
+  path = path.substr(0, path.find('#')); // an evaluated module's URL has a fragment to keep it unique
+#ifdef _WIN32
+  if (path.size() > 2 && path[0] == '/' && path[2] == ':') {
+    path.erase(0, 1); // file:///C:/...
+  }
+#endif
+  return std::filesystem::path(path);
+}
+
+// private
+static std::string pathToUrl(const std::filesystem::path &path) {
+  std::string genericPath = path.generic_string();
+  return std::string(FILE_URL_PREFIX) + (genericPath.front() == '/' ? "" : "/") + genericPath;
+}
+
+// private
+/**
+ * @brief Resolve a module specifier to the URL of a file: a `file://` URL, an absolute path,
+ * or a path starting with `./` or `../`, relative to the importing module or else to the current directory
+ *
+ * @return false if the specifier can't be resolved, such as a bare specifier
+ */
+static bool resolve(const std::string &specifier, const std::string &referrerUrl, std::string &url) {
+  std::error_code error;
+  std::filesystem::path path;
+  if (specifier.rfind(FILE_URL_PREFIX, 0) == 0) {
+    path = urlToPath(specifier);
+  } else if (specifier.rfind("./", 0) == 0 || specifier.rfind("../", 0) == 0) {
+    std::filesystem::path base = referrerUrl.empty() ? std::filesystem::current_path(error) : urlToPath(referrerUrl).parent_path();
+    path = base / std::filesystem::path(specifier);
+  } else if (std::filesystem::path(specifier).is_absolute()) {
+    path = std::filesystem::path(specifier);
+  } else {
+    return false;
+  }
+  path = std::filesystem::absolute(path, error);
+  if (error) {
+    return false;
+  }
+  url = pathToUrl(path.lexically_normal());
+  return true;
+}
+
+// private
+static bool readSource(const std::string &url, std::string &source) {
+  std::ifstream file(urlToPath(url), std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  source.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  return !file.bad();
+}
+
+// private
+static void setModuleOptions(JS::CompileOptions &options, const std::string &url) {
+  options.setFileAndLine(url.c_str(), 1);
+}
+
+// private
+static bool registerModule(JSContext *cx, const std::string &url, JS::HandleObject module) {
+  JSString *urlString = JS_NewStringCopyUTF8Z(cx, JS::ConstUTF8CharsZ(url.c_str(), url.size()));
+  if (!urlString) {
+    return false;
+  }
+  JS::SetModulePrivate(module, JS::StringValue(urlString)); // the referrer URL of its imports, and its `import.meta.url`
+  moduleMap[url] = new JS::PersistentRootedObject(cx, module);
+  return true;
+}
+
+// private
+static void unregisterModule(const std::string &url) {
+  auto entry = moduleMap.find(url);
+  if (entry != moduleMap.end()) {
+    delete entry->second;
+    moduleMap.erase(entry);
+  }
+}
+
+// private
+static void reportModuleNotFound(JSContext *cx, const std::string &url) {
+  JS_ReportErrorUTF8(cx, "Cannot find module '%s'", url.c_str());
+}
+
+// private
+/**
+ * @brief Finish the imports waiting on a module, or fail them with the pending exception if `module` is null
+ *
+ * @return false with a pending exception if finishing one of them failed
+ */
+static bool finishRequests(JSContext *cx, std::vector<std::unique_ptr<ImportRequest>> &requests, JS::HandleObject module) {
+  JS::RootedValue error(cx);
+  if (!module) {
+    if (!JS_GetPendingException(cx, &error)) {
+      return false;
+    }
+    JS_ClearPendingException(cx);
+  }
+  bool ok = true;
+  for (auto &request : requests) {
+    if (module) {
+      ok = JS::FinishLoadingImportedModule(cx, request->referrer, request->moduleRequest, request->payload, module, false) && ok;
+    } else {
+      JS::FinishLoadingImportedModuleFailed(cx, request->payload, error);
+    }
+  }
+  return ok;
+}
+
+// private
+static void destroyJob(LoadJob *job) {
+  if (job->fc) {
+    JS::DestroyFrontendContext(job->fc);
+  }
+  Py_XDECREF(job->loop);
+  delete job;
+}
+
+// private
+/**
+ * @brief Instantiate a loaded module and finish the imports waiting on it, runs on the event-loop thread
+ */
+static PyObject *finishLoad(PyObject *jobPtr, PyObject *Py_UNUSED(unused)) {
+  LoadJob *job = (LoadJob *)PyLong_AsVoidPtr(jobPtr);
+  JSContext *cx = GLOBAL_CX;
+  loadingModules.erase(job->url);
+
+  JS::CompileOptions options(cx);
+  setModuleOptions(options, job->url);
+  JS::RootedObject module(cx);
+  if (job->stencil) {
+    JS::InstantiateOptions instantiateOptions(options);
+    module = JS::InstantiateModuleStencil(cx, instantiateOptions, job->stencil);
+    if (module && !registerModule(cx, job->url, module)) {
+      module = nullptr;
+    }
+  } else if (job->fc && JS::HadFrontendErrors(job->fc)) {
+    JS::ConvertFrontendErrorsToRuntimeErrors(cx, job->fc, options); // a SyntaxError, the same as a synchronous load
+  } else if (!job->found) {
+    reportModuleNotFound(cx, job->url);
+  } else {
+    JS_ReportOutOfMemory(cx);
+  }
+
+  bool ok = finishRequests(cx, job->requests, module);
+  destroyJob(job);
+  if (!ok) {
+    setSpiderMonkeyException(cx);
+    return NULL; // reported by the event-loop's exception handler
+  }
+  Py_RETURN_NONE;
+}
+static PyMethodDef finishLoadDef = {"finishLoad", finishLoad, METH_NOARGS, NULL};
+
+// private
+static void parseModule(LoadJob *job) {
+  std::string source;
+  job->found = readSource(job->url, source);
+  if (!job->found) {
+    return;
+  }
+  job->fc = JS::NewFrontendContext();
+  if (!job->fc) {
+    return;
+  }
+  JS::SetNativeStackQuota(job->fc, LOADER_THREAD_STACK_QUOTA);
+  JS::CompileOptions options((JS::CompileOptions::ForFrontendContext()));
+  setModuleOptions(options, job->url);
+  JS::SourceText<mozilla::Utf8Unit> sourceText;
+  if (sourceText.init(job->fc, source.data(), source.size(), JS::SourceOwnership::Borrowed)) {
+    JS::CompilationStorage compileStorage;
+    job->stencil = JS::CompileModuleScriptToStencil(job->fc, options, sourceText, compileStorage);
+  }
+}
+
+// private
+/**
+ * @brief Stop waiting on a load that will never be finished, the imports waiting on it fail on the next import
+ * and a later import of the same URL loads it again. Must be called with the GIL held.
+ */
+static void strandLoad(LoadJob *job) {
+  auto loading = loadingModules.find(job->url);
+  if (loading != loadingModules.end() && loading->second == job) {
+    loadingModules.erase(loading);
+  }
+  strandedLoads.push_back(job);
+}
+
+// private
+/**
+ * @brief Fail the imports waiting on stranded loads, runs on the main thread
+ */
+static void failStrandedLoads(JSContext *cx) {
+  std::vector<LoadJob *> stranded;
+  stranded.swap(strandedLoads);
+  for (LoadJob *job : stranded) {
+    JS_ReportErrorUTF8(cx, "Cannot load module '%s', the event-loop it was loading for is gone", job->url.c_str());
+    if (!finishRequests(cx, job->requests, nullptr)) {
+      JS_ClearPendingException(cx);
+    }
+    destroyJob(job);
+  }
+}
+
+// private
+/**
+ * @brief Hand the parsed module over to the event-loop that requested it, `call_soon_threadsafe` wakes it up through its own self-pipe
+ */
+static void postToLoop(LoadJob *job) {
+  PyGILState_STATE gstate = PyGILState_Ensure();
+  PyObject *jobPtr = PyLong_FromVoidPtr(job);
+  PyObject *callback = jobPtr ? PyCFunction_New(&finishLoadDef, jobPtr) : NULL;
+  Py_XDECREF(jobPtr);
+  PyObject *handle = callback ? PyObject_CallMethod(job->loop, "call_soon_threadsafe", "O", callback) : NULL;
+  if (handle) {
+    job->posted = true;
+  } else {
+    PyErr_Clear(); // the event-loop is closed
+    strandLoad(job);
+  }
+  Py_XDECREF(handle);
+  Py_XDECREF(callback);
+  PyGILState_Release(gstate);
+}
+
+// private
+static void loaderThreadMain() {
+  std::unique_lock<std::mutex> lock(loadQueueLock);
+  while (!shuttingDown && !loadQueue.empty()) {
+    LoadJob *job = loadQueue.front();
+    loadQueue.pop_front();
+    lock.unlock();
+    parseModule(job);
+    lock.lock();
+    if (shuttingDown) {
+      break; // nobody is left to import it, the job is leaked as freeing it needs the GIL
+    }
+    // `stopLoaderThreads` waits for this thread with the GIL released, so the interpreter isn't finalizing yet
+    lock.unlock();
+    postToLoop(job);
+    lock.lock();
+  }
+  loaderThreads--;
+  loaderThreadsStopped.notify_all();
+}
+
+// private
+/**
+ * @brief Registered with `atexit`: drop the queued loads and wait for the running ones,
+ * so that no loader thread calls `PyGILState_Ensure` once the interpreter is finalizing
+ */
+static PyObject *stopLoaderThreads(PyObject *Py_UNUSED(self), PyObject *Py_UNUSED(_)) {
+  std::deque<LoadJob *> dropped;
+  {
+    std::lock_guard<std::mutex> lock(loadQueueLock);
+    shuttingDown = true;
+    dropped.swap(loadQueue);
+  }
+  for (LoadJob *job : dropped) {
+    strandLoad(job);
+  }
+
+  Py_BEGIN_ALLOW_THREADS
+  {
+    std::unique_lock<std::mutex> lock(loadQueueLock);
+    loaderThreadsStopped.wait(lock, []() { return loaderThreads == 0; });
+  }
+  Py_END_ALLOW_THREADS
+  Py_RETURN_NONE;
+}
+static PyMethodDef stopLoaderThreadsDef = {"stopLoaderThreads", stopLoaderThreads, METH_NOARGS, NULL};
+
+// private
+/**
+ * @brief The loader threads don't survive `os.fork()`, and one of them may have held `loadQueueLock`.
+ * The child starts over with a new lock and an empty queue, and the loads that weren't handed over to the event-loop are stranded.
+ */
+static PyObject *afterForkInChild(PyObject *Py_UNUSED(self), PyObject *Py_UNUSED(_)) {
+  new (&loadQueueLock) std::mutex();
+  new (&loaderThreadsStopped) std::condition_variable();
+  new (&loadQueue) std::deque<LoadJob *>();
+  loaderThreads = 0;
+  std::vector<LoadJob *> lost;
+  for (auto &loading : loadingModules) {
+    if (!loading.second->posted) {
+      lost.push_back(loading.second);
+    }
+  }
+  for (LoadJob *job : lost) {
+    strandLoad(job);
+  }
+  Py_RETURN_NONE;
+}
+
+// private
+/**
+ * @brief Register `stopLoaderThreads` with `atexit` and `afterForkInChild` with `os.register_at_fork`, once, before the first loader thread starts
+ *
+ * @return success, or false with the Python error indicator set
+ */
+static bool registerHandlers() {
+  static bool registered = false;
+  if (registered) {
+    return true;
+  }
+
+  PyObject *atexit = PyImport_ImportModule("atexit");
+  PyObject *stop = atexit ? PyCFunction_New(&stopLoaderThreadsDef, NULL) : NULL;
+  PyObject *result = stop ? PyObject_CallMethod(atexit, "register", "O", stop) : NULL;
+  Py_XDECREF(atexit);
+  Py_XDECREF(stop);
+  if (!result) {
+    return false;
+  }
+  Py_DECREF(result);
+
+  if (!registerAfterForkInChild(afterForkInChild)) {
+    return false;
+  }
+
+  registered = true;
+  return true;
+}
+
+// private
+/**
+ * @brief Queue a load, a new loader thread is only started while there are fewer than `LOADER_THREAD_COUNT`
+ *
+ * @return false if the interpreter is exiting, the job is then left to the caller
+ */
+static bool enqueueLoad(LoadJob *job) {
+  std::lock_guard<std::mutex> lock(loadQueueLock);
+  if (shuttingDown) {
+    return false;
+  }
+  loadQueue.push_back(job);
+  if (loaderThreads < LOADER_THREAD_COUNT) { // the imports of a module are all requested at once, so they load in parallel
+    loaderThreads++;
+    std::thread(loaderThreadMain).detach();
+  }
+  return true;
+}
+
+// private
+static JSObject *loadSynchronously(JSContext *cx, const std::string &url) {
+  std::string source;
+  if (!readSource(url, source)) {
+    reportModuleNotFound(cx, url);
+    return nullptr;
+  }
+  JS::CompileOptions options(cx);
+  setModuleOptions(options, url);
+  JS::SourceText<mozilla::Utf8Unit> sourceText;
+  if (!sourceText.init(cx, source.data(), source.size(), JS::SourceOwnership::Borrowed)) {
+    return nullptr;
+  }
+  JS::RootedObject module(cx, JS::CompileModule(cx, options, sourceText));
+  if (!module || !registerModule(cx, url, module)) {
+    return nullptr;
+  }
+  return module;
+}
+
+// private
+static bool loadImportedModule(JSContext *cx, JS::HandleScript referrer, JS::HandleObject moduleRequest,
+  JS::HandleValue hostDefined, JS::HandleValue payload, uint32_t lineNumber, JS::ColumnNumberOneOrigin columnNumber) {
+  failStrandedLoads(cx);
+
+  JS::RootedString specifierString(cx, JS::GetModuleRequestSpecifier(cx, moduleRequest));
+  if (!specifierString) {
+    return false;
+  }
+  JS::UniqueChars specifier = JS_EncodeStringToUTF8(cx, specifierString);
+  if (!specifier) {
+    return false;
+  }
+  std::string referrerUrl;
+  if (referrer) {
+    JS::RootedValue referrerPrivate(cx, JS::GetScriptPrivate(referrer)); // unset for a classic script
+    if (referrerPrivate.isString()) {
+      JS::RootedString referrerString(cx, referrerPrivate.toString());
+      JS::UniqueChars referrerChars = JS_EncodeStringToUTF8(cx, referrerString);
+      if (!referrerChars) {
+        return false;
+      }
+      referrerUrl = referrerChars.get();
+    }
+  }
+
+  std::string url;
+  if (!resolve(specifier.get(), referrerUrl, url)) {
+    JS_ReportErrorUTF8(cx, "Cannot resolve module specifier '%s', it must be a file:// URL, an absolute path or start with ./ or ../", specifier.get());
+    return false;
+  }
+
+  // the module map
+  auto loaded = moduleMap.find(url);
+  if (loaded != moduleMap.end()) {
+    JS::RootedObject module(cx, *loaded->second);
+    return JS::FinishLoadingImportedModule(cx, referrer, moduleRequest, payload, module, false);
+  }
+
+  // already being loaded for another import
+  auto loading = loadingModules.find(url);
+  if (loading != loadingModules.end()) {
+    loading->second->requests.push_back(std::make_unique<ImportRequest>(cx, referrer, moduleRequest, payload));
+    return true;
+  }
+
+  PyEventLoop loop = PyEventLoop::getRunningLoop();
+  if (loop.initialized() && registerHandlers()) {
+    LoadJob *job = new LoadJob{url, loop._loop};
+    Py_INCREF(loop._loop);
+    job->requests.push_back(std::make_unique<ImportRequest>(cx, referrer, moduleRequest, payload));
+    if (enqueueLoad(job)) {
+      loadingModules[url] = job; // the loader thread needs the GIL to hand it back
+      return true;
+    }
+    destroyJob(job); // the interpreter is exiting
+  }
+
+  // no running event-loop, or the interpreter is exiting
+  PyErr_Clear();
+  JS::RootedObject module(cx, loadSynchronously(cx, url));
+  if (!module) {
+    return false;
+  }
+  return JS::FinishLoadingImportedModule(cx, referrer, moduleRequest, payload, module, false);
+}
+
+// private
+static bool setImportMeta(JSContext *cx, JS::HandleValue privateValue, JS::HandleObject metaObject) {
+  if (!privateValue.isString()) {
+    return true;
+  }
+  return JS_DefineProperty(cx, metaObject, "url", privateValue, JSPROP_ENUMERATE);
+}
+
+void ModuleLoader::init(JSContext *cx) {
+  JSRuntime *rt = JS_GetRuntime(cx);
+  JS::SetModuleLoadHook(rt, loadImportedModule);
+  JS::SetModuleMetadataHook(rt, setImportMeta);
+}
+
+void ModuleLoader::clear() {
+  for (auto &entry : moduleMap) {
+    delete entry.second;
+  }
+  moduleMap.clear();
+  delete importFunction;
+  importFunction = nullptr;
+}
+
+// private
+/**
+ * @brief Call `import(specifier)` from a classic script, so that relative specifiers resolve against the current directory
+ *
+ * @return false with a SpiderMonkeyError set on failure
+ */
+static bool callImport(JSContext *cx, JS::HandleString specifier, JS::MutableHandleValue promise) {
+  if (!importFunction) {
+    static const char *argNames[] = {"specifier"};
+    static const char body[] = "return import(specifier);";
+    JS::CompileOptions options(cx);
+    options.setFileAndLine("pythonmonkey importModule", 1);
+    JS::SourceText<mozilla::Utf8Unit> source;
+    JS::RootedObjectVector emptyScopeChain(cx);
+    JSFunction *fun = nullptr;
+    if (source.init(cx, body, sizeof(body) - 1, JS::SourceOwnership::Borrowed)) {
+      fun = JS::CompileFunction(cx, emptyScopeChain, options, "importModule", 1, argNames, source);
+    }
+    if (!fun) {
+      setSpiderMonkeyException(cx);
+      return false;
+    }
+    importFunction = new JS::PersistentRootedObject(cx, JS_GetFunctionObject(fun));
+  }
+
+  JS::RootedValue fun(cx, JS::ObjectValue(**importFunction));
+  JS::RootedValueArray<1> args(cx);
+  args[0].setString(specifier);
+  JS::RootedObject thisObj(cx, JS::CurrentGlobalOrNull(cx));
+  if (!JS_CallFunctionValue(cx, thisObj, fun, args, promise)) {
+    setSpiderMonkeyException(cx);
+    return false;
+  }
+  return true;
+}
+
+// private
+/**
+ * @brief The result of an import: an awaitable of the module namespace while an event-loop is running.
+ * Without one, the module graph has been loaded synchronously, so its evaluation is run to completion
+ * by draining the job queue, and the namespace itself is returned.
+ */
+static PyObject *importResult(JSContext *cx, JS::HandleValue promise) {
+  PyEventLoop loop = PyEventLoop::getRunningLoop();
+  if (loop.initialized()) {
+    return pyTypeFactory(cx, promise); // a JS Promise becomes an awaitable
+  }
+  PyErr_Clear();
+
+  JS::RootedObject promiseObj(cx, &promise.toObject());
+  js::RunJobs(cx);
+  if (PyErr_Occurred()) { // a job threw
+    return NULL;
+  }
+  switch (JS::GetPromiseState(promiseObj)) {
+  case JS::PromiseState::Fulfilled: {
+      JS::RootedValue moduleNamespace(cx, JS::GetPromiseResult(promiseObj));
+      return pyTypeFactory(cx, moduleNamespace);
+    }
+  case JS::PromiseState::Rejected: {
+      JS::RootedValue error(cx, JS::GetPromiseResult(promiseObj));
+      JS_SetPendingException(cx, error);
+      setSpiderMonkeyException(cx);
+      return NULL;
+    }
+  default:
+    PyErr_SetString(PyExc_RuntimeError, "the module is still being evaluated, its top-level await needs a running event-loop");
+    return NULL;
+  }
+}
+
+// private
+/**
+ * @brief Drop an evaluated module from the module map once its import settles, nothing else can import its unique URL
+ */
+static bool forgetEvaluatedModule(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  JS::RootedString urlString(cx, js::GetFunctionNativeReserved(&args.callee(), 0).toString());
+  JS::UniqueChars url = JS_EncodeStringToUTF8(cx, urlString);
+  if (!url) {
+    return false;
+  }
+  unregisterModule(url.get());
+  args.rval().setUndefined();
+  return true;
+}
+
+PyObject *ModuleLoader::importModule(JSContext *cx, PyObject *specifier) {
+  Py_ssize_t length;
+  const char *chars = PyUnicode_AsUTF8AndSize(specifier, &length);
+  if (!chars) {
+    return NULL;
+  }
+  JS::RootedString specifierString(cx, JS_NewStringCopyUTF8N(cx, JS::UTF8Chars(chars, length)));
+  if (!specifierString) {
+    setSpiderMonkeyException(cx);
+    return NULL;
+  }
+  JS::RootedValue promise(cx);
+  if (!callImport(cx, specifierString, &promise)) {
+    return NULL;
+  }
+  return importResult(cx, promise);
+}
+
+PyObject *ModuleLoader::evalModule(JSContext *cx, const JS::ReadOnlyCompileOptions &options, const char *chars, size_t length) {
+  const char *filename = options.filename().c_str();
+  std::error_code error;
+  std::filesystem::path path = std::filesystem::absolute(std::filesystem::path(filename ? filename : "evaluate"), error);
+  if (error) {
+    PyErr_Format(PyExc_OSError, "could not resolve the module filename %s: %s", filename, error.message().c_str());
+    return NULL;
+  }
+  std::string url = pathToUrl(path.lexically_normal()) + "#" + std::to_string(++evalModuleCount); // a new module every time
+
+  JS::SourceText<mozilla::Utf8Unit> source;
+  if (!source.init(cx, chars, length, JS::SourceOwnership::Borrowed)) {
+    setSpiderMonkeyException(cx);
+    return NULL;
+  }
+  JS::RootedObject module(cx, JS::CompileModule(cx, options, source));
+  if (!module || !registerModule(cx, url, module)) {
+    setSpiderMonkeyException(cx);
+    return NULL;
+  }
+
+  // registered only until its import settles, the namespace keeps the module alive after that
+  JS::RootedString urlString(cx, JS_NewStringCopyUTF8Z(cx, JS::ConstUTF8CharsZ(url.c_str(), url.size())));
+  JS::RootedObject forget(cx, urlString ? (JSObject *)js::NewFunctionWithReserved(cx, forgetEvaluatedModule, 1, 0, NULL) : nullptr);
+  JS::RootedValue promise(cx);
+  if (!forget) {
+    setSpiderMonkeyException(cx);
+    unregisterModule(url);
+    return NULL;
+  }
+  js::SetFunctionNativeReserved(forget, 0, JS::StringValue(urlString));
+  if (!callImport(cx, urlString, &promise)) { // loads its imports, links and evaluates it
+    unregisterModule(url);
+    return NULL;
+  }
+  JS::RootedObject promiseObj(cx, &promise.toObject());
+  if (!JS::AddPromiseReactions(cx, promiseObj, forget, forget)) {
+    setSpiderMonkeyException(cx);
+    return NULL;
+  }
+  return importResult(cx, promise);
+}
@@ -11,6 +11,8 @@
 #include "include/modules/pythonmonkey/pythonmonkey.hh"
 #include "include/PromiseType.hh"
 #include "include/DictType.hh"
+#include "include/JSPromiseProxy.hh"
+#include "include/PyBaseProxyHandler.hh"
 #include "include/PyEventLoop.hh"
 #include "include/pyTypeFactory.hh"
 #include "include/jsTypeFactory.hh"
@@ -26,17 +28,13 @@
 #define PY_FUTURE_OBJ_SLOT 0
 #define PROMISE_OBJ_SLOT 1
 
-static bool onResolvedCb(JSContext *cx, unsigned argc, JS::Value *vp) {
-  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
-
-  // Get the Promise state
-  JS::Value promiseObjVal = js::GetFunctionNativeReserved(&args.callee(), PROMISE_OBJ_SLOT);
-  JS::RootedObject promise(cx, &promiseObjVal.toObject());
-  JS::PromiseState state = JS::GetPromiseState(promise);
-
-  // Convert the Promise's result (either fulfilled resolution or rejection reason) to a Python object
+// private
+/**
+ * @brief Convert the result of a settled JS Promise (either fulfilled resolution or rejection reason) to a Python object
+ * @return new reference, an exception object if the Promise has been rejected
+ */
+static PyObject *getSettledResult(JSContext *cx, JS::PromiseState state, JS::HandleValue resultArg) {
   //  The result might be another JS function, so we must keep them alive
-  JS::RootedValue resultArg(cx, args[0]);
   PyObject *result = pyTypeFactory(cx, resultArg);
   if (state == JS::PromiseState::Rejected && !PyExceptionInstance_Check(result)) {
     // Wrap the result object into a SpiderMonkeyError object
@@ -48,13 +46,17 @@ static bool onResolvedCb(JSContext *cx, unsigned argc, JS::Value *vp) {
     Py_DECREF(result);
     result = wrapped;
   }
+  return result;
+}
 
-  // Get the `asyncio.Future` Python object from function's reserved slot
-  JS::Value futureObjVal = js::GetFunctionNativeReserved(&args.callee(), PY_FUTURE_OBJ_SLOT);
-  PyObject *futureObj = (PyObject *)(futureObjVal.toPrivate());
+// private
+/**
+ * @brief Settle the Python asyncio.Future by the result of a settled JS Promise
+ */
+static void settleFuture(JSContext *cx, PyEventLoop::Future &future, JS::PromiseState state, JS::HandleValue resultArg) {
+  PyObject *result = getSettledResult(cx, state, resultArg);
 
   // Settle the Python asyncio.Future by the Promise's result
-  PyEventLoop::Future future = PyEventLoop::Future(futureObj); // will decrease the reference count of `futureObj` in its destructor when the `onResolvedCb` function ends
   if (state == JS::PromiseState::Fulfilled) {
     future.setResult(result);
   } else { // state == JS::PromiseState::Rejected
@@ -62,31 +64,186 @@ static bool onResolvedCb(JSContext *cx, unsigned argc, JS::Value *vp) {
   }
 
   Py_DECREF(result);
+}
+
+// private
+/**
+ * @brief Settle the JSPromiseProxy by the result of its settled JS Promise
+ */
+static bool settleProxy(JSContext *cx, JSPromiseProxy *proxy, JS::PromiseState state, JS::HandleValue resultArg) {
+  PyObject *result = getSettledResult(cx, state, resultArg);
+  bool success = JSPromiseProxyMethodDefinitions::JSPromiseProxy_settle(proxy, result, state == JS::PromiseState::Rejected);
+  Py_DECREF(result);
+  return success;
+}
+
+static bool onResolvedCb(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+
+  // Get the Promise state
+  JS::Value promiseObjVal = js::GetFunctionNativeReserved(&args.callee(), PROMISE_OBJ_SLOT);
+  JS::RootedObject promise(cx, &promiseObjVal.toObject());
+  JS::PromiseState state = JS::GetPromiseState(promise);
+
+  // Get the `asyncio.Future` Python object from function's reserved slot
+  JS::Value futureObjVal = js::GetFunctionNativeReserved(&args.callee(), PY_FUTURE_OBJ_SLOT);
+  PyObject *futureObj = (PyObject *)(futureObjVal.toPrivate());
+
+  PyEventLoop::Future future = PyEventLoop::Future(futureObj); // will decrease the reference count of `futureObj` in its destructor when the `onResolvedCb` function ends
+  JS::RootedValue resultArg(cx, args[0]);
+  settleFuture(cx, future, state, resultArg);
+
   // Py_DECREF(futureObj) // the destructor for the `PyEventLoop::Future` above already does this
   return true;
 }
 
-PyObject *PromiseType::getPyObject(JSContext *cx, JS::HandleObject promise) {
-  // Create a python asyncio.Future on the running python event-loop
+// private
+static bool onProxyResolvedCb(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+
+  // Get the Promise state
+  JS::Value promiseObjVal = js::GetFunctionNativeReserved(&args.callee(), PROMISE_OBJ_SLOT);
+  JS::RootedObject promise(cx, &promiseObjVal.toObject());
+  JS::PromiseState state = JS::GetPromiseState(promise);
+
+  // Get the JSPromiseProxy from function's reserved slot, the reference held by the slot is released here
+  JS::Value proxyObjVal = js::GetFunctionNativeReserved(&args.callee(), PY_FUTURE_OBJ_SLOT);
+  JSPromiseProxy *proxy = (JSPromiseProxy *)(proxyObjVal.toPrivate());
+
+  JS::RootedValue resultArg(cx, args[0]);
+  settleProxy(cx, proxy, state, resultArg); // on failure, the Python error is left for the job queue to report
+  Py_DECREF(proxy);
+  return true;
+}
+
+// private
+/**
+ * @brief Settle the JSPromiseProxy by an iterator result `{ value, done }`, raising StopAsyncIteration once `done`
+ */
+static bool settleProxyByIteratorResult(JSContext *cx, JSPromiseProxy *proxy, JS::HandleValue iteratorResult) {
+  if (!iteratorResult.isObject()) {
+    PyObject *error = PyObject_CallFunction(PyExc_TypeError, "s", "iterator result is not an object");
+    bool success = error && JSPromiseProxyMethodDefinitions::JSPromiseProxy_settle(proxy, error, true);
+    Py_XDECREF(error);
+    return success;
+  }
+
+  JS::RootedObject result(cx, &iteratorResult.toObject());
+  JS::RootedValue done(cx);
+  JS::RootedValue value(cx);
+  if (!JS_GetProperty(cx, result, "done", &done) || !JS_GetProperty(cx, result, "value", &value)) {
+    // a getter threw, reject with the JS exception
+    JS::RootedValue exception(cx);
+    JS_GetPendingException(cx, &exception);
+    JS_ClearPendingException(cx);
+    return settleProxy(cx, proxy, JS::PromiseState::Rejected, exception);
+  }
+
+  if (JS::ToBoolean(done)) {
+    PyObject *stop = PyObject_CallObject(PyExc_StopAsyncIteration, NULL);
+    bool success = stop && JSPromiseProxyMethodDefinitions::JSPromiseProxy_settle(proxy, stop, true);
+    Py_XDECREF(stop);
+    return success;
+  }
+  return settleProxy(cx, proxy, JS::PromiseState::Fulfilled, value);
+}
+
+// private
+static bool onIteratorResultCb(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+
+  // Get the Promise state
+  JS::Value promiseObjVal = js::GetFunctionNativeReserved(&args.callee(), PROMISE_OBJ_SLOT);
+  JS::RootedObject promise(cx, &promiseObjVal.toObject());
+  JS::PromiseState state = JS::GetPromiseState(promise);
+
+  // Get the JSPromiseProxy from function's reserved slot, the reference held by the slot is released here
+  JS::Value proxyObjVal = js::GetFunctionNativeReserved(&args.callee(), PY_FUTURE_OBJ_SLOT);
+  JSPromiseProxy *proxy = (JSPromiseProxy *)(proxyObjVal.toPrivate());
+
+  JS::RootedValue resultArg(cx, args[0]);
+  if (state == JS::PromiseState::Fulfilled) {
+    settleProxyByIteratorResult(cx, proxy, resultArg);
+  } else {
+    settleProxy(cx, proxy, state, resultArg);
+  }
+  Py_DECREF(proxy);
+  return true;
+}
+
+PyObject *PromiseType::getPyObject(JSContext *cx, JS::HandleObject promise, bool settleInJob) {
+  PyEventLoop loop = PyEventLoop::getRunningLoop();
+  PyObject *loopObj = loop._loop;
+  if (!loop.initialized()) {
+    // e.g. a synchronous handler whose script ends with a promise, the proxy binds a loop once awaited
+    PyErr_Clear();
+    loopObj = Py_None;
+    settleInJob = false; // an asyncio.Future needs its loop from the start
+  }
+
+  if (settleInJob) {
+    // Create a python asyncio.Future on the running python event-loop, which reports its exception if never retrieved
+    PyEventLoop::Future future = loop.createFuture(); // ref count == 1
+
+    // Callbacks to settle the Python asyncio.Future once the JS Promise is resolved
+    JS::RootedObject onResolved = JS::RootedObject(cx, (JSObject *)js::NewFunctionWithReserved(cx, onResolvedCb, 1, 0, NULL));
+    js::SetFunctionNativeReserved(onResolved, PY_FUTURE_OBJ_SLOT, JS::PrivateValue(future.getFutureObject())); // ref count == 2
+    js::SetFunctionNativeReserved(onResolved, PROMISE_OBJ_SLOT, JS::ObjectValue(*promise));
+    JS::AddPromiseReactions(cx, promise, onResolved, onResolved);
+
+    return future.getFutureObject(); // must be a new reference, ref count == 3
+    // Here the ref count for the `future` object is 3, but will immediately decrease to 2 in `PyEventLoop::Future`'s destructor when the `PromiseType::getPyObject` function ends
+    // Leaving one reference for the returned Python object, and another one for the `onResolved` callback function
+  }
+
+  // A JSPromiseProxy is awaitable by itself, no asyncio.Future needed
+  PyObject *proxy = JSPromiseProxyMethodDefinitions::JSPromiseProxy_create(cx, promise, loopObj);
+  if (!proxy) return NULL;
+
+  // Fast path: the Promise is already settled, so return a completed proxy
+  // instead of waiting for a promise reaction job and another event-loop turn
+  JS::PromiseState state = JS::GetPromiseState(promise);
+  if (state != JS::PromiseState::Pending) {
+    JS::RootedValue result(cx, JS::GetPromiseResult(promise));
+    if (!settleProxy(cx, (JSPromiseProxy *)proxy, state, result)) {
+      Py_DECREF(proxy);
+      return NULL;
+    }
+    return proxy;
+  }
+
+  // Callbacks to settle the JSPromiseProxy once the JS Promise is resolved
+  JS::RootedObject onResolved = JS::RootedObject(cx, (JSObject *)js::NewFunctionWithReserved(cx, onProxyResolvedCb, 1, 0, NULL));
+  Py_INCREF(proxy); // released by `onProxyResolvedCb`
+  js::SetFunctionNativeReserved(onResolved, PY_FUTURE_OBJ_SLOT, JS::PrivateValue(proxy));
+  js::SetFunctionNativeReserved(onResolved, PROMISE_OBJ_SLOT, JS::ObjectValue(*promise));
+  JS::AddPromiseReactions(cx, promise, onResolved, onResolved);
+
+  return proxy;
+}
+
+PyObject *PromiseType::getIteratorResultPyObject(JSContext *cx, JS::HandleObject promise) {
   PyEventLoop loop = PyEventLoop::getRunningLoop();
   if (!loop.initialized()) return NULL;
-  PyEventLoop::Future future = loop.createFuture(); // ref count == 1
 
-  // Callbacks to settle the Python asyncio.Future once the JS Promise is resolved
-  JS::RootedObject onResolved = JS::RootedObject(cx, (JSObject *)js::NewFunctionWithReserved(cx, onResolvedCb, 1, 0, NULL));
-  js::SetFunctionNativeReserved(onResolved, PY_FUTURE_OBJ_SLOT, JS::PrivateValue(future.getFutureObject())); // ref count == 2
+  PyObject *proxy = JSPromiseProxyMethodDefinitions::JSPromiseProxy_create(cx, promise, loop._loop);
+  if (!proxy) return NULL;
+
+  // Exactly one reaction per `next()` call, the JS iterator is not advanced again before Python asks for the next value
+  JS::RootedObject onResolved = JS::RootedObject(cx, (JSObject *)js::NewFunctionWithReserved(cx, onIteratorResultCb, 1, 0, NULL));
+  Py_INCREF(proxy); // released by `onIteratorResultCb`
+  js::SetFunctionNativeReserved(onResolved, PY_FUTURE_OBJ_SLOT, JS::PrivateValue(proxy));
   js::SetFunctionNativeReserved(onResolved, PROMISE_OBJ_SLOT, JS::ObjectValue(*promise));
   JS::AddPromiseReactions(cx, promise, onResolved, onResolved);
 
-  return future.getFutureObject(); // must be a new reference, ref count == 3
-  // Here the ref count for the `future` object is 3, but will immediately decrease to 2 in `PyEventLoop::Future`'s destructor when the `PromiseType::getPyObject` function ends
-  // Leaving one reference for the returned Python object, and another one for the `onResolved` callback function
+  return proxy;
 }
 
 // Callback to resolve or reject the JS Promise when the Future is done
 static PyObject *futureOnDoneCallback(PyObject *futureCallbackTuple, PyObject *args) {
   JSContext *cx = (JSContext *)PyLong_AsVoidPtr(PyTuple_GetItem(futureCallbackTuple, 0));
   JS::PersistentRootedObject *rootedPtr = (JS::PersistentRootedObject *)PyLong_AsVoidPtr(PyTuple_GetItem(futureCallbackTuple, 1));
+  PromiseType::ResolveAs resolveAs = (PromiseType::ResolveAs)PyLong_AsLong(PyTuple_GetItem(futureCallbackTuple, 2));
   JS::HandleObject promise = *rootedPtr;
   PyObject *futureObj = PyTuple_GetItem(args, 0); // the callback is called with the Future object as its only argument
                                                   // see https://docs.python.org/3.9/library/asyncio-future.html#asyncio.Future.add_done_callback
@@ -104,8 +261,15 @@ static PyObject *futureOnDoneCallback(PyObject *futureCallbackTuple, PyObject *a
     Py_XDECREF(errType); Py_XDECREF(errValue); Py_XDECREF(traceback);
   } else if (exception == Py_None) { // no exception set on this awaitable, safe to get result, otherwise the exception will be raised when calling `futureObj.result()`
     PyObject *result = future.getResult();
-    JS::ResolvePromise(cx, promise, JS::RootedValue(cx, jsTypeFactorySafe(cx, result)));
+    JS::RootedValue value(cx, jsTypeFactorySafe(cx, result));
+    if (resolveAs != PromiseType::VALUE) {
+      value.setObjectOrNull(newIteratorResult(cx, value, resolveAs == PromiseType::DONE_ITERATOR_RESULT));
+    }
+    JS::ResolvePromise(cx, promise, value);
     Py_DECREF(result);
+  } else if (resolveAs == PromiseType::ITERATOR_RESULT && PyErr_GivenExceptionMatches(exception, PyExc_StopAsyncIteration)) {
+    // the async iterator is exhausted
+    JS::ResolvePromise(cx, promise, JS::RootedValue(cx, JS::ObjectOrNullValue(newIteratorResult(cx, JS::UndefinedHandleValue, true))));
   } else { // having exception set, to reject the promise
     JS::RejectPromise(cx, promise, JS::RootedValue(cx, jsTypeFactorySafe(cx, exception)));
   }
@@ -118,7 +282,12 @@ static PyObject *futureOnDoneCallback(PyObject *futureCallbackTuple, PyObject *a
 }
 static PyMethodDef futureCallbackDef = {"futureOnDoneCallback", futureOnDoneCallback, METH_VARARGS, NULL};
 
-JSObject *PromiseType::toJsPromise(JSContext *cx, PyObject *pyObject) {
+JSObject *PromiseType::toJsPromise(JSContext *cx, PyObject *pyObject, ResolveAs resolveAs) {
+  // A JSPromiseProxy converts back to the very JS Promise it wraps
+  if (resolveAs == VALUE && PyObject_TypeCheck(pyObject, &JSPromiseProxyType)) {
+    return *((JSPromiseProxy *)pyObject)->promise;
+  }
+
   // Create a new JS Promise object
   JSObject *promise = JS::NewPromiseObject(cx, nullptr);
 
@@ -131,7 +300,7 @@ JSObject *PromiseType::toJsPromise(JSContext *cx, PyObject *pyObject) {
 
   // Resolve or Reject the JS Promise once the python awaitable is done
   JS::PersistentRooted<JSObject *> *rootedPtr = new JS::PersistentRooted<JSObject *>(cx, promise); // `promise` is required to be rooted from here to the end of onDoneCallback
-  PyObject *futureCallbackTuple = PyTuple_Pack(2, PyLong_FromVoidPtr(cx), PyLong_FromVoidPtr(rootedPtr));
+  PyObject *futureCallbackTuple = PyTuple_Pack(3, PyLong_FromVoidPtr(cx), PyLong_FromVoidPtr(rootedPtr), PyLong_FromLong(resolveAs));
   PyObject *onDoneCb = PyCFunction_New(&futureCallbackDef, futureCallbackTuple);
   future.addDoneCallback(onDoneCb);
   Py_INCREF(pyObject);
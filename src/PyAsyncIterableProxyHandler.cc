@@ -0,0 +1,178 @@
+/**
+ * @file PyAsyncIterableProxyHandler.cc
+ * @brief Struct for creating JS proxy objects for Python async iterators, such as async generators
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Distributive Corp.
+ *
+ */
+
+
+#include "include/PyAsyncIterableProxyHandler.hh"
+
+#include "include/PromiseType.hh"
+#include "include/jsTypeFactory.hh"
+
+#include <jsapi.h>
+#include <jsfriendapi.h>
+#include <js/Proxy.h>
+#include <js/Symbol.h>
+
+#include <Python.h>
+
+
+
+const char PyAsyncIterableProxyHandler::family = 0;
+
+
+// private
+/**
+ * @brief Return a JS Promise for the awaitable returned by `__anext__()` or `aclose()`
+ */
+static bool awaitableToIteratorResult(JSContext *cx, JS::CallArgs &args, PyObject *awaitable, PromiseType::ResolveAs resolveAs) {
+  if (!awaitable) {
+    setPyException(cx);
+    return false;
+  }
+
+  JSObject *promise = PromiseType::toJsPromise(cx, awaitable, resolveAs);
+  Py_DECREF(awaitable);
+  if (!promise) {
+    if (PyErr_Occurred()) {
+      setPyException(cx);
+    }
+    return false;
+  }
+
+  args.rval().setObject(*promise);
+  return true;
+}
+
+static bool asyncIterable_next(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  JS::RootedObject thisObj(cx);
+  if (!args.computeThis(cx, &thisObj)) return false;
+
+  PyObject *it = JS::GetMaybePtrFromReservedSlot<PyObject>(thisObj, PyObjectSlot);
+
+  // see https://docs.python.org/3/c-api/typeobj.html#c.PyAsyncMethods.am_anext
+  PyTypeObject *tp = Py_TYPE(it);
+  if (tp->tp_as_async == NULL || tp->tp_as_async->am_anext == NULL) {
+    JS_ReportErrorASCII(cx, "'%s' object is not an async iterator", tp->tp_name);
+    return false;
+  }
+
+  // One `__anext__()` per `next()`, nothing is produced ahead of the JS consumer
+  return awaitableToIteratorResult(cx, args, tp->tp_as_async->am_anext(it), PromiseType::ITERATOR_RESULT);
+}
+
+static bool asyncIterable_return(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  JS::RootedObject thisObj(cx);
+  if (!args.computeThis(cx, &thisObj)) return false;
+
+  PyObject *it = JS::GetMaybePtrFromReservedSlot<PyObject>(thisObj, PyObjectSlot);
+
+  // Called when a `for await` loop exits early, so the async generator gets to run its `finally` blocks
+  //    see https://docs.python.org/3/reference/expressions.html#agen.aclose
+  return awaitableToIteratorResult(cx, args, PyObject_CallMethod(it, "aclose", NULL), PromiseType::DONE_ITERATOR_RESULT);
+}
+
+static bool asyncIterable_asyncIterator(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  JS::RootedObject thisObj(cx);
+  if (!args.computeThis(cx, &thisObj)) return false;
+
+  PyObject *self = JS::GetMaybePtrFromReservedSlot<PyObject>(thisObj, PyObjectSlot);
+
+  // `__aiter__()` is only called once JS actually starts iterating
+  PyObject *it = Py_TYPE(self)->tp_as_async->am_aiter(self);
+  if (!it) {
+    setPyException(cx);
+    return false;
+  }
+  if (it == self) { // async generators are their own async iterators
+    Py_DECREF(it);
+    args.rval().set(args.thisv());
+    return true;
+  }
+
+  // the iterator may only have `__anext__`, so it gets a proxy of the same kind rather than going through jsTypeFactory
+  JS::RootedValue v(cx);
+  JS::RootedObject objectPrototype(cx);
+  JS_GetClassPrototype(cx, JSProto_Object, &objectPrototype);
+  JSObject *proxy = js::NewProxyObject(cx, js::GetProxyHandler(thisObj), v, objectPrototype.get());
+  if (!proxy) {
+    Py_DECREF(it);
+    return false;
+  }
+  JS::SetReservedSlot(proxy, PyObjectSlot, JS::PrivateValue(it)); // the new reference is released when the proxy is finalized
+  args.rval().setObject(*proxy);
+  return true;
+}
+
+static JSMethodDef asyncIterable_methods[] = {
+  {"next", asyncIterable_next, 0},
+  {"return", asyncIterable_return, 0},
+  {NULL, NULL, 0}
+};
+
+// private
+static bool defineMethod(JSContext *cx, JSNative call, unsigned nargs, JS::MutableHandle<mozilla::Maybe<JS::PropertyDescriptor>> desc) {
+  JSFunction *newFunction = JS_NewFunction(cx, call, nargs, 0, NULL);
+  if (!newFunction) return false;
+  JS::RootedObject funObj(cx, JS_GetFunctionObject(newFunction));
+  desc.set(mozilla::Some(
+    JS::PropertyDescriptor::Data(
+      JS::ObjectValue(*funObj),
+      {JS::PropertyAttribute::Enumerable}
+    )
+  ));
+  return true;
+}
+
+bool PyAsyncIterableProxyHandler::getOwnPropertyDescriptor(
+  JSContext *cx, JS::HandleObject proxy, JS::HandleId id,
+  JS::MutableHandle<mozilla::Maybe<JS::PropertyDescriptor>> desc
+) const {
+  PyObject *self = JS::GetMaybePtrFromReservedSlot<PyObject>(proxy, PyObjectSlot);
+
+  // see if we're calling a function
+  if (id.isString()) {
+    for (size_t index = 0;; index++) {
+      bool isThatFunction;
+      const char *methodName = asyncIterable_methods[index].name;
+      if (methodName == NULL) {
+        break;
+      }
+      else if (JS_StringEqualsAscii(cx, id.toString(), methodName, &isThatFunction) && isThatFunction) {
+        if (asyncIterable_methods[index].call == asyncIterable_return && !PyObject_HasAttrString(self, "aclose")) {
+          break; // a plain async iterator has nothing to clean up
+        }
+        return defineMethod(cx, asyncIterable_methods[index].call, asyncIterable_methods[index].nargs, desc);
+      }
+    }
+  }
+
+  // symbol property
+  if (id.isSymbol()) {
+    JS::RootedSymbol rootedSymbol(cx, id.toSymbol());
+    if (JS::GetSymbolCode(rootedSymbol) == JS::SymbolCode::asyncIterator) {
+      return defineMethod(cx, asyncIterable_asyncIterator, 0, desc);
+    }
+  }
+
+  PyObject *attrName = idToKey(cx, id);
+  PyObject *item = PyObject_GetAttr(self, attrName);
+  if (!item && PyErr_ExceptionMatches(PyExc_AttributeError)) {
+    PyErr_Clear(); // clear error, we will be returning undefined in this case
+  }
+
+  return handleGetOwnPropertyDescriptor(cx, id, desc, item);
+}
+
+bool PythonAsyncIterable_Check(PyObject *obj) {
+  // see https://docs.python.org/3/c-api/typeobj.html#c.PyAsyncMethods
+  PyTypeObject *tp = Py_TYPE(obj);
+  return tp->tp_as_async != NULL && tp->tp_as_async->am_aiter != NULL;
+}
@@ -41,6 +41,34 @@ bool idToIndex(JSContext *cx, JS::HandleId id, Py_ssize_t *index) {
   }
 }
 
+// private
+// Pinned atoms are never collected, so these ids need no rooting
+static jsid iteratorResultValueId = JS::PropertyKey::Void();
+static jsid iteratorResultDoneId = JS::PropertyKey::Void();
+
+JSObject *newIteratorResult(JSContext *cx, JS::HandleValue value, bool done) {
+  if (iteratorResultValueId.isVoid()) {
+    JSString *valueAtom = JS_AtomizeAndPinString(cx, "value");
+    JSString *doneAtom = JS_AtomizeAndPinString(cx, "done");
+    if (!valueAtom || !doneAtom) return nullptr;
+    iteratorResultValueId = JS::PropertyKey::fromPinnedString(valueAtom);
+    iteratorResultDoneId = JS::PropertyKey::fromPinnedString(doneAtom);
+  }
+
+  JS::RootedObject result(cx, JS_NewPlainObject(cx));
+  if (!result) return nullptr;
+
+  // Defining rather than setting skips the lookup of setters on the prototype chain,
+  // and the fixed order makes every result go through the same shape transitions
+  JS::HandleId valueId = JS::HandleId::fromMarkedLocation(&iteratorResultValueId);
+  JS::HandleId doneId = JS::HandleId::fromMarkedLocation(&iteratorResultDoneId);
+  if (!JS_DefinePropertyById(cx, result, valueId, value, JSPROP_ENUMERATE) ||
+      !JS_DefinePropertyById(cx, result, doneId, done ? JS::TrueHandleValue : JS::FalseHandleValue, JSPROP_ENUMERATE)) {
+    return nullptr;
+  }
+  return result;
+}
+
 bool PyBaseProxyHandler::getPrototypeIfOrdinary(JSContext *cx, JS::HandleObject proxy,
   bool *isOrdinary,
   JS::MutableHandleObject protop) const {
@@ -78,6 +78,7 @@ enum {
   BytesIteratorSlotIteratedObject,
   BytesIteratorSlotNextIndex,
   BytesIteratorSlotItemKind,
+  BytesIteratorSlotLength,
   BytesIteratorSlotCount
 };
 
@@ -88,64 +89,47 @@ static bool iterator_next(JSContext *cx, unsigned argc, JS::Value *vp) {
   JS::RootedObject thisObj(cx);
   if (!args.computeThis(cx, &thisObj)) return false;
 
-  JS::PersistentRootedObject *arrayBuffer = JS::GetMaybePtrFromReservedSlot<JS::PersistentRootedObject>(thisObj, BytesIteratorSlotIteratedObject);
-  JS::RootedObject rootedArrayBuffer(cx, arrayBuffer->get());
-
-  JS::RootedValue rootedNextIndex(cx, JS::GetReservedSlot(thisObj, BytesIteratorSlotNextIndex));
-  JS::RootedValue rootedItemKind(cx, JS::GetReservedSlot(thisObj, BytesIteratorSlotItemKind));
-
-  int32_t nextIndex;
-  int32_t itemKind;
-  if (!JS::ToInt32(cx, rootedNextIndex, &nextIndex) || !JS::ToInt32(cx, rootedItemKind, &itemKind)) return false;
-
-  JS::RootedObject result(cx, JS_NewPlainObject(cx));
-
-  Py_ssize_t len = JS::GetArrayBufferByteLength(rootedArrayBuffer);
+  // the slots are only ever set to int32 values by `array_iterator_func`
+  int32_t nextIndex = JS::GetReservedSlot(thisObj, BytesIteratorSlotNextIndex).toInt32();
+  int32_t itemKind = JS::GetReservedSlot(thisObj, BytesIteratorSlotItemKind).toInt32();
+  int32_t len = JS::GetReservedSlot(thisObj, BytesIteratorSlotLength).toInt32();
 
   if (nextIndex >= len) {
     // UnsafeSetReservedSlot(obj, ITERATOR_SLOT_TARGET, null); // TODO lose ref
-    JS::RootedValue done(cx, JS::BooleanValue(true));
-    if (!JS_SetProperty(cx, result, "done", done)) return false;
+    JSObject *result = newIteratorResult(cx, JS::UndefinedHandleValue, true);
+    if (!result) return false;
     args.rval().setObject(*result);
-    return result;
+    return true;
   }
 
   JS::SetReservedSlot(thisObj, BytesIteratorSlotNextIndex, JS::Int32Value(nextIndex + 1));
 
-  JS::RootedValue done(cx, JS::BooleanValue(false));
-  if (!JS_SetProperty(cx, result, "done", done)) return false;
-
-  if (itemKind == ITEM_KIND_VALUE) {
-    bool isSharedMemory;
-    JS::AutoCheckCannotGC autoNoGC(cx);
-    uint8_t *data = JS::GetArrayBufferData(rootedArrayBuffer, &isSharedMemory, autoNoGC);
-
-    JS::RootedValue value(cx, JS::Int32Value(data[nextIndex]));
-    if (!JS_SetProperty(cx, result, "value", value)) return false;
+  JS::RootedValue value(cx);
+  if (itemKind == ITEM_KIND_KEY) {
+    value.setInt32(nextIndex);
   }
-  else if (itemKind == ITEM_KIND_KEY_AND_VALUE) {
-    JS::Rooted<JS::ValueArray<2>> items(cx);
-
-    JS::RootedValue rootedNextIndex(cx, JS::Int32Value(nextIndex));
-    items[0].set(rootedNextIndex);
-
-    bool isSharedMemory;
-    JS::AutoCheckCannotGC autoNoGC(cx);
-    uint8_t *data = JS::GetArrayBufferData(rootedArrayBuffer, &isSharedMemory, autoNoGC);
-
-    JS::RootedValue value(cx, JS::Int32Value(data[nextIndex]));
-    items[1].set(value);
-
-    JS::RootedValue pair(cx);
-    JSObject *array = JS::NewArrayObject(cx, items);
-    pair.setObject(*array);
-    if (!JS_SetProperty(cx, result, "value", pair)) return false;
-  }
-  else { // itemKind == ITEM_KIND_KEY
-    JS::RootedValue value(cx, JS::Int32Value(nextIndex));
-    if (!JS_SetProperty(cx, result, "value", value)) return false;
+  else {
+    JS::PersistentRootedObject *arrayBuffer = JS::GetMaybePtrFromReservedSlot<JS::PersistentRootedObject>(thisObj, BytesIteratorSlotIteratedObject);
+    uint8_t byte;
+    {
+      bool isSharedMemory;
+      JS::AutoCheckCannotGC autoNoGC(cx);
+      byte = JS::GetArrayBufferData(*arrayBuffer, &isSharedMemory, autoNoGC)[nextIndex];
+    }
+    value.setInt32(byte);
+
+    if (itemKind == ITEM_KIND_KEY_AND_VALUE) {
+      JS::Rooted<JS::ValueArray<2>> items(cx);
+      items[0].setInt32(nextIndex);
+      items[1].set(value);
+      JSObject *pair = JS::NewArrayObject(cx, items);
+      if (!pair) return false;
+      value.setObject(*pair);
+    }
   }
 
+  JSObject *result = newIteratorResult(cx, value, false);
+  if (!result) return false;
   args.rval().setObject(*result);
   return true;
 }
@@ -225,6 +209,8 @@ static bool array_iterator_func(JSContext *cx, unsigned argc, JS::Value *vp, int
   JS::SetReservedSlot(obj, BytesIteratorSlotIteratedObject, JS::PrivateValue(arrayBuffer));
   JS::SetReservedSlot(obj, BytesIteratorSlotNextIndex, JS::Int32Value(0));
   JS::SetReservedSlot(obj, BytesIteratorSlotItemKind, JS::Int32Value(itemKind));
+  // the bytes object is immutable, so its length is only read once per iterator
+  JS::SetReservedSlot(obj, BytesIteratorSlotLength, JS::Int32Value((int32_t)JS::GetArrayBufferByteLength(*arrayBuffer)));
 
   args.rval().setObject(*obj);
   return true;
@@ -10,6 +10,7 @@
 
 
 #include "include/PyEventLoop.hh"
+#include "include/TimerWheel.hh"
 
 #include <Python.h>
 
@@ -33,41 +34,6 @@ static PyObject *eventLoopJobWrapper(PyObject *jobFn, PyObject *Py_UNUSED(_)) {
 }
 static PyMethodDef loopJobWrapperDef = {"eventLoopJobWrapper", eventLoopJobWrapper, METH_NOARGS, NULL};
 
-static PyObject *_enqueueWithDelay(PyObject *_loop, PyEventLoop::AsyncHandle::id_t handleId, PyObject *jobFn, double delaySeconds, bool repeat);
-
-/**
- * @brief Wrapper to remove the reference of the timer after the job finishes
- */
-static PyObject *timerJobWrapper(PyObject *jobFn, PyObject *args) {
-  PyObject *_loop = PyTuple_GetItem(args, 0);
-  PyEventLoop::AsyncHandle::id_t handleId = PyLong_AsLong(PyTuple_GetItem(args, 1));
-  double delaySeconds = PyFloat_AsDouble(PyTuple_GetItem(args, 2));
-  bool repeat = (bool)PyLong_AsLong(PyTuple_GetItem(args, 3));
-
-  PyObject *ret = PyObject_CallObject(jobFn, NULL); // jobFn()
-  Py_XDECREF(ret); // don't care about its return value
-
-  PyObject *errType, *errValue, *traceback; // we can't call any Python code unless the error indicator is clear
-  PyErr_Fetch(&errType, &errValue, &traceback);
-  // Making sure a `AsyncHandle::fromId` call is close to its `handle`'s use.
-  // We need to ensure the memory block doesn't move for reallocation before we can use the pointer,
-  // as we could have multiple new `setTimeout` calls to expand the `_timeoutIdMap` vector while running the job function in parallel.
-  auto handle = PyEventLoop::AsyncHandle::fromId(handleId);
-  if (repeat && !handle->cancelled()) {
-    _enqueueWithDelay(_loop, handleId, jobFn, delaySeconds, repeat);
-  } else {
-    handle->removeRef();
-  }
-
-  if (errType != NULL) { // PyErr_Occurred()
-    PyErr_Restore(errType, errValue, traceback);
-    return NULL;
-  } else {
-    Py_RETURN_NONE;
-  }
-}
-static PyMethodDef timerJobWrapperDef = {"timerJobWrapper", timerJobWrapper, METH_VARARGS, NULL};
-
 PyEventLoop::AsyncHandle PyEventLoop::enqueue(PyObject *jobFn) {
   PyEventLoop::_locker->incCounter();
   PyObject *wrapper = PyCFunction_New(&loopJobWrapperDef, jobFn);
@@ -77,25 +43,13 @@ PyEventLoop::AsyncHandle PyEventLoop::enqueue(PyObject *jobFn) {
   return PyEventLoop::AsyncHandle(asyncHandle);
 }
 
-static PyObject *_enqueueWithDelay(PyObject *_loop, PyEventLoop::AsyncHandle::id_t handleId, PyObject *jobFn, double delaySeconds, bool repeat) {
-  PyObject *wrapper = PyCFunction_New(&timerJobWrapperDef, jobFn);
-  // Schedule job to the Python event-loop
-  //    https://docs.python.org/3/library/asyncio-eventloop.html#asyncio.loop.call_later
-  PyObject *asyncHandle = PyObject_CallMethod(_loop, "call_later", "dOOIdb", delaySeconds, wrapper, _loop, handleId, delaySeconds, repeat); // https://docs.python.org/3/c-api/arg.html#c.Py_BuildValue
-  if (!asyncHandle) {
-    return nullptr; // RuntimeError
-  }
-
-  auto handle = PyEventLoop::AsyncHandle::fromId(handleId);
-  Py_XDECREF(handle->swap(asyncHandle));
-
-  return asyncHandle;
-}
-
 PyEventLoop::AsyncHandle::id_t PyEventLoop::enqueueWithDelay(PyObject *jobFn, double delaySeconds, bool repeat) {
   auto handleId = PyEventLoop::AsyncHandle::newEmpty();
-  if (!_enqueueWithDelay(_loop, handleId, jobFn, delaySeconds, repeat)) {
+  // Schedule job to the timer wheel of the Python event-loop, which calls `loop.call_at` once for all timers
+  TimerWheel *wheel = TimerWheel::forLoop(_loop);
+  if (!wheel || !wheel->schedule(handleId, jobFn, delaySeconds, repeat)) {
     PyErr_Print(); // RuntimeError: Non-thread-safe operation invoked on an event loop other than the current one
+    return handleId; // not armed on the event-loop, so it must not keep `pm.wait()` waiting
   }
   auto handle = PyEventLoop::AsyncHandle::fromId(handleId);
   handle->addRef();
@@ -109,9 +63,14 @@ PyEventLoop::Future PyEventLoop::createFuture() {
 }
 
 PyEventLoop::Future PyEventLoop::ensureFuture(PyObject *awaitable) {
-  PyObject *asyncio = PyImport_ImportModule("asyncio");
+  // Look up `asyncio.ensure_future` only once
+  static PyObject *ensure_future_fn = nullptr;
+  if (!ensure_future_fn) {
+    PyObject *asyncio = PyImport_ImportModule("asyncio");
+    ensure_future_fn = PyObject_GetAttrString(asyncio, "ensure_future"); // ensure_future_fn = asyncio.ensure_future, kept for the lifetime of the process
+    Py_DECREF(asyncio);
+  }
 
-  PyObject *ensure_future_fn = PyObject_GetAttrString(asyncio, "ensure_future"); // ensure_future_fn = asyncio.ensure_future
   // instead of a simpler `PyObject_CallMethod`, only the `PyObject_Call` API function can be used here because `loop` is a keyword-only argument
   //    see https://docs.python.org/3.9/library/asyncio-future.html#asyncio.ensure_future
   //        https://docs.python.org/3/c-api/call.html#object-calling-api
@@ -122,8 +81,6 @@ PyEventLoop::Future PyEventLoop::ensureFuture(PyObject *awaitable) {
   PyObject *futureObj = PyObject_Call(ensure_future_fn, args, kwargs); // futureObj = ensure_future_fn(awaitable, loop=_loop)
 
   // clean up
-  Py_DECREF(asyncio);
-  Py_DECREF(ensure_future_fn);
   Py_DECREF(args);
   Py_DECREF(kwargs);
 
@@ -244,6 +201,12 @@ void PyEventLoop::AsyncHandle::cancel() {
     removeRef(); // automatically unref at finish
   }
 
+  if (!_handle) { // a timer in a `TimerWheel`, its entry is dropped once the wheel reaches it
+    _timerScheduled = false;
+    _timerCancelled = true;
+    return;
+  }
+
   // https://docs.python.org/3/library/asyncio-eventloop.html#asyncio.Handle.cancel
   PyObject *ret = PyObject_CallMethod(_handle, "cancel", NULL); // returns None
   Py_XDECREF(ret);
@@ -251,13 +214,109 @@ void PyEventLoop::AsyncHandle::cancel() {
 
 /* static */
 bool PyEventLoop::AsyncHandle::cancelAll() {
-  for (AsyncHandle &handle: _timeoutIdMap) {
-    handle.cancel();
+  std::vector<id_t> timeoutIDs;
+  {
+    std::lock_guard<std::mutex> lock(_timersMutex);
+    timeoutIDs.reserve(_liveTimers.size());
+    for (id_t slotIndex: _liveTimers) {
+      timeoutIDs.push_back((_timerSlots[slotIndex].generation << TIMER_SLOT_BITS) | slotIndex);
+    }
+  }
+
+  for (id_t timeoutID: timeoutIDs) {
+    AsyncHandle *handle = fromId(timeoutID);
+    if (handle) {
+      handle->cancel();
+    }
+    releaseId(timeoutID);
   }
   return true;
 }
 
+/* static */
+PyEventLoop::AsyncHandle::id_t PyEventLoop::AsyncHandle::getUniqueId(AsyncHandle &&handle) {
+  std::lock_guard<std::mutex> lock(_timersMutex);
+
+  id_t slotIndex;
+  if (!_freeTimerSlots.empty()) {
+    slotIndex = _freeTimerSlots.front(); // FIFO, so that a slot's generation advances as slowly as possible
+    _freeTimerSlots.pop_front();
+  } else {
+    slotIndex = _timerSlots.size();
+    _timerSlots.emplace_back();
+  }
+
+  TimerSlot &slot = _timerSlots[slotIndex];
+  slot.handle.emplace(std::move(handle));
+  slot.livePos = _liveTimers.size();
+  _liveTimers.push_back(slotIndex);
+
+  return (slot.generation << TIMER_SLOT_BITS) | slotIndex;
+}
+
+/* static */
+PyEventLoop::AsyncHandle *PyEventLoop::AsyncHandle::fromId(id_t timeoutID) {
+  std::lock_guard<std::mutex> lock(_timersMutex);
+
+  id_t slotIndex = timeoutID & TIMER_SLOT_MASK;
+  if (slotIndex >= _timerSlots.size() || (timeoutID >> TIMER_ID_BITS) != 0) {
+    return nullptr; // invalid timeoutID
+  }
+
+  TimerSlot &slot = _timerSlots[slotIndex];
+  if (!slot.handle || slot.generation != (timeoutID >> TIMER_SLOT_BITS)) {
+    return nullptr; // the timer has been released
+  }
+  return &*slot.handle;
+}
+
+/* static */
+void PyEventLoop::AsyncHandle::releaseId(id_t timeoutID) {
+  std::optional<AsyncHandle> released; // destructed after unlocking, as decreasing reference counts may run arbitrary Python code
+  {
+    std::lock_guard<std::mutex> lock(_timersMutex);
+
+    id_t slotIndex = timeoutID & TIMER_SLOT_MASK;
+    if (slotIndex >= _timerSlots.size()) {
+      return; // invalid timeoutID
+    }
+
+    TimerSlot &slot = _timerSlots[slotIndex];
+    if (!slot.handle || slot.generation != (timeoutID >> TIMER_SLOT_BITS)) {
+      return; // already released
+    }
+
+    released.emplace(std::move(*slot.handle));
+    slot.handle.reset();
+    slot.generation = slot.generation % TIMER_MAX_GENERATION + 1; // invalidate every outstanding timeoutID to this slot
+
+    // swap-remove from the live timers
+    id_t lastSlotIndex = _liveTimers.back();
+    _liveTimers[slot.livePos] = lastSlotIndex;
+    _timerSlots[lastSlotIndex].livePos = slot.livePos;
+    _liveTimers.pop_back();
+
+    _freeTimerSlots.push_back(slotIndex);
+  }
+}
+
+/* static */
+std::vector<PyEventLoop::AsyncHandle *> PyEventLoop::AsyncHandle::getAllTimers() {
+  std::lock_guard<std::mutex> lock(_timersMutex);
+
+  std::vector<AsyncHandle *> timers;
+  timers.reserve(_liveTimers.size());
+  for (id_t slotIndex: _liveTimers) {
+    timers.push_back(&*_timerSlots[slotIndex].handle);
+  }
+  return timers;
+}
+
 bool PyEventLoop::AsyncHandle::cancelled() {
+  if (!_handle) {
+    return _timerCancelled;
+  }
+
   // https://docs.python.org/3/library/asyncio-eventloop.html#asyncio.Handle.cancelled
   PyObject *ret = PyObject_CallMethod(_handle, "cancelled", NULL); // returns Python bool
   bool cancelled = ret == Py_True;
@@ -266,6 +325,10 @@ bool PyEventLoop::AsyncHandle::cancelled() {
 }
 
 bool PyEventLoop::AsyncHandle::_finishedOrCancelled() {
+  if (!_handle) {
+    return !_timerScheduled;
+  }
+
   PyObject *scheduled = PyObject_GetAttrString(_handle, "_scheduled"); // this attribute only exists on asyncio.TimerHandle returned by loop.call_later
                                                                        // NULL if no such attribute (on a strict asyncio.Handle returned by loop.call_soon)
   bool notScheduled = scheduled && scheduled == Py_False; // not scheduled means the job function has already been executed or canceled
@@ -23,10 +23,9 @@ const char PyIterableProxyHandler::family = 0;
 
 
 static bool iter_next(JSContext *cx, JS::CallArgs args, PyObject *it) {
-  JS::RootedObject result(cx, JS_NewPlainObject(cx));
-
   PyObject *(*iternext)(PyObject *) = *Py_TYPE(it)->tp_iternext;
 
+  // One `tp_iternext` per `next()`: a generator only runs as far as the JS consumer has asked
   PyObject *item = iternext(it);
 
   if (item == NULL) {
@@ -40,18 +39,17 @@ static bool iter_next(JSContext *cx, JS::CallArgs args, PyObject *it) {
       }
     }
 
-    JS::RootedValue done(cx, JS::BooleanValue(true));
-    if (!JS_SetProperty(cx, result, "done", done)) return false;
+    JSObject *result = newIteratorResult(cx, JS::UndefinedHandleValue, true);
+    if (!result) return false;
     args.rval().setObject(*result);
-    return result;
+    return true;
   }
 
-  JS::RootedValue done(cx, JS::BooleanValue(false));
-  if (!JS_SetProperty(cx, result, "done", done)) return false;
-
   JS::RootedValue value(cx, jsTypeFactory(cx, item));
-  if (!JS_SetProperty(cx, result, "value", value)) return false;
+  Py_DECREF(item);
 
+  JSObject *result = newIteratorResult(cx, value, false);
+  if (!result) return false;
   args.rval().setObject(*result);
   return true;
 }
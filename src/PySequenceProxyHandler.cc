@@ -0,0 +1,242 @@
+/**
+ * @file PySequenceProxyHandler.cc
+ * @brief Struct for creating read-only JS Array-like proxy objects for Python tuples, ranges and other sequences
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Distributive Corp.
+ *
+ */
+
+
+#include "include/PySequenceProxyHandler.hh"
+
+#include "include/jsTypeFactory.hh"
+
+#include <jsapi.h>
+#include <jsfriendapi.h>
+#include <js/Id.h>
+#include <js/Symbol.h>
+#include <js/friend/ErrorMessages.h>
+
+#include <Python.h>
+
+
+
+const char PySequenceProxyHandler::family = 0;
+
+
+static bool sequence_values(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  JS::RootedObject proxy(cx, JS::ToObject(cx, args.thisv()));
+  if (!proxy) {
+    return false;
+  }
+  PyObject *self = JS::GetMaybePtrFromReservedSlot<PyObject>(proxy, PyObjectSlot);
+
+  // the sequence's own iterator steps in C, rather than Array.prototype.values doing a proxied `get` per item
+  PyObject *iterator = PyObject_GetIter(self);
+  if (!iterator) {
+    setPyException(cx);
+    return false;
+  }
+  args.rval().set(jsTypeFactory(cx, iterator));
+  Py_DECREF(iterator);
+  return true;
+}
+
+// private
+static bool defineMethod(JSContext *cx, JSNative call, unsigned nargs, JS::MutableHandle<mozilla::Maybe<JS::PropertyDescriptor>> desc) {
+  JSFunction *newFunction = JS_NewFunction(cx, call, nargs, 0, NULL);
+  if (!newFunction) return false;
+  JS::RootedObject funObj(cx, JS_GetFunctionObject(newFunction));
+  desc.set(mozilla::Some(
+    JS::PropertyDescriptor::Data(
+      JS::ObjectValue(*funObj),
+      {JS::PropertyAttribute::Enumerable}
+    )
+  ));
+  return true;
+}
+
+bool PySequenceProxyHandler::getOwnPropertyDescriptor(
+  JSContext *cx, JS::HandleObject proxy, JS::HandleId id,
+  JS::MutableHandle<mozilla::Maybe<JS::PropertyDescriptor>> desc
+) const {
+  PyObject *self = JS::GetMaybePtrFromReservedSlot<PyObject>(proxy, PyObjectSlot);
+
+  // item
+  Py_ssize_t index;
+  if (idToIndex(cx, id, &index)) {
+    PyObject *item = PySequence_GetItem(self, index); // sq_item, a range computes the item instead of storing it
+    if (!item) {
+      if (!PyErr_ExceptionMatches(PyExc_IndexError)) {
+        setPyException(cx);
+        return false;
+      }
+      PyErr_Clear(); // out of range, the item is undefined
+      desc.set(mozilla::Nothing());
+      return true;
+    }
+    desc.set(mozilla::Some(
+      JS::PropertyDescriptor::Data(
+        jsTypeFactory(cx, item),
+        {JS::PropertyAttribute::Enumerable}
+      )
+    ));
+    Py_DECREF(item);
+    return true;
+  }
+
+  // symbol property
+  if (id.isSymbol()) {
+    JS::RootedSymbol rootedSymbol(cx, id.toSymbol());
+    if (JS::GetSymbolCode(rootedSymbol) == JS::SymbolCode::iterator) {
+      return defineMethod(cx, sequence_values, 0, desc);
+    }
+    desc.set(mozilla::Nothing());
+    return true;
+  }
+
+  // "length" property
+  bool isLengthProperty;
+  if (JS_StringEqualsLiteral(cx, id.toString(), "length", &isLengthProperty) && isLengthProperty) {
+    Py_ssize_t length = PySequence_Size(self);
+    if (length < 0) {
+      setPyException(cx);
+      return false;
+    }
+    desc.set(mozilla::Some(
+      JS::PropertyDescriptor::Data(
+        JS::NumberValue(length) // a range can be longer than INT32_MAX
+      )
+    ));
+    return true;
+  }
+
+  bool isValuesProperty;
+  if (JS_StringEqualsLiteral(cx, id.toString(), "values", &isValuesProperty) && isValuesProperty) {
+    return defineMethod(cx, sequence_values, 0, desc);
+  }
+
+  // Python attributes, such as the fields of a namedtuple, everything else comes from Array.prototype
+  PyObject *attrName = idToKey(cx, id);
+  PyObject *attr = PyObject_GetAttr(self, attrName);
+  Py_DECREF(attrName);
+  if (!attr) {
+    if (!PyErr_ExceptionMatches(PyExc_AttributeError)) {
+      setPyException(cx);
+      return false;
+    }
+    PyErr_Clear();
+    desc.set(mozilla::Nothing());
+    return true;
+  }
+  desc.set(mozilla::Some(
+    JS::PropertyDescriptor::Data(
+      jsTypeFactory(cx, attr)
+    )
+  ));
+  Py_DECREF(attr);
+  return true;
+}
+
+void PySequenceProxyHandler::finalize(JS::GCContext *gcx, JSObject *proxy) const {
+  // We cannot call Py_DECREF here when shutting down as the thread state is gone.
+  // Then, when shutting down, there is only on reference left, and we don't need
+  // to free the object since the entire process memory is being released.
+  if (!Py_IsFinalizing()) {
+    PyObject *self = JS::GetMaybePtrFromReservedSlot<PyObject>(proxy, PyObjectSlot);
+    Py_DECREF(self);
+  }
+}
+
+bool PySequenceProxyHandler::defineProperty(
+  JSContext *cx, JS::HandleObject proxy, JS::HandleId id,
+  JS::Handle<JS::PropertyDescriptor> desc, JS::ObjectOpResult &result
+) const {
+  return result.failReadOnly(); // tuples and ranges are immutable
+}
+
+// private
+// The most item indexes `ownPropertyKeys` lists. Enumerating a huge lazy sequence such as `range(10**9)` (`Object.keys`, spread, `JSON.stringify`)
+// throws a RangeError instead of allocating gigabytes of keys, and every listed index fits in an integer PropertyKey.
+static constexpr Py_ssize_t MAX_ENUMERATED_LENGTH = 1 << 24;
+static_assert(MAX_ENUMERATED_LENGTH <= JSID_INT_MAX, "item indexes must be integer PropertyKeys");
+
+bool PySequenceProxyHandler::ownPropertyKeys(JSContext *cx, JS::HandleObject proxy, JS::MutableHandleIdVector props) const {
+  PyObject *self = JS::GetMaybePtrFromReservedSlot<PyObject>(proxy, PyObjectSlot);
+  Py_ssize_t length = PySequence_Size(self);
+  if (length < 0) {
+    setPyException(cx);
+    return false;
+  }
+  if (length > MAX_ENUMERATED_LENGTH) {
+    JS_ReportErrorNumberASCII(cx, js::GetErrorMessage, nullptr, JSMSG_BAD_ARRAY_LENGTH);
+    return false;
+  }
+  if (!props.reserve(length + 1)) {
+    return false;
+  }
+  // item indexes
+  for (Py_ssize_t i = 0; i < length; ++i) {
+    props.infallibleAppend(JS::PropertyKey::Int(i));
+  }
+  // the "length" property
+  props.infallibleAppend(JS::PropertyKey::NonIntAtom(JS_AtomizeString(cx, "length")));
+  return true;
+}
+
+bool PySequenceProxyHandler::delete_(JSContext *cx, JS::HandleObject proxy, JS::HandleId id, JS::ObjectOpResult &result) const {
+  return result.failCantDelete();
+}
+
+bool PySequenceProxyHandler::isArray(JSContext *cx, JS::HandleObject proxy, JS::IsArrayAnswer *answer) const {
+  *answer = JS::IsArrayAnswer::Array;
+  return true;
+}
+
+bool PySequenceProxyHandler::getBuiltinClass(JSContext *cx, JS::HandleObject proxy, js::ESClass *cls) const {
+  *cls = js::ESClass::Array;
+  return true;
+}
+
+// private
+static bool isInstanceOfABC(PyObject *obj, const char *name, PyObject **abc) {
+  if (!*abc) {
+    PyObject *abcModule = PyImport_ImportModule("collections.abc");
+    if (!abcModule) {
+      PyErr_Clear();
+      return false;
+    }
+    *abc = PyObject_GetAttrString(abcModule, name); // kept for the lifetime of the process
+    Py_DECREF(abcModule);
+    if (!*abc) {
+      PyErr_Clear();
+      return false;
+    }
+  }
+
+  int isInstance = PyObject_IsInstance(obj, *abc);
+  if (isInstance < 0) {
+    PyErr_Clear();
+    return false;
+  }
+  return isInstance;
+}
+
+bool PythonSequence_Check(PyObject *obj) {
+  if (PyTuple_Check(obj) || PyRange_Check(obj)) {
+    return true;
+  }
+
+  // Only a type with item access and no item assignment can be an immutable sequence,
+  // this rules out most objects before the slower ABC checks
+  PySequenceMethods *sequenceMethods = Py_TYPE(obj)->tp_as_sequence;
+  if (sequenceMethods == NULL || sequenceMethods->sq_item == NULL || sequenceMethods->sq_ass_item != NULL) {
+    return false;
+  }
+
+  static PyObject *sequenceABC = NULL;
+  static PyObject *mutableSequenceABC = NULL;
+  return isInstanceOfABC(obj, "Sequence", &sequenceABC) && !isInstanceOfABC(obj, "MutableSequence", &mutableSequenceABC);
+}
@@ -0,0 +1,252 @@
+/**
+ * @file PySetProxyHandler.cc
+ * @brief Struct for creating JS Set-like proxy objects for Python sets and frozensets
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Distributive Corp.
+ *
+ */
+
+
+#include "include/PySetProxyHandler.hh"
+
+#include "include/jsTypeFactory.hh"
+#include "include/pyTypeFactory.hh"
+
+#include <jsapi.h>
+#include <js/Symbol.h>
+
+#include <Python.h>
+
+
+
+const char PySetProxyHandler::family = 0;
+
+
+// private
+/**
+ * @brief Get the Python set behind the `this` proxy, and the first argument as a Python object
+ */
+static bool setAndValue(JSContext *cx, JS::CallArgs &args, PyObject **self, PyObject **value) {
+  JS::RootedObject proxy(cx, JS::ToObject(cx, args.thisv()));
+  if (!proxy) {
+    return false;
+  }
+  *self = JS::GetMaybePtrFromReservedSlot<PyObject>(proxy, PyObjectSlot);
+  *value = pyTypeFactory(cx, args.get(0));
+  if (!*value) {
+    setPyException(cx);
+    return false;
+  }
+  return true;
+}
+
+static bool set_has(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  PyObject *self, *value;
+  if (!setAndValue(cx, args, &self, &value)) return false;
+
+  int found = PySet_Contains(self, value);
+  Py_DECREF(value);
+  if (found < 0) {
+    if (!PyErr_ExceptionMatches(PyExc_TypeError)) {
+      setPyException(cx);
+      return false;
+    }
+    PyErr_Clear(); // a value that can't be hashed, such as a JS object, is never in a Python set
+    found = 0;
+  }
+  args.rval().setBoolean(found);
+  return true;
+}
+
+static bool set_add(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  PyObject *self, *value;
+  if (!setAndValue(cx, args, &self, &value)) return false;
+
+  int result = PySet_Add(self, value);
+  Py_DECREF(value);
+  if (result < 0) {
+    setPyException(cx);
+    return false;
+  }
+  args.rval().set(args.thisv()); // Set.prototype.add returns the Set
+  return true;
+}
+
+static bool set_delete(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  PyObject *self, *value;
+  if (!setAndValue(cx, args, &self, &value)) return false;
+
+  int found = PySet_Discard(self, value);
+  Py_DECREF(value);
+  if (found < 0) {
+    if (!PyErr_ExceptionMatches(PyExc_TypeError)) {
+      setPyException(cx);
+      return false;
+    }
+    PyErr_Clear();
+    found = 0;
+  }
+  args.rval().setBoolean(found);
+  return true;
+}
+
+static bool set_clear(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  JS::RootedObject proxy(cx, JS::ToObject(cx, args.thisv()));
+  if (!proxy) {
+    return false;
+  }
+  PyObject *self = JS::GetMaybePtrFromReservedSlot<PyObject>(proxy, PyObjectSlot);
+  if (PySet_Clear(self) < 0) {
+    setPyException(cx);
+    return false;
+  }
+  args.rval().setUndefined();
+  return true;
+}
+
+static bool set_forEach(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  JS::RootedObject proxy(cx, JS::ToObject(cx, args.thisv()));
+  if (!proxy) {
+    return false;
+  }
+  PyObject *self = JS::GetMaybePtrFromReservedSlot<PyObject>(proxy, PyObjectSlot);
+
+  if (!args.get(0).isObject() || !JS::IsCallable(&args.get(0).toObject())) {
+    JS_ReportErrorASCII(cx, "forEach: callback is not a function");
+    return false;
+  }
+  JS::RootedValue callback(cx, args[0]);
+  JS::RootedValue thisArg(cx, args.get(1));
+
+  // a Python set can't change size while being iterated, so the callback runs over a snapshot of the values
+  PyObject *values = PySequence_Tuple(self);
+  if (!values) {
+    setPyException(cx);
+    return false;
+  }
+
+  JS::RootedValueArray<3> callbackArgs(cx);
+  callbackArgs[2].setObject(*proxy);
+  JS::RootedValue ignoredOutVal(cx);
+  for (Py_ssize_t index = 0; index < PyTuple_GET_SIZE(values); index++) {
+    callbackArgs[0].set(jsTypeFactory(cx, PyTuple_GET_ITEM(values, index)));
+    callbackArgs[1].set(callbackArgs[0]);
+    if (!JS::Call(cx, thisArg, callback, callbackArgs, &ignoredOutVal)) {
+      Py_DECREF(values);
+      return false;
+    }
+  }
+  Py_DECREF(values);
+
+  args.rval().setUndefined();
+  return true;
+}
+
+static bool set_values(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  JS::RootedObject proxy(cx, JS::ToObject(cx, args.thisv()));
+  if (!proxy) {
+    return false;
+  }
+  PyObject *self = JS::GetMaybePtrFromReservedSlot<PyObject>(proxy, PyObjectSlot);
+
+  PyObject *iterator = PyObject_GetIter(self);
+  if (!iterator) {
+    setPyException(cx);
+    return false;
+  }
+  args.rval().set(jsTypeFactory(cx, iterator)); // a proxy for the Python iterator, with `next()` and `[Symbol.iterator]()`
+  Py_DECREF(iterator);
+  return true;
+}
+
+static JSMethodDef set_methods[] = {
+  {"has", set_has, 1},
+  {"forEach", set_forEach, 1},
+  {"values", set_values, 0},
+  {"keys", set_values, 0},
+  {NULL, NULL, 0}
+};
+
+static JSMethodDef mutable_set_methods[] = {
+  {"add", set_add, 1},
+  {"delete", set_delete, 1},
+  {"clear", set_clear, 0},
+  {NULL, NULL, 0}
+};
+
+// private
+static bool defineMethod(JSContext *cx, JSNative call, unsigned nargs, JS::MutableHandle<mozilla::Maybe<JS::PropertyDescriptor>> desc) {
+  JSFunction *newFunction = JS_NewFunction(cx, call, nargs, 0, NULL);
+  if (!newFunction) return false;
+  JS::RootedObject funObj(cx, JS_GetFunctionObject(newFunction));
+  desc.set(mozilla::Some(
+    JS::PropertyDescriptor::Data(
+      JS::ObjectValue(*funObj),
+      {JS::PropertyAttribute::Enumerable}
+    )
+  ));
+  return true;
+}
+
+// private
+static const JSMethodDef *findMethod(JSContext *cx, JSString *name, const JSMethodDef *methods) {
+  for (size_t index = 0; methods[index].name != NULL; index++) {
+    bool isThatFunction;
+    if (JS_StringEqualsAscii(cx, name, methods[index].name, &isThatFunction) && isThatFunction) {
+      return &methods[index];
+    }
+  }
+  return NULL;
+}
+
+bool PySetProxyHandler::getOwnPropertyDescriptor(
+  JSContext *cx, JS::HandleObject proxy, JS::HandleId id,
+  JS::MutableHandle<mozilla::Maybe<JS::PropertyDescriptor>> desc
+) const {
+  PyObject *self = JS::GetMaybePtrFromReservedSlot<PyObject>(proxy, PyObjectSlot);
+
+  if (id.isString()) {
+    // see if we're calling a function
+    const JSMethodDef *method = findMethod(cx, id.toString(), set_methods);
+    if (!method && PySet_Check(self)) { // frozensets are immutable
+      method = findMethod(cx, id.toString(), mutable_set_methods);
+    }
+    if (method) {
+      return defineMethod(cx, method->call, method->nargs, desc);
+    }
+
+    // "size" property
+    bool isSizeProperty;
+    if (JS_StringEqualsLiteral(cx, id.toString(), "size", &isSizeProperty) && isSizeProperty) {
+      desc.set(mozilla::Some(
+        JS::PropertyDescriptor::Data(
+          JS::NumberValue(PySet_GET_SIZE(self))
+        )
+      ));
+      return true;
+    }
+  }
+
+  // symbol property
+  if (id.isSymbol()) {
+    JS::RootedSymbol rootedSymbol(cx, id.toSymbol());
+    if (JS::GetSymbolCode(rootedSymbol) == JS::SymbolCode::iterator) {
+      return defineMethod(cx, set_values, 0, desc);
+    }
+  }
+
+  PyObject *attrName = idToKey(cx, id);
+  PyObject *item = PyObject_GetAttr(self, attrName);
+  if (!item && PyErr_ExceptionMatches(PyExc_AttributeError)) {
+    PyErr_Clear(); // clear error, we will be returning undefined in this case
+  }
+
+  return handleGetOwnPropertyDescriptor(cx, id, desc, item);
+}
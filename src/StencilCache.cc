@@ -0,0 +1,280 @@
+/**
+ * @file StencilCache.cc
+ * @brief An on-disk cache of compiled JS scripts (SpiderMonkey stencils encoded with XDR), keyed by a hash of the source and compile options
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Distributive Corp.
+ *
+ */
+
+#include "include/StencilCache.hh"
+
+#include <jsapi.h>
+#include <js/BuildId.h>
+#include <js/CompilationAndEvaluation.h>
+#include <js/SourceText.h>
+#include <js/Transcoding.h>
+#include <js/experimental/JSStencil.h>
+
+#include <Python.h>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <process.h>
+#else
+#include <dlfcn.h>
+#include <unistd.h>
+#endif
+
+#ifndef PYTHONMONKEY_VERSION
+#define PYTHONMONKEY_VERSION "unknown"
+#endif
+
+std::string StencilCache::directory;
+uint64_t StencilCache::hits = 0;
+uint64_t StencilCache::misses = 0;
+uint64_t StencilCache::writes = 0;
+uint64_t StencilCache::errors = 0;
+
+// private
+// Encoded stencils are only valid for the exact engine that produced them, XDR refuses any other build id
+static std::string engineBuildId;
+
+// private
+/**
+ * @brief Identify the binary SpiderMonkey is linked into (the mozjs shared library, or this module if it is linked statically)
+ * by its path, size and modification time, which change with every build of it, without reading the whole file
+ */
+static std::string engineBinaryId() {
+  std::filesystem::path path;
+#ifdef _WIN32
+  HMODULE module;
+  wchar_t modulePath[MAX_PATH];
+  if (!GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, (LPCWSTR)&JS_GetImplementationVersion, &module) ||
+      GetModuleFileNameW(module, modulePath, MAX_PATH) == 0) {
+    return std::string();
+  }
+  path = modulePath;
+#else
+  Dl_info info;
+  if (!dladdr((void *)&JS_GetImplementationVersion, &info) || !info.dli_fname) {
+    return std::string();
+  }
+  path = info.dli_fname;
+#endif
+  std::error_code error;
+  uintmax_t size = std::filesystem::file_size(path, error);
+  if (error) {
+    return std::string();
+  }
+  std::filesystem::file_time_type mtime = std::filesystem::last_write_time(path, error);
+  if (error) {
+    return std::string();
+  }
+  return path.generic_string() + " " + std::to_string(size) + " " + std::to_string(mtime.time_since_epoch().count());
+}
+
+// private
+static bool getBuildId(JS::BuildIdCharVector *buildId) {
+  return buildId->append(engineBuildId.data(), engineBuildId.size());
+}
+
+void StencilCache::init() {
+  // the PythonMonkey version as well, as the stencils are compiled with the options it sets
+  engineBuildId = std::string("pythonmonkey " PYTHONMONKEY_VERSION " ") + JS_GetImplementationVersion() + " " + engineBinaryId();
+  JS::SetProcessBuildIdOp(getBuildId);
+}
+
+bool StencilCache::setDirectory(PyObject *path) {
+  if (path == Py_None) {
+    directory.clear();
+    return true;
+  }
+
+  PyObject *fsPath = PyOS_FSPath(path); // str or os.PathLike
+  if (!fsPath) {
+    return false;
+  }
+  PyObject *encodedPath;
+  if (!PyUnicode_FSConverter(fsPath, &encodedPath)) {
+    Py_DECREF(fsPath);
+    return false;
+  }
+  Py_DECREF(fsPath);
+  std::string newDirectory(PyBytes_AS_STRING(encodedPath), PyBytes_GET_SIZE(encodedPath));
+  Py_DECREF(encodedPath);
+
+  std::error_code error;
+  std::filesystem::create_directories(newDirectory, error);
+  if (error) {
+    PyErr_Format(PyExc_OSError, "could not create the compile cache directory %s: %s", newDirectory.c_str(), error.message().c_str());
+    return false;
+  }
+  directory = newDirectory;
+  return true;
+}
+
+PyObject *StencilCache::stats() {
+  PyObject *directoryValue = enabled() ? PyUnicode_DecodeFSDefault(directory.c_str()) : (Py_INCREF(Py_None), Py_None);
+  if (!directoryValue) {
+    return NULL;
+  }
+  return Py_BuildValue("{s:N,s:K,s:K,s:K,s:K}",
+    "directory", directoryValue,
+    "hits", (unsigned long long)hits,
+    "misses", (unsigned long long)misses,
+    "writes", (unsigned long long)writes,
+    "errors", (unsigned long long)errors
+  );
+}
+
+bool StencilCache::cachePath(const JS::ReadOnlyCompileOptions &options, const char *chars, size_t length, std::string &path) {
+  JS::BuildIdCharVector buildId;
+  if (!getBuildId(&buildId)) {
+    return false;
+  }
+
+  // everything that changes the compiled code, the filename and position are baked into the stencil for stack traces
+  const char *filename = options.filename().c_str();
+  std::string header(buildId.begin(), buildId.length());
+  header += '\0';
+  header += filename ? filename : "";
+  header += '\0';
+  header += std::to_string(options.lineno) + ':' + std::to_string(options.column.oneOriginValue());
+  header += options.mutedErrors() ? 'm' : '-';
+  header += options.noScriptRval ? 'n' : '-';
+  header += options.forceStrictMode() ? 's' : '-';
+  header += options.isRunOnce ? 'o' : '-';
+  header += '\0';
+
+  PyObject *hashlib = PyImport_ImportModule("hashlib");
+  if (!hashlib) {
+    return false;
+  }
+  PyObject *hash = PyObject_CallMethod(hashlib, "sha256", "y#", header.data(), (Py_ssize_t)header.size());
+  Py_DECREF(hashlib);
+  if (!hash) {
+    return false;
+  }
+  PyObject *source = PyMemoryView_FromMemory((char *)chars, length, PyBUF_READ); // hashed in place, no copy of the source text
+  PyObject *updated = source ? PyObject_CallMethod(hash, "update", "O", source) : NULL;
+  Py_XDECREF(source);
+  Py_XDECREF(updated);
+  PyObject *digest = updated ? PyObject_CallMethod(hash, "hexdigest", NULL) : NULL;
+  Py_DECREF(hash);
+  if (!digest) {
+    return false;
+  }
+
+  path = directory;
+  path += '/';
+  path += PyUnicode_AsUTF8(digest);
+  path += ".stencil";
+  Py_DECREF(digest);
+  return true;
+}
+
+// private
+static bool readCacheFile(const std::string &path, std::vector<uint8_t> &data) {
+  FILE *file = fopen(path.c_str(), "rb");
+  if (!file) {
+    return false;
+  }
+  bool ok = fseek(file, 0, SEEK_END) == 0;
+  long size = ok ? ftell(file) : -1;
+  ok = size > 0 && fseek(file, 0, SEEK_SET) == 0;
+  if (ok) {
+    data.resize(size);
+    ok = fread(data.data(), 1, size, file) == (size_t)size;
+  }
+  fclose(file);
+  return ok;
+}
+
+// private
+static bool writeCacheFile(const std::string &path, const JS::TranscodeBuffer &buffer) {
+  // written aside then renamed, so concurrent processes never read a partial file
+  // the pid keeps the names of concurrent writers apart, the counter those of the same process
+  static uint64_t tmpCount = 0;
+#ifdef _WIN32
+  int pid = _getpid();
+#else
+  pid_t pid = getpid();
+#endif
+  std::string tmpPath = path + ".tmp" + std::to_string(pid) + "-" + std::to_string(++tmpCount);
+  FILE *file = fopen(tmpPath.c_str(), "wb");
+  if (!file) {
+    return false;
+  }
+  bool ok = fwrite(buffer.begin(), 1, buffer.length(), file) == buffer.length();
+  ok = fclose(file) == 0 && ok;
+  if (ok) {
+    std::error_code error;
+    std::filesystem::rename(tmpPath, path, error);
+    ok = !error;
+  }
+  if (!ok) {
+    std::remove(tmpPath.c_str());
+  }
+  return ok;
+}
+
+already_AddRefed<JS::Stencil> StencilCache::getStencil(JSContext *cx, const JS::ReadOnlyCompileOptions &options, const char *chars, size_t length) {
+  std::string path;
+  if (enabled() && !cachePath(options, chars, length, path)) {
+    PyErr_Clear();
+    errors++;
+    path.clear();
+  }
+
+  if (!path.empty()) {
+    std::vector<uint8_t> data;
+    if (readCacheFile(path, data)) {
+      JS::DecodeOptions decodeOptions(options);
+      JS::TranscodeRange range(data.data(), data.size());
+      JS::Stencil *stencil = nullptr;
+      if (JS::DecodeStencil(cx, decodeOptions, range, &stencil) == JS::TranscodeResult::Ok) {
+        hits++;
+        return already_AddRefed<JS::Stencil>(stencil);
+      }
+      JS_ClearPendingException(cx); // corrupt or from another engine, recompile and overwrite it
+      errors++;
+    }
+    misses++;
+  }
+
+  JS::SourceText<mozilla::Utf8Unit> source;
+  if (!source.init(cx, chars, length, JS::SourceOwnership::Borrowed)) {
+    return nullptr;
+  }
+  RefPtr<JS::Stencil> stencil = JS::CompileGlobalScriptToStencil(cx, options, source);
+  if (!stencil) {
+    return nullptr;
+  }
+
+  if (!path.empty()) {
+    JS::TranscodeBuffer buffer;
+    if (JS::EncodeStencil(cx, stencil, buffer) == JS::TranscodeResult::Ok && writeCacheFile(path, buffer)) {
+      writes++;
+    } else {
+      JS_ClearPendingException(cx);
+      errors++;
+    }
+  }
+  return stencil.forget();
+}
+
+JSScript *StencilCache::compile(JSContext *cx, const JS::ReadOnlyCompileOptions &options, const char *chars, size_t length) {
+  RefPtr<JS::Stencil> stencil = getStencil(cx, options, chars, length);
+  if (!stencil) {
+    return nullptr;
+  }
+  JS::InstantiateOptions instantiateOptions(options);
+  return JS::InstantiateGlobalStencil(cx, instantiateOptions, stencil);
+}
@@ -0,0 +1,344 @@
+/**
+ * @file TimerWheel.cc
+ * @brief A hierarchical timer wheel for JS timers (setTimeout/setInterval), driven by a single asyncio `call_at`
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Distributive Corp.
+ *
+ */
+
+#include "include/TimerWheel.hh"
+
+#include <Python.h>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+using AsyncHandle = PyEventLoop::AsyncHandle;
+
+// private
+static bool isLive(AsyncHandle::id_t timeoutID) {
+  AsyncHandle *handle = AsyncHandle::fromId(timeoutID);
+  return handle && !handle->cancelled();
+}
+
+TimerWheel::TimerWheel(PyObject *loop) : _loop(loop) {
+  static PyMethodDef fireDef = {"timerWheelFire", TimerWheel::fire, METH_NOARGS, NULL};
+
+  Py_INCREF(_loop);
+  PyObject *wheelPtr = PyLong_FromVoidPtr(this);
+  _fireCallback = PyCFunction_New(&fireDef, wheelPtr);
+  Py_DECREF(wheelPtr);
+  _now = currentTick(); // sets the Python error indicator on failure, checked by `forLoop`
+}
+
+TimerWheel::~TimerWheel() {
+  for (auto &level: _levels) {
+    for (Bucket &bucket: level) {
+      for (Entry &entry: bucket) {
+        Py_DECREF(entry.jobFn);
+      }
+    }
+  }
+  Py_XDECREF(_armedHandle);
+  Py_XDECREF(_fireCallback);
+  Py_DECREF(_loop);
+}
+
+/* static */
+TimerWheel *TimerWheel::forLoop(PyObject *loop) {
+  for (TimerWheel *wheel: _wheels) {
+    if (wheel->_loop == loop) {
+      return wheel;
+    }
+  }
+
+  // Drop the wheels of closed event-loops, their timers can never fire
+  _wheels.erase(std::remove_if(_wheels.begin(), _wheels.end(), [](TimerWheel *wheel) {
+    PyObject *closed = PyObject_CallMethod(wheel->_loop, "is_closed", NULL);
+    bool isClosed = closed == Py_True;
+    Py_XDECREF(closed);
+    PyErr_Clear();
+    if (isClosed) {
+      delete wheel;
+    }
+    return isClosed;
+  }), _wheels.end());
+
+  TimerWheel *wheel = new TimerWheel(loop);
+  if (PyErr_Occurred()) {
+    delete wheel;
+    return nullptr;
+  }
+  _wheels.push_back(wheel);
+  return wheel;
+}
+
+uint64_t TimerWheel::currentTick() {
+  // https://docs.python.org/3/library/asyncio-eventloop.html#asyncio.loop.time
+  PyObject *time = PyObject_CallMethod(_loop, "time", NULL);
+  if (!time) {
+    return UINT64_MAX;
+  }
+  double seconds = PyFloat_AsDouble(time);
+  Py_DECREF(time);
+  if (seconds < 0) { // -1.0 on error
+    return UINT64_MAX;
+  }
+  return (uint64_t)(seconds * 1000);
+}
+
+bool TimerWheel::schedule(id_t timeoutID, PyObject *jobFn, double delaySeconds, bool repeat) {
+  uint64_t now = currentTick();
+  if (now == UINT64_MAX) {
+    return false;
+  }
+  if (_size == 0 && now > _now) {
+    _now = now; // nothing to process in between
+  }
+
+  // `Infinity` and huge delays are clamped to the span of the wheel (about 49 days) before rounding, NaN fails `> 0`
+  double clampedMs = delaySeconds > 0 ? std::min(delaySeconds * 1000, (double)MAX_DELTA) : 0;
+  uint64_t delayMs = (uint64_t)std::llround(clampedMs);
+  Py_INCREF(jobFn);
+  insert(Entry{timeoutID, now + delayMs, delayMs, repeat, jobFn});
+  AsyncHandle::fromId(timeoutID)->setTimerScheduled(true);
+
+  sweep();
+  return arm();
+}
+
+void TimerWheel::insert(Entry &&entry) {
+  if (entry.deadline <= _now) {
+    entry.deadline = _now + 1; // already expired, fire on the next tick
+  }
+
+  // Timers further away than the wheel can hold are placed at its far end, and cascaded again from there
+  uint64_t placed = entry.deadline - _now > MAX_DELTA ? _now + MAX_DELTA : entry.deadline;
+  uint64_t delta = placed - _now;
+  unsigned level = 0;
+  while (level + 1 < LEVELS && delta >= (uint64_t(1) << ((level + 1) * SLOT_BITS))) {
+    level++;
+  }
+
+  _levels[level][(placed >> (level * SLOT_BITS)) & SLOT_MASK].push_back(std::move(entry));
+  _levelSizes[level]++;
+  _size++;
+}
+
+void TimerWheel::cascade(unsigned level, uint64_t tick) {
+  Bucket bucket;
+  std::swap(bucket, _levels[level][(tick >> (level * SLOT_BITS)) & SLOT_MASK]);
+  _levelSizes[level] -= bucket.size();
+  _size -= bucket.size();
+
+  // the timers are now close enough to go down a level (or more)
+  for (Entry &entry: bucket) {
+    if (entry.deadline <= tick) { // due right now, fired along with the level 0 slot of this tick
+      _levels[0][tick & SLOT_MASK].push_back(std::move(entry));
+      _levelSizes[0]++;
+      _size++;
+    } else {
+      insert(std::move(entry));
+    }
+  }
+}
+
+void TimerWheel::advanceTo(uint64_t target, std::vector<Entry> &expired) {
+  while (_now < target) {
+    unsigned lowest = 0;
+    while (lowest < LEVELS && _levelSizes[lowest] == 0) {
+      lowest++;
+    }
+    if (lowest == LEVELS) { // the wheel is empty
+      _now = target;
+      break;
+    }
+
+    // Nothing fires or cascades before the next boundary of the lowest non-empty level, skip to it
+    if (lowest > 0) {
+      uint64_t skipTo = _now | ((uint64_t(1) << (lowest * SLOT_BITS)) - 1);
+      if (skipTo >= target) {
+        _now = target;
+        break;
+      }
+      _now = skipTo;
+    }
+    _now++;
+
+    // Cascade the timers of the higher levels whose slot starts at this tick, the highest level first
+    unsigned top = 0;
+    while (top + 1 < LEVELS && (_now & ((uint64_t(1) << ((top + 1) * SLOT_BITS)) - 1)) == 0) {
+      top++;
+    }
+    for (unsigned level = top; level >= 1; level--) {
+      cascade(level, _now);
+    }
+
+    // All timers due at this tick are fired together
+    Bucket bucket;
+    std::swap(bucket, _levels[0][_now & SLOT_MASK]);
+    _levelSizes[0] -= bucket.size();
+    _size -= bucket.size();
+    for (Entry &entry: bucket) {
+      expired.push_back(std::move(entry));
+    }
+  }
+}
+
+bool TimerWheel::runTimer(Entry &entry) {
+  AsyncHandle *handle = AsyncHandle::fromId(entry.timeoutID);
+  if (!handle || handle->cancelled()) { // cleared before expiring
+    Py_DECREF(entry.jobFn);
+    return true;
+  }
+  handle->setTimerScheduled(false); // like a popped `asyncio.TimerHandle`, the timer counts as finished while its job runs
+
+  PyObject *ret = PyObject_CallObject(entry.jobFn, NULL); // jobFn()
+  Py_XDECREF(ret); // don't care about its return value
+
+  PyObject *errType, *errValue, *traceback; // we can't call any Python code unless the error indicator is clear
+  PyErr_Fetch(&errType, &errValue, &traceback);
+  // The job function may have called `clearTimeout` on its own timer, which releases the timer
+  handle = AsyncHandle::fromId(entry.timeoutID);
+  if (handle && entry.repeat && !handle->cancelled()) {
+    entry.deadline = _now + entry.intervalMs;
+    handle->setTimerScheduled(true);
+    insert(std::move(entry));
+  } else {
+    if (handle) {
+      handle->removeRef();
+      AsyncHandle::releaseId(entry.timeoutID);
+    }
+    Py_DECREF(entry.jobFn);
+  }
+
+  if (errType != NULL) { // PyErr_Occurred()
+    PyErr_Restore(errType, errValue, traceback);
+    return false;
+  }
+  return true;
+}
+
+uint64_t TimerWheel::nextWakeUp() const {
+  uint64_t next = UINT64_MAX;
+
+  if (_levelSizes[0] > 0) {
+    for (uint64_t tick = _now + 1; tick <= _now + SLOTS; tick++) {
+      if (!_levels[0][tick & SLOT_MASK].empty()) {
+        next = tick;
+        break;
+      }
+    }
+  }
+
+  // Timers on higher levels expire no sooner than their slot gets cascaded
+  for (unsigned level = 1; level < LEVELS; level++) {
+    if (_levelSizes[level] == 0) continue;
+
+    unsigned shift = level * SLOT_BITS;
+    for (uint64_t slot = (_now >> shift) + 1; slot <= (_now >> shift) + SLOTS; slot++) {
+      uint64_t cascadeTick = slot << shift;
+      if (cascadeTick >= next) break;
+      if (!_levels[level][slot & SLOT_MASK].empty()) {
+        next = cascadeTick;
+        break;
+      }
+    }
+  }
+
+  return next;
+}
+
+bool TimerWheel::arm() {
+  uint64_t next = nextWakeUp();
+  if (_armedHandle && _armedTick <= next) {
+    return true; // the event-loop calls us soon enough
+  }
+
+  if (_armedHandle) {
+    // https://docs.python.org/3/library/asyncio-eventloop.html#asyncio.Handle.cancel
+    Py_XDECREF(PyObject_CallMethod(_armedHandle, "cancel", NULL));
+    Py_CLEAR(_armedHandle);
+    _armedTick = UINT64_MAX;
+  }
+  if (next == UINT64_MAX) {
+    return true; // no timers
+  }
+
+  // https://docs.python.org/3/library/asyncio-eventloop.html#asyncio.loop.call_at
+  _armedHandle = PyObject_CallMethod(_loop, "call_at", "dO", (double)next / 1000, _fireCallback);
+  if (!_armedHandle) {
+    return false;
+  }
+  _armedTick = next;
+  return true;
+}
+
+void TimerWheel::sweep() {
+  if (_size < _sweepThreshold) {
+    return;
+  }
+
+  // Cleared timers stay in the wheel until it reaches them, drop them before they pile up
+  for (unsigned level = 0; level < LEVELS; level++) {
+    for (Bucket &bucket: _levels[level]) {
+      auto end = std::remove_if(bucket.begin(), bucket.end(), [](const Entry &entry) {
+        if (isLive(entry.timeoutID)) {
+          return false;
+        }
+        Py_DECREF(entry.jobFn);
+        return true;
+      });
+      size_t removed = bucket.end() - end;
+      bucket.erase(end, bucket.end());
+      _levelSizes[level] -= removed;
+      _size -= removed;
+    }
+  }
+  _sweepThreshold = std::max<size_t>(1024, 2 * _size);
+}
+
+/* static */
+PyObject *TimerWheel::fire(PyObject *wheelPtr, PyObject *Py_UNUSED(unused)) {
+  TimerWheel *wheel = (TimerWheel *)PyLong_AsVoidPtr(wheelPtr);
+
+  // `call_at` may run us up to the clock resolution early, the armed tick is due nonetheless
+  uint64_t now = wheel->currentTick();
+  if (now == UINT64_MAX) {
+    PyErr_Clear();
+    now = wheel->_now;
+  }
+  uint64_t target = wheel->_armedTick == UINT64_MAX ? now : std::max(now, wheel->_armedTick);
+  Py_CLEAR(wheel->_armedHandle);
+  wheel->_armedTick = UINT64_MAX;
+
+  std::vector<Entry> expired;
+  wheel->advanceTo(target, expired);
+
+  size_t index = 0;
+  bool success = true;
+  while (index < expired.size()) {
+    success = wheel->runTimer(expired[index++]);
+    if (!success) break;
+  }
+
+  // A job threw: report the error through the event-loop, and run the rest of the expired timers on the next tick
+  PyObject *errType, *errValue, *traceback;
+  PyErr_Fetch(&errType, &errValue, &traceback);
+  for (; index < expired.size(); index++) {
+    wheel->insert(std::move(expired[index]));
+  }
+  bool armed = wheel->arm();
+
+  if (!success) {
+    PyErr_Clear();
+    PyErr_Restore(errType, errValue, traceback);
+    return NULL;
+  }
+  if (!armed) {
+    return NULL;
+  }
+  Py_RETURN_NONE;
+}
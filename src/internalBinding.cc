@@ -10,24 +10,69 @@
 #include "include/pyTypeFactory.hh"
 
 #include <jsapi.h>
+#include <jsfriendapi.h>
 #include <js/String.h>
 #include <Python.h>
 
+#include <string>
+#include <unordered_map>
+
+// private
+// Every internalBinding namespace, a native binding is added by listing its JSFunctionSpec[] here
+static const InternalBinding::Namespace namespaces[] = {
+  {"utils", InternalBinding::utils},
+  {"timers", InternalBinding::timers},
+  {"fs", InternalBinding::fs},
+};
+
+// private
+// The reserved slot of the `internalBinding` function holding the namespace objects it has built, by name
+static const size_t NAMESPACE_CACHE_SLOT = 0;
+
 JSObject *createInternalBindingsForNamespace(JSContext *cx, JSFunctionSpec *methodSpecs) {
   JS::RootedObject namespaceObj(cx, JS_NewObjectWithGivenProto(cx, nullptr, nullptr)); // namespaceObj = Object.create(null)
   if (!JS_DefineFunctions(cx, namespaceObj, methodSpecs)) { return nullptr; }
   return namespaceObj;
 }
 
-// TODO (Tom Tang): figure out a better way to register InternalBindings to namespace
-JSObject *getInternalBindingsByNamespace(JSContext *cx, JSLinearString *namespaceStr) {
-  if (JS_LinearStringEqualsLiteral(namespaceStr, "utils")) {
-    return createInternalBindingsForNamespace(cx, InternalBinding::utils);
-  } else if (JS_LinearStringEqualsLiteral(namespaceStr, "timers")) {
-    return createInternalBindingsForNamespace(cx, InternalBinding::timers);
-  } else { // not found
+JSFunctionSpec *findInternalBindingNamespace(const std::string &name) {
+  static const std::unordered_map<std::string, JSFunctionSpec *> registry = [] {
+    std::unordered_map<std::string, JSFunctionSpec *> byName;
+    for (const InternalBinding::Namespace &ns : namespaces) {
+      byName.emplace(ns.name, ns.methods);
+    }
+    return byName;
+  }();
+  auto found = registry.find(name);
+  return found == registry.end() ? nullptr : found->second;
+}
+
+JSObject *getInternalBindingsByNamespace(JSContext *cx, JS::HandleObject cache, JS::HandleString namespaceStr) {
+  JS::RootedId id(cx);
+  if (!JS_StringToId(cx, namespaceStr, &id)) {
+    return nullptr;
+  }
+  JS::RootedValue cached(cx);
+  if (!JS_GetPropertyById(cx, cache, id, &cached)) {
+    return nullptr;
+  }
+  if (cached.isObject()) {
+    return &cached.toObject();
+  }
+
+  JS::UniqueChars name = JS_EncodeStringToUTF8(cx, namespaceStr);
+  if (!name) {
     return nullptr;
   }
+  JSFunctionSpec *methodSpecs = findInternalBindingNamespace(name.get());
+  if (!methodSpecs) { // not found
+    return nullptr;
+  }
+  JS::RootedObject namespaceObj(cx, createInternalBindingsForNamespace(cx, methodSpecs));
+  if (!namespaceObj || !JS_DefinePropertyById(cx, cache, id, namespaceObj, JSPROP_READONLY | JSPROP_PERMANENT)) {
+    return nullptr;
+  }
+  return namespaceObj;
 }
 
 /**
@@ -37,18 +82,29 @@ static bool internalBindingFn(JSContext *cx, unsigned argc, JS::Value *vp) {
   JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
 
   // Get the `namespace` argument as string
-  JS::HandleValue namespaceStrArg = args.get(0);
-  JSLinearString *namespaceStr = JS_EnsureLinearString(cx, namespaceStrArg.toString());
+  JS::RootedString namespaceStr(cx, args.get(0).toString());
 
-  args.rval().setObjectOrNull(getInternalBindingsByNamespace(cx, namespaceStr));
-  return true;
+  // The namespaces built by this `internalBinding` function, so each of them is built once per global
+  JS::RootedObject cache(cx, &js::GetFunctionNativeReserved(&args.callee(), NAMESPACE_CACHE_SLOT).toObject());
+
+  args.rval().setObjectOrNull(getInternalBindingsByNamespace(cx, cache, namespaceStr));
+  return !JS_IsExceptionPending(cx);
 }
 
 /**
  * @brief Create the JS `internalBinding` function
  */
 JSFunction *createInternalBinding(JSContext *cx) {
-  return JS_NewFunction(cx, internalBindingFn, 1, 0, "internalBinding");
+  JS::RootedObject cache(cx, JS_NewObjectWithGivenProto(cx, nullptr, nullptr));
+  if (!cache) {
+    return nullptr;
+  }
+  JSFunction *fn = js::NewFunctionWithReserved(cx, internalBindingFn, 1, 0, "internalBinding");
+  if (!fn) {
+    return nullptr;
+  }
+  js::SetFunctionNativeReserved(JS_GetFunctionObject(fn), NAMESPACE_CACHE_SLOT, JS::ObjectValue(*cache));
+  return fn;
 }
 
 /**
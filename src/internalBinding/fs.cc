@@ -0,0 +1,523 @@
+/**
+ * @file fs.cc
+ * @brief Implement functions in `internalBinding("fs")`, the file system access of the CommonJS module loader
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Distributive Corp.
+ */
+
+#include "include/internalBinding.hh"
+#include "include/MappedFile.hh"
+#include "include/registerAtFork.hh"
+
+#include <jsapi.h>
+#include <js/Array.h>
+#include <js/String.h>
+
+#include <Python.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <sys/stat.h>
+
+/**
+ * See function declarations in python/pythonmonkey/builtin_modules/internal-binding.d.ts :
+ *    `declare function internalBinding(namespace: "fs")`
+ */
+
+// private
+// Resolving a module probes many paths that don't exist (every extension, in every node_modules directory),
+// and probes them again for the next module. A miss is trusted while its directory is unmodified, as creating,
+// renaming or deleting a file modifies the directory, and within a resolution each directory is only checked once.
+static constexpr size_t NEGATIVE_CACHE_MAX_ENTRIES = 16384;
+
+// private
+// A directory modified this recently may be modified again without its mtime changing, on file systems with coarse timestamps
+static constexpr std::chrono::seconds NEGATIVE_CACHE_RACY_INTERVAL(2);
+
+// private
+struct DirectoryState {
+  bool found;
+  std::filesystem::file_time_type mtime;
+};
+
+// private
+static std::unordered_map<std::string, DirectoryState> missingPaths; // path => the state of its directory when it was missing
+static std::unordered_map<std::string, DirectoryState> resolutionDirectories; // only used while `resolutionDepth > 0`
+static unsigned resolutionDepth = 0;
+
+// private
+static constexpr size_t PREFETCH_THREAD_COUNT = 4;
+
+// private
+// Prefetched files wait in memory until the module loader reads them, bigger files are left to be read on demand
+static constexpr size_t PREFETCH_MAX_FILE_SIZE = 1024 * 1024;
+static constexpr size_t PREFETCH_MAX_BYTES = 16 * 1024 * 1024;
+
+// private
+struct PrefetchedFile {
+  std::string contents;
+  std::filesystem::file_time_type mtime;
+};
+
+// private
+// The prefetch threads only touch these, under `prefetchLock`
+static std::mutex prefetchLock;
+static std::deque<std::vector<std::string>> prefetchQueue; // candidate paths of a module, the first one found is read
+static std::unordered_map<std::string, PrefetchedFile> prefetchedFiles;
+static size_t prefetchedBytes = 0;
+static size_t prefetchThreads = 0;
+static size_t prefetchInFlight = 0; // groups taken off the queue and still being read
+static uint64_t prefetchHits = 0; // reads served from memory
+
+// private
+static std::unordered_set<std::string> prefetchRequested; // the first candidate path of every group ever queued
+
+// private
+/**
+ * @brief The filesystem path of a UTF-8 path. A narrow path would be in the ANSI code page on Windows, the wide (UTF-16) one is used there instead.
+ */
+static std::filesystem::path nativePath(const std::string &path) {
+  return std::filesystem::path(std::u8string(path.begin(), path.end()));
+}
+
+// private
+static std::string utf8Path(const std::filesystem::path &path) {
+  std::u8string chars = path.u8string();
+  return std::string(chars.begin(), chars.end());
+}
+
+// private
+/**
+ * @brief A path argument, in UTF-8, normalized like `os.path.normpath`: `.` and `..` segments and repeated separators are collapsed,
+ * and a trailing separator is dropped. The caches are keyed by the normalized path.
+ */
+static bool pathArgument(JSContext *cx, JS::HandleValue arg, std::string &path) {
+  JS::RootedString pathString(cx, JS::ToString(cx, arg));
+  if (!pathString) {
+    return false;
+  }
+  JS::UniqueChars pathChars = JS_EncodeStringToUTF8(cx, pathString);
+  if (!pathChars) {
+    return false;
+  }
+  std::filesystem::path normalPath = nativePath(pathChars.get()).lexically_normal();
+  if (normalPath.has_relative_path() && !normalPath.has_filename()) {
+    normalPath = normalPath.parent_path(); // "dir/"
+  }
+  path = normalPath.empty() ? "." : utf8Path(normalPath);
+  return true;
+}
+
+// private
+static std::filesystem::file_time_type lastWriteTime(const std::string &path, bool *found) {
+  std::error_code error;
+  std::filesystem::file_time_type mtime = std::filesystem::last_write_time(nativePath(path), error);
+  *found = !error;
+  return mtime;
+}
+
+// private
+/**
+ * @brief The mtime of the directory of a path, checked once per resolution
+ */
+static DirectoryState directoryOf(const std::string &path) {
+  std::string directory = utf8Path(nativePath(path).parent_path());
+  if (directory.empty()) {
+    directory = "."; // a relative path without a directory
+  }
+  if (resolutionDepth > 0) {
+    auto known = resolutionDirectories.find(directory);
+    if (known != resolutionDirectories.end()) {
+      return known->second;
+    }
+  }
+  DirectoryState state;
+  state.mtime = lastWriteTime(directory, &state.found);
+  if (resolutionDepth > 0) {
+    resolutionDirectories[directory] = state;
+  }
+  return state;
+}
+
+// private
+static bool isKnownMissing(const std::string &path) {
+  auto missing = missingPaths.find(path);
+  if (missing == missingPaths.end()) {
+    return false;
+  }
+  DirectoryState directory = directoryOf(path);
+  if (directory.found != missing->second.found || (directory.found && directory.mtime != missing->second.mtime)) {
+    missingPaths.erase(missing);
+    return false;
+  }
+  return true;
+}
+
+// private
+static void rememberMissing(const std::string &path) {
+  DirectoryState directory = directoryOf(path);
+  if (directory.found && std::filesystem::file_time_type::clock::now() - directory.mtime < NEGATIVE_CACHE_RACY_INTERVAL) {
+    return;
+  }
+  if (missingPaths.size() >= NEGATIVE_CACHE_MAX_ENTRIES) {
+    missingPaths.clear();
+  }
+  missingPaths[path] = directory;
+}
+
+// private
+/**
+ * @brief stat(2) a path through the negative lookup cache
+ *
+ * @return false if the path doesn't exist
+ */
+static bool statPath(const std::string &path, unsigned *mode) {
+  if (isKnownMissing(path)) {
+    return false;
+  }
+#ifdef _WIN32
+  struct _stat64 sb;
+  bool found = _wstat64(nativePath(path).c_str(), &sb) == 0;
+#else
+  struct stat sb;
+  bool found = stat(path.c_str(), &sb) == 0;
+#endif
+  if (!found) {
+    rememberMissing(path);
+    return false;
+  }
+  *mode = sb.st_mode;
+  return true;
+}
+
+// private
+static void beginResolution() {
+  resolutionDepth++;
+}
+
+// private
+static void endResolution() {
+  if (resolutionDepth > 0 && --resolutionDepth == 0) {
+    resolutionDirectories.clear();
+  }
+}
+
+// private
+/**
+ * @brief Read a whole regular file into `contents`, on a prefetch thread
+ */
+static bool readWholeFile(const std::string &path, std::string &contents, std::filesystem::file_time_type *mtime) {
+  std::error_code error;
+  std::filesystem::path filePath = nativePath(path);
+  if (!std::filesystem::is_regular_file(filePath, error)) {
+    return false;
+  }
+  uintmax_t size = std::filesystem::file_size(filePath, error);
+  bool found;
+  *mtime = lastWriteTime(path, &found); // taken before reading, so a concurrent write is seen as a change
+  if (error || !found || size > PREFETCH_MAX_FILE_SIZE) {
+    return false;
+  }
+#ifdef _WIN32
+  FILE *file = _wfopen(filePath.c_str(), L"rb");
+#else
+  FILE *file = fopen(filePath.c_str(), "rb");
+#endif
+  if (!file) {
+    return false;
+  }
+  contents.resize(size);
+  bool ok = fread(contents.data(), 1, size, file) == size;
+  fclose(file);
+  return ok;
+}
+
+// private
+static void prefetchThreadMain() {
+  std::unique_lock<std::mutex> lock(prefetchLock);
+  while (!prefetchQueue.empty()) {
+    std::vector<std::string> candidates = std::move(prefetchQueue.front());
+    prefetchQueue.pop_front();
+    prefetchInFlight++;
+    lock.unlock();
+    std::string foundPath;
+    PrefetchedFile file;
+    for (const std::string &path : candidates) {
+      if (readWholeFile(path, file.contents, &file.mtime)) {
+        foundPath = path;
+        break;
+      }
+    }
+    lock.lock();
+    if (!foundPath.empty() && prefetchedBytes + file.contents.size() <= PREFETCH_MAX_BYTES && !prefetchedFiles.count(foundPath)) {
+      prefetchedBytes += file.contents.size();
+      prefetchedFiles.emplace(std::move(foundPath), std::move(file));
+    }
+    prefetchInFlight--;
+  }
+  prefetchThreads--;
+}
+
+// private
+/**
+ * @brief Take the prefetched contents of a file, if it has not been modified since
+ *
+ * @return false if the file was not prefetched
+ */
+static bool takePrefetchedFile(const std::string &path, std::string &contents) {
+  std::unique_lock<std::mutex> lock(prefetchLock);
+  if (prefetchedFiles.empty()) {
+    return false;
+  }
+  auto prefetched = prefetchedFiles.find(path);
+  if (prefetched == prefetchedFiles.end()) {
+    return false;
+  }
+  PrefetchedFile file = std::move(prefetched->second);
+  prefetchedFiles.erase(prefetched);
+  prefetchedBytes -= file.contents.size();
+  lock.unlock();
+
+  bool found;
+  if (lastWriteTime(path, &found) != file.mtime || !found) {
+    return false;
+  }
+  contents = std::move(file.contents);
+  prefetchHits++;
+  return true;
+}
+
+// private
+/**
+ * @brief The prefetch threads don't survive `os.fork()`, and one of them may have held `prefetchLock` in the middle of
+ * changing the queue or the prefetched files. The child starts over with a new lock and empty state, the old state is leaked.
+ */
+static PyObject *afterForkInChild(PyObject *Py_UNUSED(self), PyObject *Py_UNUSED(_)) {
+  new (&prefetchLock) std::mutex();
+  new (&prefetchQueue) std::deque<std::vector<std::string>>();
+  new (&prefetchedFiles) std::unordered_map<std::string, PrefetchedFile>();
+  prefetchedBytes = 0;
+  prefetchThreads = 0;
+  prefetchInFlight = 0;
+  prefetchRequested.clear(); // so the dropped groups can be queued again
+  Py_RETURN_NONE;
+}
+
+// private
+/**
+ * @brief Register `afterForkInChild` with `os.register_at_fork`, once, before the first prefetch thread starts
+ */
+static bool registerForkHandler() {
+  static bool registered = false;
+  if (!registered) {
+    registered = registerAfterForkInChild(afterForkInChild);
+  }
+  return registered;
+}
+
+static bool statFile(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  std::string path;
+  if (!pathArgument(cx, args.get(0), path)) {
+    return false;
+  }
+  unsigned mode;
+  if (statPath(path, &mode)) {
+    args.rval().setNumber(mode);
+  } else {
+    args.rval().setUndefined();
+  }
+  return true;
+}
+
+static bool exists(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  std::string path;
+  if (!pathArgument(cx, args.get(0), path)) {
+    return false;
+  }
+  unsigned mode;
+  args.rval().setBoolean(statPath(path, &mode));
+  return true;
+}
+
+static bool readFile(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  std::string path;
+  if (!pathArgument(cx, args.get(0), path)) {
+    return false;
+  }
+  // decoded straight from the file bytes into a Latin-1 or two-byte JS string
+  JSString *contents;
+  std::string prefetchedContents;
+  MappedFile file;
+  if (takePrefetchedFile(path, prefetchedContents)) {
+    contents = JS_NewStringCopyUTF8N(cx, JS::UTF8Chars(prefetchedContents.data(), prefetchedContents.size()));
+  } else if (!isKnownMissing(path) && file.open(path.c_str())) {
+    contents = JS_NewStringCopyUTF8N(cx, JS::UTF8Chars(file.data(), file.size()));
+  } else {
+    PyErr_Clear(); // the JS side throws the ENOENT error
+    args.rval().setUndefined();
+    return true;
+  }
+  if (!contents) {
+    return false;
+  }
+  args.rval().setString(contents);
+  return true;
+}
+
+static bool mtime(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  std::string path;
+  if (!pathArgument(cx, args.get(0), path)) {
+    return false;
+  }
+  bool found;
+  std::filesystem::file_time_type time = lastWriteTime(path, &found);
+  if (found) {
+    // only ever compared for equality, the clock and the unit of file_time_type don't matter
+    args.rval().setNumber((double)time.time_since_epoch().count());
+  } else {
+    args.rval().setUndefined();
+  }
+  return true;
+}
+
+static bool prefetch(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  args.rval().setUndefined();
+  if (!args.get(0).isObject()) {
+    return true;
+  }
+  JS::RootedObject groups(cx, &args.get(0).toObject());
+  uint32_t groupCount = 0;
+  if (!JS::GetArrayLength(cx, groups, &groupCount)) {
+    return false;
+  }
+
+  std::vector<std::vector<std::string>> jobs;
+  JS::RootedValue group(cx);
+  JS::RootedValue candidate(cx);
+  beginResolution(); // the candidates share their directories
+  for (uint32_t i = 0; i < groupCount; i++) {
+    uint32_t candidateCount = 0;
+    if (!JS_GetElement(cx, groups, i, &group)) {
+      endResolution();
+      return false;
+    }
+    if (!group.isObject()) {
+      continue;
+    }
+    JS::RootedObject groupObj(cx, &group.toObject());
+    if (!JS::GetArrayLength(cx, groupObj, &candidateCount)) {
+      endResolution();
+      return false;
+    }
+    std::vector<std::string> candidates;
+    for (uint32_t j = 0; j < candidateCount; j++) {
+      std::string path;
+      if (!JS_GetElement(cx, groupObj, j, &candidate) || !pathArgument(cx, candidate, path)) {
+        endResolution();
+        return false;
+      }
+      if (!isKnownMissing(path)) {
+        candidates.push_back(std::move(path));
+      }
+    }
+    if (!candidates.empty() && prefetchRequested.insert(candidates[0]).second) {
+      jobs.push_back(std::move(candidates));
+    }
+  }
+  endResolution();
+
+  if (!jobs.empty()) {
+    if (!registerForkHandler()) {
+      PyErr_Clear(); // not worth failing the require() for, the files are read on demand instead
+      return true;
+    }
+    std::lock_guard<std::mutex> lock(prefetchLock);
+    for (std::vector<std::string> &job : jobs) {
+      prefetchQueue.push_back(std::move(job));
+    }
+    while (prefetchThreads < PREFETCH_THREAD_COUNT && prefetchThreads < prefetchQueue.size()) {
+      prefetchThreads++;
+      std::thread(prefetchThreadMain).detach();
+    }
+  }
+  return true;
+}
+
+static bool prefetchStats(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  size_t pending, prefetched;
+  uint64_t hits;
+  {
+    std::lock_guard<std::mutex> lock(prefetchLock);
+    pending = prefetchQueue.size() + prefetchInFlight;
+    prefetched = prefetchedFiles.size();
+    hits = prefetchHits;
+  }
+  JS::RootedObject stats(cx, JS_NewPlainObject(cx));
+  if (!stats ||
+      !JS_DefineProperty(cx, stats, "pending", (double)pending, JSPROP_ENUMERATE) ||
+      !JS_DefineProperty(cx, stats, "prefetched", (double)prefetched, JSPROP_ENUMERATE) ||
+      !JS_DefineProperty(cx, stats, "hits", (double)hits, JSPROP_ENUMERATE)) {
+    return false;
+  }
+  args.rval().setObject(*stats);
+  return true;
+}
+
+static bool beginResolutionBinding(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  beginResolution();
+  args.rval().setUndefined();
+  return true;
+}
+
+static bool endResolutionBinding(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  endResolution();
+  args.rval().setUndefined();
+  return true;
+}
+
+static bool clearCache(JSContext *cx, unsigned argc, JS::Value *vp) {
+  JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+  missingPaths.clear();
+  resolutionDirectories.clear();
+  prefetchRequested.clear();
+  {
+    std::lock_guard<std::mutex> lock(prefetchLock);
+    prefetchedFiles.clear();
+    prefetchedBytes = 0;
+  }
+  args.rval().setUndefined();
+  return true;
+}
+
+JSFunctionSpec InternalBinding::fs[] = {
+  JS_FN("stat", statFile, 1, 0),
+  JS_FN("exists", exists, 1, 0),
+  JS_FN("readFile", readFile, 1, 0),
+  JS_FN("mtime", mtime, 1, 0),
+  JS_FN("prefetch", prefetch, 1, 0),
+  JS_FN("prefetchStats", prefetchStats, 0, 0),
+  JS_FN("beginResolution", beginResolutionBinding, 0, 0),
+  JS_FN("endResolution", endResolutionBinding, 0, 0),
+  JS_FN("clearCache", clearCache, 0, 0),
+  JS_FS_END
+};
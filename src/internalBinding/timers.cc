@@ -22,6 +22,17 @@ using AsyncHandle = PyEventLoop::AsyncHandle;
  *    `declare function internalBinding(namespace: "timers")`
  */
 
+/**
+ * @brief Convert a `timeoutID` argument, any number that can't be a `timeoutID` (negative, fractional, NaN...) becomes 0, which is never one
+ */
+static AsyncHandle::id_t toTimeoutID(JS::HandleValue value) {
+  double number = value.toNumber();
+  if (!(number >= 0 && number < 9007199254740992.0 /* 2^53 */) || number != (double)(AsyncHandle::id_t)number) {
+    return 0;
+  }
+  return (AsyncHandle::id_t)number;
+}
+
 static bool enqueueWithDelay(JSContext *cx, unsigned argc, JS::Value *vp) {
   if (PyErr_Occurred() && PyErr_ExceptionMatches(PyExc_SystemExit)) {
      // quit, exit or sys.exit was called (and raised SystemExit)
@@ -48,34 +59,40 @@ static bool enqueueWithDelay(JSContext *cx, unsigned argc, JS::Value *vp) {
   handle->setDebugInfo(pyTypeFactory(cx, debugInfo));
 
   // Return the `timeoutID` to use in `clearTimeout`
-  args.rval().setNumber(handleId);
+  args.rval().setNumber((double)handleId);
   return true;
 }
 
 static bool cancelByTimeoutId(JSContext *cx, unsigned argc, JS::Value *vp) {
   JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
-  double timeoutID = args.get(0).toNumber();
+  AsyncHandle::id_t timeoutID = toTimeoutID(args.get(0));
 
   args.rval().setUndefined();
 
   // Retrieve the AsyncHandle by `timeoutID`
-  AsyncHandle *handle = AsyncHandle::fromId((uint32_t)timeoutID);
+  AsyncHandle *handle = AsyncHandle::fromId(timeoutID);
   if (!handle) return true; // does nothing on invalid timeoutID
 
   // Cancel this job on the Python event-loop
   handle->cancel();
   handle->removeRef();
 
+  // The timer can no longer run, its slot can be reused
+  AsyncHandle::releaseId(timeoutID);
+
   return true;
 }
 
 static bool timerHasRef(JSContext *cx, unsigned argc, JS::Value *vp) {
   JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
-  double timeoutID = args.get(0).toNumber();
+  AsyncHandle::id_t timeoutID = toTimeoutID(args.get(0));
 
   // Retrieve the AsyncHandle by `timeoutID`
-  AsyncHandle *handle = AsyncHandle::fromId((uint32_t)timeoutID);
-  if (!handle) return false; // error no such timeoutID
+  AsyncHandle *handle = AsyncHandle::fromId(timeoutID);
+  if (!handle) { // the timer has finished or been cancelled
+    args.rval().setBoolean(false);
+    return true;
+  }
 
   args.rval().setBoolean(handle->hasRef());
   return true;
@@ -83,39 +100,42 @@ static bool timerHasRef(JSContext *cx, unsigned argc, JS::Value *vp) {
 
 static bool timerAddRef(JSContext *cx, unsigned argc, JS::Value *vp) {
   JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
-  double timeoutID = args.get(0).toNumber();
+  AsyncHandle::id_t timeoutID = toTimeoutID(args.get(0));
+
+  args.rval().setUndefined();
 
   // Retrieve the AsyncHandle by `timeoutID`
-  AsyncHandle *handle = AsyncHandle::fromId((uint32_t)timeoutID);
-  if (!handle) return false; // error no such timeoutID
+  AsyncHandle *handle = AsyncHandle::fromId(timeoutID);
+  if (!handle) return true; // does nothing if the timer has finished or been cancelled
 
   handle->addRef();
-
-  args.rval().setUndefined();
   return true;
 }
 
 static bool timerRemoveRef(JSContext *cx, unsigned argc, JS::Value *vp) {
   JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
-  double timeoutID = args.get(0).toNumber();
+  AsyncHandle::id_t timeoutID = toTimeoutID(args.get(0));
+
+  args.rval().setUndefined();
 
   // Retrieve the AsyncHandle by `timeoutID`
-  AsyncHandle *handle = AsyncHandle::fromId((uint32_t)timeoutID);
-  if (!handle) return false; // error no such timeoutID
+  AsyncHandle *handle = AsyncHandle::fromId(timeoutID);
+  if (!handle) return true; // does nothing if the timer has finished or been cancelled
 
   handle->removeRef();
-
-  args.rval().setUndefined();
   return true;
 }
 
 static bool getDebugInfo(JSContext *cx, unsigned argc, JS::Value *vp) {
   JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
-  double timeoutID = args.get(0).toNumber();
+  AsyncHandle::id_t timeoutID = toTimeoutID(args.get(0));
 
   // Retrieve the AsyncHandle by `timeoutID`
-  AsyncHandle *handle = AsyncHandle::fromId((uint32_t)timeoutID);
-  if (!handle) return false; // error no such timeoutID
+  AsyncHandle *handle = AsyncHandle::fromId(timeoutID);
+  if (!handle) { // the timer has finished or been cancelled
+    args.rval().setUndefined();
+    return true;
+  }
 
   JS::Value debugInfo = jsTypeFactory(cx, handle->getDebugInfo());
   args.rval().set(debugInfo);
@@ -126,10 +146,10 @@ static bool getAllRefedTimersDebugInfo(JSContext *cx, unsigned argc, JS::Value *
   JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
 
   JS::RootedVector<JS::Value> results(cx);
-  for (AsyncHandle &timer: AsyncHandle::getAllTimers()) {
-    if (!timer.hasRef()) continue; // we only need ref'ed timers
+  for (AsyncHandle *timer: AsyncHandle::getAllTimers()) {
+    if (!timer->hasRef()) continue; // we only need ref'ed timers
 
-    JS::Value debugInfo = jsTypeFactory(cx, timer.getDebugInfo());
+    JS::Value debugInfo = jsTypeFactory(cx, timer->getDebugInfo());
     if (!results.append(debugInfo)) {
       // out of memory
       setSpiderMonkeyException(cx);
@@ -15,11 +15,16 @@
 #include "include/JSMethodProxy.hh"
 #include "include/JSObjectProxy.hh"
 #include "include/JSArrayProxy.hh"
+#include "include/JSMapProxy.hh"
+#include "include/JSSetProxy.hh"
 #include "include/PyDictProxyHandler.hh"
 #include "include/JSStringProxy.hh"
 #include "include/PyListProxyHandler.hh"
 #include "include/PyObjectProxyHandler.hh"
 #include "include/PyIterableProxyHandler.hh"
+#include "include/PyAsyncIterableProxyHandler.hh"
+#include "include/PySetProxyHandler.hh"
+#include "include/PySequenceProxyHandler.hh"
 #include "include/pyTypeFactory.hh"
 #include "include/IntType.hh"
 #include "include/PromiseType.hh"
@@ -49,6 +54,9 @@ static PyDictProxyHandler pyDictProxyHandler;
 static PyObjectProxyHandler pyObjectProxyHandler;
 static PyListProxyHandler pyListProxyHandler;
 static PyIterableProxyHandler pyIterableProxyHandler;
+static PyAsyncIterableProxyHandler pyAsyncIterableProxyHandler;
+static PySetProxyHandler pySetProxyHandler;
+static PySequenceProxyHandler pySequenceProxyHandler;
 
 std::unordered_map<PyObject *, size_t> externalStringObjToRefCountMap; // a map of python string objects to the number of JSExternalStrings that depend on it, used when finalizing JSExternalStrings
 
@@ -263,6 +271,12 @@ JS::Value jsTypeFactory(JSContext *cx, PyObject *object) {
   else if (PyObject_TypeCheck(object, &JSArrayProxyType)) {
     returnType.setObject(**((JSArrayProxy *)object)->jsArray);
   }
+  else if (PyObject_TypeCheck(object, &JSMapProxyType)) {
+    returnType.setObject(**((JSMapProxy *)object)->jsMap);
+  }
+  else if (PyObject_TypeCheck(object, &JSSetProxyType)) {
+    returnType.setObject(**((JSSetProxy *)object)->jsSet);
+  }
   else if (PyDict_Check(object) || PyList_Check(object)) {
     JS::RootedValue v(cx);
     JSObject *proxy;
@@ -279,6 +293,24 @@ JS::Value jsTypeFactory(JSContext *cx, PyObject *object) {
     JS::SetReservedSlot(proxy, PyObjectSlot, JS::PrivateValue(object));
     returnType.setObject(*proxy);
   }
+  else if (PyAnySet_Check(object)) {
+    JS::RootedValue v(cx);
+    JS::RootedObject setPrototype(cx);
+    JS_GetClassPrototype(cx, JSProto_Set, &setPrototype); // so that instanceof will work, not that prototype methods will
+    JSObject *proxy = js::NewProxyObject(cx, &pySetProxyHandler, v, setPrototype.get());
+    Py_INCREF(object);
+    JS::SetReservedSlot(proxy, PyObjectSlot, JS::PrivateValue(object));
+    returnType.setObject(*proxy);
+  }
+  else if (PythonSequence_Check(object)) {
+    JS::RootedValue v(cx);
+    JS::RootedObject arrayPrototype(cx);
+    JS_GetClassPrototype(cx, JSProto_Array, &arrayPrototype); // Array.prototype methods are generic, they work through `length` and indexes
+    JSObject *proxy = js::NewProxyObject(cx, &pySequenceProxyHandler, v, arrayPrototype.get());
+    Py_INCREF(object);
+    JS::SetReservedSlot(proxy, PyObjectSlot, JS::PrivateValue(object));
+    returnType.setObject(*proxy);
+  }
   else if (object == Py_None) {
     returnType.setUndefined();
   }
@@ -298,6 +330,15 @@ JS::Value jsTypeFactory(JSContext *cx, PyObject *object) {
     JS::SetReservedSlot(proxy, PyObjectSlot, JS::PrivateValue(iterable));
     returnType.setObject(*proxy);
   }
+  else if (PythonAsyncIterable_Check(object)) {
+    JS::RootedValue v(cx);
+    JS::RootedObject objectPrototype(cx);
+    JS_GetClassPrototype(cx, JSProto_Object, &objectPrototype); // so that instanceof will work, not that prototype methods will
+    JSObject *proxy = js::NewProxyObject(cx, &pyAsyncIterableProxyHandler, v, objectPrototype.get());
+    Py_INCREF(object); // the original object, so it round-trips; `__aiter__()` is called by `[Symbol.asyncIterator]()`
+    JS::SetReservedSlot(proxy, PyObjectSlot, JS::PrivateValue(object));
+    returnType.setObject(*proxy);
+  }
   else {
     JS::RootedValue v(cx);
     JS::RootedObject objectPrototype(cx);
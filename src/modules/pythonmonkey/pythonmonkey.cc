@@ -13,16 +13,23 @@
 #include "include/setSpiderMonkeyException.hh"
 #include "include/JSFunctionProxy.hh"
 #include "include/JSMethodProxy.hh"
+#include "include/JSPromiseProxy.hh"
 #include "include/JSArrayIterProxy.hh"
 #include "include/JSArrayProxy.hh"
+#include "include/JSMapProxy.hh"
 #include "include/JSObjectIterProxy.hh"
 #include "include/JSObjectKeysProxy.hh"
 #include "include/JSObjectValuesProxy.hh"
 #include "include/JSObjectItemsProxy.hh"
 #include "include/JSObjectProxy.hh"
+#include "include/JSSetProxy.hh"
 #include "include/JSStringProxy.hh"
 #include "include/pyTypeFactory.hh"
 #include "include/PyEventLoop.hh"
+#include "include/StencilCache.hh"
+#include "include/MappedFile.hh"
+#include "include/HelperThreadPool.hh"
+#include "include/ModuleLoader.hh"
 #include "include/internalBinding.hh"
 
 #include <jsapi.h>
@@ -46,6 +53,7 @@
 #include <unordered_map>
 #include <vector>
 #include <cassert>
+#include <string>
 
 JS::PersistentRootedObject jsFunctionRegistry;
 
@@ -155,6 +163,17 @@ PyTypeObject JSObjectProxyType = {
   .tp_base = &PyDict_Type
 };
 
+PyTypeObject JSObjectAsyncIterableProxyType = {
+  .ob_base = PyVarObject_HEAD_INIT(NULL, 0)
+  .tp_name = "pythonmonkey.JSObjectAsyncIterableProxy",
+  .tp_basicsize = sizeof(JSObjectProxy),
+  .tp_itemsize = 0,
+  .tp_as_async = &JSObjectProxy_async_methods,
+  .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_DICT_SUBCLASS | Py_TPFLAGS_HAVE_GC,
+  .tp_doc = PyDoc_STR("Javascript async iterable Object proxy dict, usable in `async for`"),
+  .tp_base = &JSObjectProxyType
+};
+
 PyTypeObject JSStringProxyType = {
   .tp_name = PyUnicode_Type.tp_name,
   .tp_basicsize = sizeof(JSStringProxy),
@@ -187,6 +206,24 @@ PyTypeObject JSMethodProxyType = {
   .tp_new = JSMethodProxyMethodDefinitions::JSMethodProxy_new
 };
 
+PyTypeObject JSPromiseProxyType = {
+  .ob_base = PyVarObject_HEAD_INIT(NULL, 0)
+  .tp_name = "pythonmonkey.JSPromiseProxy",
+  .tp_basicsize = sizeof(JSPromiseProxy),
+  .tp_dealloc = (destructor)JSPromiseProxyMethodDefinitions::JSPromiseProxy_dealloc,
+  .tp_as_async = &JSPromiseProxy_async_methods,
+  .tp_repr = (reprfunc)JSPromiseProxyMethodDefinitions::JSPromiseProxy_repr,
+  .tp_getattro = PyObject_GenericGetAttr,
+  .tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,
+  .tp_doc = PyDoc_STR("Javascript Promise proxy, awaitable like an asyncio.Future"),
+  .tp_traverse = (traverseproc)JSPromiseProxyMethodDefinitions::JSPromiseProxy_traverse,
+  .tp_clear = (inquiry)JSPromiseProxyMethodDefinitions::JSPromiseProxy_clear,
+  .tp_iter = (getiterfunc)JSPromiseProxyMethodDefinitions::JSPromiseProxy_await,
+  .tp_iternext = (iternextfunc)JSPromiseProxyMethodDefinitions::JSPromiseProxy_iternext,
+  .tp_methods = JSPromiseProxy_methods,
+  .tp_getset = JSPromiseProxy_getset
+};
+
 PyTypeObject JSArrayProxyType = {
   .ob_base = PyVarObject_HEAD_INIT(NULL, 0)
   .tp_name = PyList_Type.tp_name,
@@ -207,6 +244,51 @@ PyTypeObject JSArrayProxyType = {
   .tp_base = &PyList_Type
 };
 
+PyTypeObject JSMapProxyType = {
+  .ob_base = PyVarObject_HEAD_INIT(NULL, 0)
+  .tp_name = "pythonmonkey.JSMapProxy",
+  .tp_basicsize = sizeof(JSMapProxy),
+  .tp_dealloc = (destructor)JSMapProxyMethodDefinitions::JSMapProxy_dealloc,
+  .tp_repr = (reprfunc)JSMapProxyMethodDefinitions::JSMapProxy_repr,
+  .tp_as_sequence = &JSMapProxy_sequence_methods,
+  .tp_as_mapping = &JSMapProxy_mapping_methods,
+  .tp_hash = PyObject_HashNotImplemented,
+  .tp_getattro = PyObject_GenericGetAttr,
+  .tp_flags = Py_TPFLAGS_DEFAULT,
+  .tp_doc = PyDoc_STR("Javascript Map proxy, a collections.abc.MutableMapping"),
+  .tp_richcompare = (richcmpfunc)JSMapProxyMethodDefinitions::JSMapProxy_richcompare,
+  .tp_iter = (getiterfunc)JSMapProxyMethodDefinitions::JSMapProxy_iter,
+  .tp_methods = JSMapProxy_methods
+};
+
+PyTypeObject JSSetProxyType = {
+  .ob_base = PyVarObject_HEAD_INIT(NULL, 0)
+  .tp_name = "pythonmonkey.JSSetProxy",
+  .tp_basicsize = sizeof(JSSetProxy),
+  .tp_dealloc = (destructor)JSSetProxyMethodDefinitions::JSSetProxy_dealloc,
+  .tp_repr = (reprfunc)JSSetProxyMethodDefinitions::JSSetProxy_repr,
+  .tp_as_number = &JSSetProxy_number_methods,
+  .tp_as_sequence = &JSSetProxy_sequence_methods,
+  .tp_hash = PyObject_HashNotImplemented,
+  .tp_getattro = PyObject_GenericGetAttr,
+  .tp_flags = Py_TPFLAGS_DEFAULT,
+  .tp_doc = PyDoc_STR("Javascript Set proxy, a collections.abc.MutableSet"),
+  .tp_richcompare = (richcmpfunc)JSSetProxyMethodDefinitions::JSSetProxy_richcompare,
+  .tp_iter = (getiterfunc)JSSetProxyMethodDefinitions::JSSetProxy_iter,
+  .tp_methods = JSSetProxy_methods
+};
+
+PyTypeObject CompiledScriptType = {
+  .ob_base = PyVarObject_HEAD_INIT(NULL, 0)
+  .tp_name = "pythonmonkey.CompiledScript",
+  .tp_basicsize = sizeof(CompiledScript),
+  .tp_dealloc = (destructor)CompiledScriptMethodDefinitions::CompiledScript_dealloc,
+  .tp_repr = (reprfunc)CompiledScriptMethodDefinitions::CompiledScript_repr,
+  .tp_getattro = PyObject_GenericGetAttr,
+  .tp_flags = Py_TPFLAGS_DEFAULT,
+  .tp_doc = PyDoc_STR("A compiled Javascript script, run it with pythonmonkey.run()"),
+};
+
 PyTypeObject JSArrayIterProxyType = {
   .ob_base = PyVarObject_HEAD_INIT(NULL, 0)
   .tp_name = PyListIter_Type.tp_name,
@@ -308,6 +390,7 @@ static void cleanup() {
   Py_XDECREF(PythonMonkey_BigInt);
 
   // Clean up SpiderMonkey
+  ModuleLoader::clear();
   delete autoRealm;
   delete global;
   if (GLOBAL_CX) {
@@ -368,9 +451,121 @@ static bool getEvalOption(PyObject *evalOptions, const char *optionName, bool *b
   return value != NULL && value != Py_None;
 }
 
+/**
+ * @brief Execute a compiled script in the global scope, and convert the value of its last expression
+ */
+static PyObject *executeScript(JS::HandleScript script) {
+  JS::Rooted<JS::Value> rval(GLOBAL_CX);
+
+  // execute the compiled code; last expr goes to rval
+  if (!JS_ExecuteScript(GLOBAL_CX, script, &rval)) {
+    setSpiderMonkeyException(GLOBAL_CX);
+    return NULL;
+  }
+
+  // translate to the proper python type
+  PyObject *returnValue = pyTypeFactory(GLOBAL_CX, rval);
+  if (PyErr_Occurred()) {
+    return NULL;
+  }
+
+  if (returnValue) {
+    return returnValue;
+  }
+  else {
+    Py_RETURN_NONE;
+  }
+}
+
+// private
+/**
+ * @brief The source code argument of eval, as UTF-8 bytes in place wherever possible:
+ * a str's UTF-8 representation, the buffer of a bytes-like object, or a memory mapping of a file.
+ * Only a file that can't be mapped, such as a pipe, is left to be read as a stream.
+ */
+struct EvalSource {
+  const char *chars = nullptr;
+  size_t length = 0;
+  FILE *stream = nullptr;
+  std::string path; // the default filename of a path source
+  Py_buffer buffer = {};
+  MappedFile mappedFile;
+
+  ~EvalSource() {
+    if (buffer.obj) {
+      PyBuffer_Release(&buffer);
+    }
+    if (stream) {
+      fclose(stream);
+    }
+  }
+
+  /**
+   * @return success, or false with the Python error indicator set
+   */
+  bool init(PyObject *arg) {
+    if (PyUnicode_Check(arg)) {
+      Py_ssize_t codeLength;
+      chars = PyUnicode_AsUTF8AndSize(arg, &codeLength); // no copy for an ASCII str
+      length = codeLength;
+      return chars != NULL;
+    }
+
+    if (PyObject_CheckBuffer(arg)) { // bytes, bytearray, memoryview, mmap...
+      if (PyObject_GetBuffer(arg, &buffer, PyBUF_SIMPLE) < 0) {
+        return false;
+      }
+      chars = (const char *)buffer.buf;
+      length = buffer.len;
+      return true;
+    }
+
+    if (PyObject_HasAttrString(arg, "__fspath__")) { // os.PathLike, a str is source code rather than a path
+      PyObject *fsPath = PyOS_FSPath(arg);
+      PyObject *encodedPath;
+      if (!fsPath || !PyUnicode_FSConverter(fsPath, &encodedPath)) {
+        Py_XDECREF(fsPath);
+        return false;
+      }
+      Py_DECREF(fsPath);
+      path.assign(PyBytes_AS_STRING(encodedPath), PyBytes_GET_SIZE(encodedPath));
+      Py_DECREF(encodedPath);
+      if (!mappedFile.open(path.c_str())) {
+        return false;
+      }
+      chars = mappedFile.data();
+      length = mappedFile.size();
+      return true;
+    }
+
+    int fd = PyObject_AsFileDescriptor(arg); // an open file
+    if (fd == -1) {
+      PyErr_SetString(PyExc_TypeError, "pythonmonkey.eval expects a string, a bytes-like object, a path or an open file as its first argument");
+      return false;
+    }
+    if (mappedFile.map(fd)) {
+      chars = mappedFile.data();
+      length = mappedFile.size();
+      return true;
+    }
+    // Not a regular file. Open a stream with a dup of the underlying fd, so that closing the stream leaves the file open
+    int fd2 = dup(fd);
+    stream = fd2 == -1 ? NULL : fdopen(fd2, "rb");
+    if (!stream) {
+      if (fd2 != -1) {
+        close(fd2);
+      }
+      PyErr_SetString(PyExc_TypeError, "error opening file stream");
+      return false;
+    }
+    return true;
+  }
+};
+
 /**
  * Implement the pythonmonkey.eval function. From Python-land, that function has the following API:
- * argument 0 - unicode string of JS code or open file containing JS code in UTF-8
+ * argument 0 - JS code, either as a unicode string, a bytes-like object of UTF-8, an os.PathLike or an open file of UTF-8.
+ *              Paths and regular files are memory-mapped rather than read into a buffer.
  * argument 1 - a Dict of options which roughly correspond to the jsapi CompileOptions. A novel option,
  *              fromPythonFrame, sets the filename and line offset according to the pm.eval call in the
  *              Python source code. This allows us to embed non-trivial JS inside Python source files
@@ -383,44 +578,29 @@ static PyObject *eval(PyObject *self, PyObject *args) {
     return NULL;
   }
 
-  PyObject *code = NULL;
-  FILE *file = NULL;
   PyObject *arg0 = PyTuple_GetItem(args, 0);
   PyObject *arg1 = argc == 2 ? PyTuple_GetItem(args, 1) : NULL;
 
-  if (PyUnicode_Check(arg0)) {
-    code = arg0;
-  } else if (1 /*PyFile_Check(arg0)*/) {
-    /* First argument is an open file. Open a stream with a dup of the underlying fd (so we can fclose
-     * the stream later). Future: seek to current Python file position IFF the fd is for a real file.
-     */
-    int fd = PyObject_AsFileDescriptor(arg0);
-    int fd2 = fd == -1 ? -1 : dup(fd);
-    file = fd2 == -1 ? NULL : fdopen(fd, "rb");
-    if (!file) {
-      PyErr_SetString(PyExc_TypeError, "error opening file stream");
-      return NULL;
-    }
-  } else {
-    PyErr_SetString(PyExc_TypeError, "pythonmonkey.eval expects either a string or an open file as its first argument");
-    return NULL;
-  }
-
   PyObject *evalOptions = argc == 2 ? arg1 : NULL;
   if (evalOptions && !PyDict_Check(evalOptions)) {
     PyErr_SetString(PyExc_TypeError, "pythonmonkey.eval expects a dict as its second argument");
-    if (file)
-      fclose(file);
+    return NULL;
+  }
+
+  EvalSource code;
+  if (!code.init(arg0)) {
     return NULL;
   }
 
   // initialize JS context
   JSAutoRealm ar(GLOBAL_CX, *global);
   JS::CompileOptions options (GLOBAL_CX);
-  options.setFileAndLine("evaluate", 1)
+  options.setFileAndLine(code.path.empty() ? "evaluate" : code.path.c_str(), 1)
   .setIsRunOnce(true)
   .setNoScriptRval(false)
   .setIntroductionType("pythonmonkey eval");
+  bool useCache = false;
+  bool isModule = false;
 
   if (evalOptions) {
     const char *s;
@@ -434,7 +614,8 @@ static PyObject *eval(PyObject *self, PyObject *args) {
     if (getEvalOption(evalOptions, "noScriptRval", &b)) options.setNoScriptRval(b);
     if (getEvalOption(evalOptions, "selfHosting", &b)) options.setSelfHostingMode(b);
     if (getEvalOption(evalOptions, "strict", &b)) if (b) options.setForceStrictMode();
-    if (getEvalOption(evalOptions, "module", &b)) if (b) options.setModule();
+    if (getEvalOption(evalOptions, "module", &b)) isModule = b;
+    if (getEvalOption(evalOptions, "cache", &b)) useCache = b && StencilCache::enabled() && !options.selfHostingMode; // only plain global scripts are cached
 
     if (getEvalOption(evalOptions, "fromPythonFrame", &b) && b) {
 #if PY_VERSION_HEX >= 0x03090000
@@ -459,22 +640,45 @@ static PyObject *eval(PyObject *self, PyObject *args) {
     } /* fromPythonFrame */
   } /* eval options */
 
+  if (isModule) {
+    std::string contents;
+    if (!code.chars) {
+      char chunk[65536];
+      size_t chunkLength;
+      while ((chunkLength = fread(chunk, 1, sizeof(chunk), code.stream)) > 0) {
+        contents.append(chunk, chunkLength);
+      }
+      code.chars = contents.data();
+      code.length = contents.size();
+    }
+    options.setIsRunOnce(false);
+    return ModuleLoader::evalModule(GLOBAL_CX, options, code.chars, code.length);
+  }
+
   // compile the code to execute
   JS::RootedScript script(GLOBAL_CX);
-  JS::Rooted<JS::Value> rval(GLOBAL_CX);
-  if (code) {
+  if (code.chars) {
     JS::SourceText<mozilla::Utf8Unit> source;
-    Py_ssize_t codeLength;
-    const char *codeChars = PyUnicode_AsUTF8AndSize(code, &codeLength);
-    if (!source.init(GLOBAL_CX, codeChars, codeLength, JS::SourceOwnership::Borrowed)) {
+    if (useCache) {
+      script = StencilCache::compile(GLOBAL_CX, options, code.chars, code.length);
+    } else if (!source.init(GLOBAL_CX, code.chars, code.length, JS::SourceOwnership::Borrowed)) {
       setSpiderMonkeyException(GLOBAL_CX);
       return NULL;
+    } else {
+      script = JS::Compile(GLOBAL_CX, options, source);
     }
-    script = JS::Compile(GLOBAL_CX, options, source);
+  } else if (useCache) {
+    assert(code.stream);
+    std::string contents; // the cache key is a hash of the whole source, so the stream is read up front
+    char chunk[65536];
+    size_t chunkLength;
+    while ((chunkLength = fread(chunk, 1, sizeof(chunk), code.stream)) > 0) {
+      contents.append(chunk, chunkLength);
+    }
+    script = StencilCache::compile(GLOBAL_CX, options, contents.data(), contents.size());
   } else {
-    assert(file);
-    script = JS::CompileUtf8File(GLOBAL_CX, options, file);
-    fclose(file);
+    assert(code.stream);
+    script = JS::CompileUtf8File(GLOBAL_CX, options, code.stream);
   }
 
   if (!script) {
@@ -482,24 +686,178 @@ static PyObject *eval(PyObject *self, PyObject *args) {
     return NULL;
   }
 
-  // execute the compiled code; last expr goes to rval
-  if (!JS_ExecuteScript(GLOBAL_CX, script, &rval)) {
+  return executeScript(script);
+}
+
+/**
+ * @brief Read the filename, lineno, column, mutedErrors, noScriptRval and strict options of eval into `settings`
+ *
+ * @return false with the Python error indicator set if an option has the wrong type
+ */
+static bool getCompiledScriptSettings(PyObject *evalOptions, CompiledScriptSettings &settings) {
+  const char *s;
+  unsigned long l;
+  bool b;
+
+  if (getEvalOption(evalOptions, "filename", &s)) settings.filename = s;
+  if (getEvalOption(evalOptions, "lineno", &l)) settings.lineno = l;
+  if (getEvalOption(evalOptions, "column", &l)) settings.column = l;
+  if (getEvalOption(evalOptions, "mutedErrors", &b)) settings.mutedErrors = b;
+  if (getEvalOption(evalOptions, "noScriptRval", &b)) settings.noScriptRval = b;
+  if (getEvalOption(evalOptions, "strict", &b)) settings.strict = b;
+  return !PyErr_Occurred();
+}
+
+/**
+ * Implement the pythonmonkey.compile function. From Python-land, that function has the following API:
+ * argument 0 - unicode string of JS code
+ * argument 1 - a Dict of options, the filename, lineno, column, mutedErrors, noScriptRval, strict and cache options of eval
+ * returns a CompiledScript, which pythonmonkey.run executes any number of times without parsing the code again
+ */
+static PyObject *compile(PyObject *self, PyObject *args) {
+  PyObject *code;
+  PyObject *evalOptions = NULL;
+  if (!PyArg_ParseTuple(args, "U|O!:compile", &code, &PyDict_Type, &evalOptions)) {
+    return NULL;
+  }
+
+  CompiledScriptSettings settings;
+  bool useCache = false;
+  if (evalOptions) {
+    if (!getCompiledScriptSettings(evalOptions, settings)) {
+      return NULL;
+    }
+    bool b;
+    if (getEvalOption(evalOptions, "cache", &b)) useCache = b && StencilCache::enabled();
+  }
+
+  JSAutoRealm ar(GLOBAL_CX, *global);
+  return CompiledScriptMethodDefinitions::compile(GLOBAL_CX, code, settings, useCache);
+}
+
+/**
+ * Implement the pythonmonkey.compileFunction function. From Python-land, that function has the following API:
+ * argument 0 - a sequence of the parameter names, as unicode strings
+ * argument 1 - unicode string of the JS function body
+ * argument 2 - a Dict of options, the name of the function and the filename, lineno, column, mutedErrors and strict options of eval
+ * returns the compiled JS function, callable from Python
+ */
+static PyObject *compileFunction(PyObject *self, PyObject *args) {
+  PyObject *argNames;
+  PyObject *body;
+  PyObject *evalOptions = NULL;
+  if (!PyArg_ParseTuple(args, "OU|O!:compileFunction", &argNames, &body, &PyDict_Type, &evalOptions)) {
+    return NULL;
+  }
+
+  CompiledScriptSettings settings;
+  const char *name = NULL;
+  if (evalOptions) {
+    if (!getCompiledScriptSettings(evalOptions, settings)) {
+      return NULL;
+    }
+    getEvalOption(evalOptions, "name", &name);
+    if (PyErr_Occurred()) {
+      return NULL;
+    }
+  }
+
+  PyObject *argNamesSeq = PySequence_Fast(argNames, "pythonmonkey.compileFunction expects a sequence of argument names");
+  if (!argNamesSeq) {
+    return NULL;
+  }
+  Py_ssize_t nargs = PySequence_Fast_GET_SIZE(argNamesSeq);
+  std::vector<const char *> argNamesUtf8(nargs);
+  for (Py_ssize_t i = 0; i < nargs; i++) {
+    PyObject *argName = PySequence_Fast_GET_ITEM(argNamesSeq, i);
+    if (!PyUnicode_Check(argName)) {
+      PyErr_SetString(PyExc_TypeError, "pythonmonkey.compileFunction expects the argument names to be strings");
+      Py_DECREF(argNamesSeq);
+      return NULL;
+    }
+    argNamesUtf8[i] = PyUnicode_AsUTF8(argName); // kept alive by argNamesSeq
+    if (!argNamesUtf8[i]) {
+      Py_DECREF(argNamesSeq);
+      return NULL;
+    }
+  }
+
+  Py_ssize_t bodyLength;
+  const char *bodyUtf8 = PyUnicode_AsUTF8AndSize(body, &bodyLength);
+  if (!bodyUtf8) {
+    Py_DECREF(argNamesSeq);
+    return NULL;
+  }
+
+  JSAutoRealm ar(GLOBAL_CX, *global);
+  JS::CompileOptions options(GLOBAL_CX);
+  settings.apply(options);
+  JS::SourceText<mozilla::Utf8Unit> source;
+  JS::RootedObjectVector emptyScopeChain(GLOBAL_CX);
+  JSFunction *fun = NULL;
+  if (source.init(GLOBAL_CX, bodyUtf8, bodyLength, JS::SourceOwnership::Borrowed)) {
+    fun = JS::CompileFunction(GLOBAL_CX, emptyScopeChain, options, name, (unsigned)nargs, argNamesUtf8.data(), source);
+  }
+  Py_DECREF(argNamesSeq);
+  if (!fun) {
     setSpiderMonkeyException(GLOBAL_CX);
     return NULL;
   }
 
-  // translate to the proper python type
-  PyObject *returnValue = pyTypeFactory(GLOBAL_CX, rval);
-  if (PyErr_Occurred()) {
+  JS::RootedValue funVal(GLOBAL_CX, JS::ObjectValue(*JS_GetFunctionObject(fun)));
+  return pyTypeFactory(GLOBAL_CX, funVal);
+}
+
+/**
+ * Implement the pythonmonkey.compileAsync function. From Python-land, that function has the following API:
+ * argument 0 - unicode string of JS code
+ * argument 1 - a Dict of options, the filename, lineno, column, mutedErrors, noScriptRval and strict options of eval
+ * returns an awaitable of a CompiledScript, compiled on a helper thread
+ */
+static PyObject *compileAsync(PyObject *self, PyObject *args) {
+  PyObject *code;
+  PyObject *evalOptions = NULL;
+  if (!PyArg_ParseTuple(args, "U|O!:compileAsync", &code, &PyDict_Type, &evalOptions)) {
     return NULL;
   }
 
-  if (returnValue) {
-    return returnValue;
+  CompiledScriptSettings settings;
+  if (evalOptions && !getCompiledScriptSettings(evalOptions, settings)) {
+    return NULL;
   }
-  else {
-    Py_RETURN_NONE;
+
+  return CompiledScriptMethodDefinitions::compileAsync(code, std::move(settings));
+}
+
+/**
+ * Implement the pythonmonkey.run function, runs a CompiledScript in the global scope and returns the last expression value
+ */
+static PyObject *run(PyObject *self, PyObject *compiledScript) {
+  if (!PyObject_TypeCheck(compiledScript, &CompiledScriptType)) {
+    PyErr_SetString(PyExc_TypeError, "pythonmonkey.run expects a pythonmonkey.CompiledScript");
+    return NULL;
+  }
+
+  JSAutoRealm ar(GLOBAL_CX, *global);
+  JS::RootedScript script(GLOBAL_CX, CompiledScriptMethodDefinitions::instantiate(GLOBAL_CX, (CompiledScript *)compiledScript));
+  if (!script) {
+    setSpiderMonkeyException(GLOBAL_CX);
+    return NULL;
+  }
+
+  return executeScript(script);
+}
+
+
+/**
+ * Implement the pythonmonkey.importModule function, imports an ES module like a dynamic `import()` and returns an awaitable of its namespace
+ */
+static PyObject *importModule(PyObject *self, PyObject *specifier) {
+  if (!PyUnicode_Check(specifier)) {
+    PyErr_SetString(PyExc_TypeError, "pythonmonkey.importModule expects a string as its argument");
+    return NULL;
   }
+  return ModuleLoader::importModule(GLOBAL_CX, specifier);
 }
 
 static PyObject *waitForEventLoop(PyObject *Py_UNUSED(self), PyObject *Py_UNUSED(_)) {
@@ -510,6 +868,10 @@ static PyObject *waitForEventLoop(PyObject *Py_UNUSED(self), PyObject *Py_UNUSED
   if (!loop.initialized()) return NULL;
   PyObject_SetAttrString(waiter, "_loop", loop._loop);
 
+  // promise jobs enqueued while no event-loop was running haven't got a drain scheduled yet
+  if (!JobQueue::scheduleDrainIfPending()) return NULL;
+
+  PyEventLoop::_locker->prepareWait();
   return PyObject_CallMethod(waiter, "wait", NULL);
 }
 
@@ -518,6 +880,26 @@ static PyObject *closeAllPending(PyObject *Py_UNUSED(self), PyObject *Py_UNUSED(
   Py_RETURN_NONE;
 }
 
+static PyObject *runMicrotasks(PyObject *Py_UNUSED(self), PyObject *Py_UNUSED(_)) {
+  // Synchronously run all pending promise jobs, without spinning the Python event-loop
+  JOB_QUEUE->runJobs(GLOBAL_CX);
+  if (PyErr_Occurred()) { // a job threw, the jobs that haven't run yet are kept in the queue
+    return NULL;
+  }
+  Py_RETURN_NONE;
+}
+
+static PyObject *setCompileCacheDir(PyObject *self, PyObject *path) {
+  if (!StencilCache::setDirectory(path)) {
+    return NULL;
+  }
+  Py_RETURN_NONE;
+}
+
+static PyObject *compileCacheStats(PyObject *Py_UNUSED(self), PyObject *Py_UNUSED(_)) {
+  return StencilCache::stats();
+}
+
 static PyObject *isCompilableUnit(PyObject *self, PyObject *args) {
   PyObject *item = PyTuple_GetItem(args, 0);
   if (!PyUnicode_Check(item)) {
@@ -539,7 +921,15 @@ PyMethodDef PythonMonkeyMethods[] = {
   {"eval", eval, METH_VARARGS, "Javascript evaluator in Python"},
   {"wait", waitForEventLoop, METH_NOARGS, "The event-loop shield. Blocks until all asynchronous jobs finish."},
   {"stop", closeAllPending, METH_NOARGS, "Cancel all pending event-loop jobs."},
+  {"runMicrotasks", runMicrotasks, METH_NOARGS, "Synchronously run all pending promise jobs, without the Python event-loop."},
   {"isCompilableUnit", isCompilableUnit, METH_VARARGS, "Hint if a string might be compilable Javascript"},
+  {"compile", compile, METH_VARARGS, "Compile Javascript once, returns a CompiledScript that can be run any number of times"},
+  {"compileFunction", compileFunction, METH_VARARGS, "Compile a Javascript function from its argument names and body"},
+  {"compileAsync", compileAsync, METH_VARARGS, "Compile Javascript on a helper thread, returns an awaitable of a CompiledScript"},
+  {"importModule", importModule, METH_O, "Import an ES module, returns an awaitable of its namespace"},
+  {"run", run, METH_O, "Run a CompiledScript and return the value of its last expression"},
+  {"setCompileCacheDir", setCompileCacheDir, METH_O, "Set the directory of the compiled script cache used by eval(code, {'cache': True}), None disables it"},
+  {"compileCacheStats", compileCacheStats, METH_NOARGS, "The directory and the hit, miss, write and error counters of the compiled script cache"},
   {"collect", collect, METH_VARARGS, "Calls the Spidermonkey garbage collector"},
   {NULL, NULL, 0, NULL}
 };
@@ -565,6 +955,11 @@ PyMODINIT_FUNC PyInit_pythonmonkey(void)
     return NULL;
   }
 
+  HelperThreadPool::init();
+  if (!HelperThreadPool::registerForkHandlers()) {
+    return NULL;
+  }
+
   GLOBAL_CX = JS_NewContext(JS::DefaultHeapMaxBytes);
   if (!GLOBAL_CX) {
     PyErr_SetString(SpiderMonkeyError, "Spidermonkey could not create a JS context.");
@@ -590,9 +985,21 @@ PyMODINIT_FUNC PyInit_pythonmonkey(void)
 
   JS_SetGCParameter(GLOBAL_CX, JSGC_MAX_BYTES, (uint32_t)-1);
 
+  ModuleLoader::init(GLOBAL_CX);
+
   JS_SetGCCallback(GLOBAL_CX, pythonmonkeyGCCallback, NULL);
   JS::AddGCNurseryCollectionCallback(GLOBAL_CX, nurseryCollectionCallback, NULL);
 
+  StencilCache::init();
+  const char *cacheDirectory = getenv("PYTHONMONKEY_CACHE_DIR");
+  if (cacheDirectory && *cacheDirectory) {
+    PyObject *cacheDirectoryStr = PyUnicode_DecodeFSDefault(cacheDirectory);
+    if (!cacheDirectoryStr || !StencilCache::setDirectory(cacheDirectoryStr)) { // an unusable directory only disables the cache
+      PyErr_Clear();
+    }
+    Py_XDECREF(cacheDirectoryStr);
+  }
+
   JS::RealmCreationOptions creationOptions = JS::RealmCreationOptions();
   JS::RealmBehaviors behaviours = JS::RealmBehaviors();
   JS::RealmOptions options = JS::RealmOptions(creationOptions, behaviours);
@@ -633,16 +1040,26 @@ PyMODINIT_FUNC PyInit_pythonmonkey(void)
     return NULL;
   if (PyType_Ready(&JSObjectProxyType) < 0)
     return NULL;
+  if (PyType_Ready(&JSObjectAsyncIterableProxyType) < 0)
+    return NULL;
   if (PyType_Ready(&JSStringProxyType) < 0)
     return NULL;
   if (PyType_Ready(&JSFunctionProxyType) < 0)
     return NULL;
   if (PyType_Ready(&JSMethodProxyType) < 0)
     return NULL;
+  if (PyType_Ready(&JSPromiseProxyType) < 0)
+    return NULL;
   if (PyType_Ready(&JSArrayProxyType) < 0)
     return NULL;
   if (PyType_Ready(&JSArrayIterProxyType) < 0)
     return NULL;
+  if (PyType_Ready(&JSMapProxyType) < 0)
+    return NULL;
+  if (PyType_Ready(&JSSetProxyType) < 0)
+    return NULL;
+  if (PyType_Ready(&CompiledScriptType) < 0)
+    return NULL;
   if (PyType_Ready(&JSObjectIterProxyType) < 0)
     return NULL;
   if (PyType_Ready(&JSObjectKeysProxyType) < 0)
@@ -687,6 +1104,13 @@ PyMODINIT_FUNC PyInit_pythonmonkey(void)
     return NULL;
   }
 
+  Py_INCREF(&JSObjectAsyncIterableProxyType);
+  if (PyModule_AddObject(pyModule, "JSObjectAsyncIterableProxy", (PyObject *)&JSObjectAsyncIterableProxyType) < 0) {
+    Py_DECREF(&JSObjectAsyncIterableProxyType);
+    Py_DECREF(pyModule);
+    return NULL;
+  }
+
   Py_INCREF(&JSStringProxyType);
   if (PyModule_AddObject(pyModule, "JSStringProxy", (PyObject *)&JSStringProxyType) < 0) {
     Py_DECREF(&JSStringProxyType);
@@ -708,6 +1132,34 @@ PyMODINIT_FUNC PyInit_pythonmonkey(void)
     return NULL;
   }
 
+  Py_INCREF(&JSPromiseProxyType);
+  if (PyModule_AddObject(pyModule, "JSPromiseProxy", (PyObject *)&JSPromiseProxyType) < 0) {
+    Py_DECREF(&JSPromiseProxyType);
+    Py_DECREF(pyModule);
+    return NULL;
+  }
+
+  Py_INCREF(&JSMapProxyType);
+  if (PyModule_AddObject(pyModule, "JSMapProxy", (PyObject *)&JSMapProxyType) < 0) {
+    Py_DECREF(&JSMapProxyType);
+    Py_DECREF(pyModule);
+    return NULL;
+  }
+
+  Py_INCREF(&JSSetProxyType);
+  if (PyModule_AddObject(pyModule, "JSSetProxy", (PyObject *)&JSSetProxyType) < 0) {
+    Py_DECREF(&JSSetProxyType);
+    Py_DECREF(pyModule);
+    return NULL;
+  }
+
+  Py_INCREF(&CompiledScriptType);
+  if (PyModule_AddObject(pyModule, "CompiledScript", (PyObject *)&CompiledScriptType) < 0) {
+    Py_DECREF(&CompiledScriptType);
+    Py_DECREF(pyModule);
+    return NULL;
+  }
+
   Py_INCREF(&JSArrayIterProxyType);
   if (PyModule_AddObject(pyModule, "JSArrayIterProxy", (PyObject *)&JSArrayIterProxyType) < 0) {
     Py_DECREF(&JSArrayIterProxyType);
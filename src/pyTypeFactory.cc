@@ -18,6 +18,9 @@
 #include "include/FloatType.hh"
 #include "include/FuncType.hh"
 #include "include/IntType.hh"
+#include "include/JSMapProxy.hh"
+#include "include/JSObjectProxy.hh"
+#include "include/JSSetProxy.hh"
 #include "include/jsTypeFactory.hh"
 #include "include/ListType.hh"
 #include "include/NoneType.hh"
@@ -27,7 +30,10 @@
 #include "include/PyListProxyHandler.hh"
 #include "include/PyObjectProxyHandler.hh"
 #include "include/PyIterableProxyHandler.hh"
+#include "include/PyAsyncIterableProxyHandler.hh"
 #include "include/PyBytesProxyHandler.hh"
+#include "include/PySetProxyHandler.hh"
+#include "include/PySequenceProxyHandler.hh"
 #include "include/setSpiderMonkeyException.hh"
 #include "include/StrType.hh"
 #include "include/modules/pythonmonkey/pythonmonkey.hh"
@@ -35,8 +41,39 @@
 #include <jsapi.h>
 #include <jsfriendapi.h>
 #include <js/Object.h>
+#include <js/Proxy.h>
+#include <js/Symbol.h>
 #include <js/ValueArray.h>
 
+// private
+/**
+ * @brief Whether `obj` has a `[Symbol.asyncIterator]` property, own or inherited, only such objects get the async iterable JSObjectProxy subtype.
+ * No getter nor Proxy trap runs while converting: properties are looked up without being read, the prototype chain isn't searched
+ * past a Proxy, and `JSObjectProxy.__aiter__` does the actual `Get`.
+ *
+ * @return false with a JS exception pending if a lookup fails
+ */
+static bool hasAsyncIteratorProperty(JSContext *cx, JS::HandleObject obj, bool *found) {
+  JS::RootedSymbol asyncIteratorSymbol(cx, JS::GetWellKnownSymbol(cx, JS::SymbolCode::asyncIterator));
+  JS::RootedId asyncIteratorId(cx, JS::PropertyKey::Symbol(asyncIteratorSymbol));
+  JS::Rooted<mozilla::Maybe<JS::PropertyDescriptor>> desc(cx);
+  JS::RootedObject current(cx, obj);
+  *found = false;
+  while (current && !js::IsProxy(current)) {
+    if (!JS_GetOwnPropertyDescriptorById(cx, current, asyncIteratorId, &desc)) {
+      return false;
+    }
+    if (desc.isSome()) {
+      *found = desc->isAccessorDescriptor() || (desc->value().isObject() && JS::IsCallable(&desc->value().toObject()));
+      return true;
+    }
+    if (!JS_GetPrototype(cx, current, &current)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 PyObject *pyTypeFactory(JSContext *cx, JS::HandleValue rval) {
   std::string errorString;
 
@@ -69,7 +106,10 @@ PyObject *pyTypeFactory(JSContext *cx, JS::HandleValue rval) {
       if (js::GetProxyHandler(obj)->family() == &PyDictProxyHandler::family ||                // this is one of our proxies for python dicts
           js::GetProxyHandler(obj)->family() == &PyListProxyHandler::family ||                // this is one of our proxies for python lists
           js::GetProxyHandler(obj)->family() == &PyIterableProxyHandler::family ||            // this is one of our proxies for python iterables
+          js::GetProxyHandler(obj)->family() == &PyAsyncIterableProxyHandler::family ||       // this is one of our proxies for python async iterables
           js::GetProxyHandler(obj)->family() == &PyObjectProxyHandler::family ||              // this is one of our proxies for python iterables
+          js::GetProxyHandler(obj)->family() == &PySetProxyHandler::family ||                 // this is one of our proxies for python sets
+          js::GetProxyHandler(obj)->family() == &PySequenceProxyHandler::family ||            // this is one of our proxies for python tuples and other sequences
           js::GetProxyHandler(obj)->family() == &PyBytesProxyHandler::family) {               // this is one of our proxies for python bytes objects
 
         PyObject *pyObject = JS::GetMaybePtrFromReservedSlot<PyObject>(obj, PyObjectSlot);
@@ -112,12 +152,25 @@ PyObject *pyTypeFactory(JSContext *cx, JS::HandleValue rval) {
       }
     case js::ESClass::Array:
       return ListType::getPyObject(cx, obj);
+    case js::ESClass::Map:
+      return JSMapProxyMethodDefinitions::JSMapProxy_create(cx, obj);
+    case js::ESClass::Set:
+      return JSSetProxyMethodDefinitions::JSSetProxy_create(cx, obj);
     default:
       if (BufferType::isSupportedJsTypes(obj)) { // TypedArray or ArrayBuffer
         // TODO (Tom Tang): ArrayBuffers have cls == js::ESClass::ArrayBuffer
         return BufferType::getPyObject(cx, obj);
       }
     }
+
+    bool asyncIterable = false;
+    if (!hasAsyncIteratorProperty(cx, obj, &asyncIterable)) {
+      setSpiderMonkeyException(cx);
+      return NULL;
+    }
+    if (asyncIterable) {
+      return DictType::getPyObject(cx, rval, &JSObjectAsyncIterableProxyType);
+    }
     return DictType::getPyObject(cx, rval);
   }
   else if (rval.isMagic()) {
@@ -0,0 +1,64 @@
+/**
+ * @file registerAtFork.cc
+ * @brief Register native fork handlers with Python's `os.register_at_fork`, so that the threads PythonMonkey starts can be reset in a forked child
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026 Distributive Corp.
+ *
+ */
+
+#include "include/registerAtFork.hh"
+
+#include <Python.h>
+
+#ifndef _WIN32
+// private
+/**
+ * @brief Add `handler` to `kwargs` as the `keyword` argument of `os.register_at_fork`, unless it's NULL
+ */
+static bool addHandler(PyObject *kwargs, const char *keyword, PyCFunction handler) {
+  if (!handler) {
+    return true;
+  }
+  // the handlers are registered for the lifetime of the process
+  PyMethodDef *def = new PyMethodDef{keyword, handler, METH_NOARGS, NULL};
+  PyObject *function = PyCFunction_New(def, NULL);
+  if (!function) {
+    return false;
+  }
+  int result = PyDict_SetItemString(kwargs, keyword, function);
+  Py_DECREF(function);
+  return result == 0;
+}
+#endif
+
+bool registerAtFork(PyCFunction before, PyCFunction afterInParent, PyCFunction afterInChild) {
+#ifndef _WIN32
+  PyObject *os = PyImport_ImportModule("os");
+  PyObject *registerAtForkFn = os ? PyObject_GetAttrString(os, "register_at_fork") : NULL;
+  Py_XDECREF(os);
+  if (!registerAtForkFn) {
+    return false;
+  }
+  PyObject *args = PyTuple_New(0);
+  PyObject *kwargs = PyDict_New();
+  PyObject *result = NULL;
+  if (args && kwargs &&
+      addHandler(kwargs, "before", before) &&
+      addHandler(kwargs, "after_in_parent", afterInParent) &&
+      addHandler(kwargs, "after_in_child", afterInChild)) {
+    result = PyObject_Call(registerAtForkFn, args, kwargs);
+  }
+  Py_XDECREF(args);
+  Py_XDECREF(kwargs);
+  Py_DECREF(registerAtForkFn);
+  Py_XDECREF(result);
+  return result != NULL;
+#else
+  return true;
+#endif
+}
+
+bool registerAfterForkInChild(PyCFunction afterInChild) {
+  return registerAtFork(NULL, NULL, afterInChild);
+}
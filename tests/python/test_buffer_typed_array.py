@@ -360,6 +360,13 @@ def test_entries_next_next_undefined():
   assert result[0] is None
 
 
+def test_iterator_results():
+  results = pm.eval("(arr) => { const it = arr.entries(); return [it.next(), it.next()] }")(bytes("a", "ascii"))
+  assert results[0] == {'value': [0, 97.0], 'done': False}
+  assert results[1] == {'value': None, 'done': True}
+  assert list(results[1].keys()) == ['value', 'done']
+
+
 # keys
 
 def test_keys_iterator():
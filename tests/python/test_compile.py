@@ -0,0 +1,68 @@
+import pythonmonkey as pm
+import pytest
+
+
+def test_compile_then_run_many_times():
+  script = pm.compile("globalThis.compileRuns = (globalThis.compileRuns || 0) + 1; compileRuns * 10")
+  assert isinstance(script, pm.CompiledScript)
+  assert pm.run(script) == 10
+  assert pm.run(script) == 20
+  assert pm.run(script) == 30
+  assert pm.eval("compileRuns") == 3
+
+
+def test_compile_sees_the_current_globals():
+  script = pm.compile("compileInput * 2")
+  pm.eval("globalThis.compileInput = 4")
+  assert pm.run(script) == 8
+  pm.eval("globalThis.compileInput = 5")
+  assert pm.run(script) == 10
+
+
+def test_compile_options():
+  script = pm.compile("(new Error('here')).stack", {'filename': 'glue.js', 'lineno': 7})
+  assert 'glue.js:7' in pm.run(script)
+  assert 'glue.js' in repr(script)
+  strictScript = pm.compile("(function () { return this })()", {'strict': True})
+  assert pm.run(strictScript) is None
+
+
+def test_compile_syntax_error():
+  with pytest.raises(pm.SpiderMonkeyError, match="SyntaxError"):
+    pm.compile("let = = 1")
+
+
+def test_compile_runtime_error_on_each_run():
+  script = pm.compile("throw new RangeError('every time')")
+  for _ in range(2):
+    with pytest.raises(pm.SpiderMonkeyError, match="every time"):
+      pm.run(script)
+
+
+def test_compile_function():
+  add = pm.compileFunction(['a', 'b'], "return a + b")
+  assert add(1, 2) == 3
+  assert add('x', 'y') == 'xy'
+
+
+def test_compile_function_name_and_options():
+  fn = pm.compileFunction([], "return (new Error('here')).stack", {'name': 'where', 'filename': 'fn.js', 'lineno': 3})
+  stack = fn()
+  assert 'where@fn.js:' in stack
+  strictFn = pm.compileFunction([], "return (function () { return this })()", {'strict': True})
+  assert strictFn() is None
+
+
+def test_compile_function_sees_globals():
+  fn = pm.compileFunction(['x'], "return x * compileFactor")
+  pm.eval("globalThis.compileFactor = 3")
+  assert fn(2) == 6
+
+
+def test_compile_function_errors():
+  with pytest.raises(pm.SpiderMonkeyError, match="SyntaxError"):
+    pm.compileFunction(['a'], "return a +")
+  with pytest.raises(TypeError):
+    pm.compileFunction([1], "return 1")
+  with pytest.raises(TypeError):
+    pm.compileFunction(5, "return 1")
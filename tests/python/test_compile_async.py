@@ -0,0 +1,87 @@
+import pythonmonkey as pm
+import asyncio
+import pytest
+import subprocess
+import sys
+
+
+def test_compile_async_then_run():
+  async def async_fn():
+    script = await pm.compileAsync("globalThis.compiledRuns = (globalThis.compiledRuns || 0) + 1; 6 * 7")
+    assert isinstance(script, pm.CompiledScript)
+    assert pm.run(script) == 42
+    assert pm.run(script) == 42  # runs again without compiling
+    assert pm.eval("compiledRuns") == 2
+    return True
+  assert asyncio.run(async_fn())
+
+
+def test_compile_async_keeps_the_loop_running():
+  async def async_fn():
+    ticks = 0
+
+    async def ticker():
+      nonlocal ticks
+      while True:
+        ticks += 1
+        await asyncio.sleep(0)
+    tickerTask = asyncio.ensure_future(ticker())
+
+    source = "var total = 0;\n" + "total += [1, 2, 3].map((x) => x * 2).length;\n" * 200000 + "total"
+    script = await pm.compileAsync(source)
+    tickerTask.cancel()
+    assert ticks > 0
+    assert pm.run(script) == 600000
+    return True
+  assert asyncio.run(async_fn())
+
+
+def test_compile_async_options():
+  async def async_fn():
+    script = await pm.compileAsync("(new Error('here')).stack", {'filename': 'bundle.js', 'lineno': 10})
+    assert 'bundle.js:10' in pm.run(script)
+    assert 'bundle.js' in repr(script)
+    strictScript = await pm.compileAsync("(function () { return this })()", {'strict': True})
+    assert pm.run(strictScript) is None
+    return True
+  assert asyncio.run(async_fn())
+
+
+def test_compile_async_syntax_error():
+  async def async_fn():
+    with pytest.raises(pm.SpiderMonkeyError, match="SyntaxError"):
+      await pm.compileAsync("let let = ;", {'filename': 'broken.js'})
+    return True
+  assert asyncio.run(async_fn())
+
+
+def test_compile_async_many_at_once():
+  async def async_fn():
+    # more compilations than compile threads, the rest wait in the queue
+    scripts = await asyncio.gather(*[pm.compileAsync(f"{i} * 2") for i in range(32)])
+    assert [pm.run(script) for script in scripts] == [i * 2.0 for i in range(32)]
+    return True
+  assert asyncio.run(async_fn())
+
+
+def test_exit_while_compiling():
+  code = """
+import asyncio
+import pythonmonkey as pm
+source = "var total = 0;\\n" + "total += [1, 2, 3].map((x) => x * 2).length;\\n" * 200000
+
+async def main():
+  for _ in range(8):
+    pm.compileAsync(source)  # never awaited
+  await asyncio.sleep(0)
+asyncio.run(main())
+print("exited")
+"""
+  result = subprocess.run([sys.executable, '-c', code], capture_output=True, text=True, timeout=120)
+  assert result.returncode == 0, result.stderr
+  assert result.stdout.strip() == "exited"
+
+
+def test_run_expects_a_compiled_script():
+  with pytest.raises(TypeError):
+    pm.run("1 + 1")
@@ -0,0 +1,68 @@
+import pythonmonkey as pm
+import os
+import pytest
+
+
+@pytest.fixture
+def cacheDir(tmp_path):
+  previous = pm.compileCacheStats()['directory']
+  pm.setCompileCacheDir(tmp_path)
+  yield tmp_path
+  pm.setCompileCacheDir(previous)
+
+
+def delta(before, after):
+  return {key: after[key] - before[key] for key in ('hits', 'misses', 'writes', 'errors')}
+
+
+def test_cache_miss_then_hit(cacheDir):
+  code = "(function fib(n) { return n < 2 ? n : fib(n - 1) + fib(n - 2) })(20)"
+  before = pm.compileCacheStats()
+  assert pm.eval(code, {'cache': True}) == 6765
+  assert delta(before, pm.compileCacheStats()) == {'hits': 0, 'misses': 1, 'writes': 1, 'errors': 0}
+  assert len(os.listdir(cacheDir)) == 1
+
+  before = pm.compileCacheStats()
+  assert pm.eval(code, {'cache': True}) == 6765
+  assert delta(before, pm.compileCacheStats()) == {'hits': 1, 'misses': 0, 'writes': 0, 'errors': 0}
+
+
+def test_cache_key_includes_options(cacheDir):
+  code = "(new Error('here')).stack"
+  assert 'first.js' in pm.eval(code, {'cache': True, 'filename': 'first.js'})
+  assert 'second.js' in pm.eval(code, {'cache': True, 'filename': 'second.js'})
+  assert len(os.listdir(cacheDir)) == 2
+
+
+def test_cache_is_opt_in(cacheDir):
+  before = pm.compileCacheStats()
+  assert pm.eval("1 + 1") == 2
+  assert delta(before, pm.compileCacheStats()) == {'hits': 0, 'misses': 0, 'writes': 0, 'errors': 0}
+
+
+def test_corrupt_cache_file_is_recompiled(cacheDir):
+  code = "'still ' + 'works'"
+  pm.eval(code, {'cache': True})
+  [cacheFile] = os.listdir(cacheDir)
+  with open(os.path.join(cacheDir, cacheFile), 'wb') as file:
+    file.write(b'not a stencil')
+
+  before = pm.compileCacheStats()
+  assert pm.eval(code, {'cache': True}) == 'still works'
+  assert delta(before, pm.compileCacheStats()) == {'hits': 0, 'misses': 1, 'writes': 1, 'errors': 1}
+
+
+def test_syntax_errors_are_not_cached(cacheDir):
+  with pytest.raises(pm.SpiderMonkeyError):
+    pm.eval("(", {'cache': True})
+  assert os.listdir(cacheDir) == []
+
+
+def test_cache_disabled():
+  previous = pm.compileCacheStats()['directory']
+  pm.setCompileCacheDir(None)
+  try:
+    assert pm.compileCacheStats()['directory'] is None
+    assert pm.eval("2 + 2", {'cache': True}) == 4
+  finally:
+    pm.setCompileCacheDir(previous)
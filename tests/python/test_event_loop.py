@@ -1,6 +1,7 @@
 import pytest
 import pythonmonkey as pm
 import asyncio
+import collections.abc
 
 
 def test_setTimeout_unref():
@@ -57,6 +58,23 @@ def test_finished_timer_ref():
   assert asyncio.run(async_fn())
 
 
+def test_finished_timer_ref_unref_keeps_wait_balanced():
+  async def async_fn():
+    # Re-refing then unrefing a finished timer must not unbalance the counter `pm.wait()` waits on.
+    pm.eval("""
+            globalThis.laterFired = false;
+            const timer = setTimeout(()=>{}, 0);
+            setTimeout(()=>{
+              timer.ref();
+              timer.unref();
+              setTimeout(()=>{ globalThis.laterFired = true }, 100);
+            }, 50);
+        """)
+    await pm.wait()
+    return pm.eval("globalThis.laterFired")
+  assert asyncio.run(async_fn())
+
+
 def test_set_clear_timeout():
   # throw RuntimeError outside a coroutine
   with pytest.raises(RuntimeError,
@@ -352,6 +370,149 @@ def test_promises():
     pm.eval("new Promise(() => { })")
 
 
+def test_promise_jobs_run_in_fifo_order():
+  async def async_fn():
+    order = await pm.eval("""
+      new Promise((resolve) => {
+        const order = [];
+        Promise.resolve().then(() => order.push(1)).then(() => order.push(3));
+        Promise.resolve().then(() => order.push(2)).then(() => order.push(4)).then(() => resolve(order.join(',')));
+      })
+    """)
+    assert order == "1,2,3,4"
+
+    # a long chain of promise jobs is drained without creating a Python callback per job
+    length = await pm.eval("""
+      (length) => {
+        let p = Promise.resolve(0);
+        for (let i = 0; i < length; i++)
+          p = p.then((x) => x + 1);
+        return p;
+      }
+    """)(10000)
+    assert length == 10000
+    return True
+  assert asyncio.run(async_fn())
+
+
+def test_settled_promises_convert_to_done_futures():
+  async def async_fn():
+    fulfilled = pm.eval("Promise.resolve(42)")
+    assert fulfilled.done()
+    assert 42.0 == await fulfilled
+
+    rejected = pm.eval("Promise.reject(new TypeError('already rejected'))", {'mutedErrors': True})
+    assert rejected.done()
+    with pytest.raises(pm.SpiderMonkeyError, match="already rejected"):
+      await rejected
+
+    pending = pm.eval("new Promise((resolve) => setTimeout(() => resolve('later'), 10))")
+    assert not pending.done()
+    assert 'later' == await pending
+    return True
+  assert asyncio.run(async_fn())
+
+
+def test_promises_are_native_awaitables():
+  async def async_fn():
+    promise = pm.eval("new Promise((resolve) => setTimeout(() => resolve('native'), 10))")
+    assert type(promise) is pm.JSPromiseProxy
+    assert asyncio.isfuture(promise)
+    assert promise.get_loop() is asyncio.get_running_loop()
+
+    # accepted wherever asyncio expects a Future
+    assert ['native', 1.0, 2.0] == await asyncio.gather(promise, pm.eval("Promise.resolve(1)"), pm.eval("Promise.resolve(2)"))
+    assert 'native' == await asyncio.wait_for(promise, 1)
+    assert 'native' == promise.result()
+
+    never = pm.eval("new Promise(() => {})")
+    with pytest.raises(asyncio.TimeoutError):
+      await asyncio.wait_for(never, 0.01)
+    assert never.cancelled()
+
+    # converting back to JS gives the very same Promise
+    same = pm.eval("(p) => (q) => p === q")(promise)
+    assert same(promise)
+    return True
+  assert asyncio.run(async_fn())
+
+
+def test_run_microtasks_without_event_loop():
+  pm.eval("""
+    globalThis.microtaskOrder = [];
+    Promise.resolve().then(() => microtaskOrder.push(1)).then(() => microtaskOrder.push(3));
+    Promise.resolve().then(() => microtaskOrder.push(2));
+    undefined;
+  """)
+  assert pm.eval("microtaskOrder.length") == 0
+  pm.runMicrotasks()
+  assert pm.eval("microtaskOrder.join(',')") == "1,2,3"
+  pm.runMicrotasks()  # no-op on an empty queue
+
+
+def test_run_microtasks_from_a_job():
+  pm.eval("""(runMicrotasks) => {
+    globalThis.reentrantOrder = [];
+    Promise.resolve().then(() => {
+      reentrantOrder.push(1);
+      Promise.resolve().then(() => reentrantOrder.push(4));
+      runMicrotasks(); // the ongoing drain keeps the FIFO order
+      reentrantOrder.push(2);
+    });
+    Promise.resolve().then(() => reentrantOrder.push(3));
+  }""")(pm.runMicrotasks)
+  pm.runMicrotasks()
+  assert pm.eval("reentrantOrder.join(',')") == "1,2,3,4"
+
+
+def test_debugger_hook_while_promise_job_queued():
+  hookOrder = pm.eval("debuggerGlobal.eval")("""(mainGlobal) => {
+    const order = [];
+    const dbg = new Debugger(mainGlobal);
+    dbg.onDebuggerStatement = () => {
+      order.push('hook');
+      Promise.resolve().then(() => order.push('hook job')); // runs when the hook returns
+      dbg.removeAllDebuggees();
+    };
+    return () => order.join(',');
+  }""")(pm.eval("globalThis"))
+  pm.eval("""
+    globalThis.debuggeeOrder = [];
+    Promise.resolve().then(() => debuggeeOrder.push('debuggee job'));
+    debugger;
+    debuggeeOrder.push('after debugger');
+  """)
+  assert hookOrder() == "hook,hook job"
+  assert pm.eval("debuggeeOrder.join(',')") == "after debugger"  # the debuggee's job is still queued
+  pm.runMicrotasks()
+  assert pm.eval("debuggeeOrder.join(',')") == "after debugger,debuggee job"
+
+
+def test_promise_without_event_loop():
+  promise = pm.eval("Promise.resolve().then(() => 'later')")
+  assert type(promise) is pm.JSPromiseProxy
+  assert not promise.done()
+
+  unsettled = pm.eval("new Promise((resolve) => { globalThis.resolveLater = resolve; })")
+
+  async def async_fn():
+    assert await promise == 'later'  # its job was enqueued before the loop started
+    assert unsettled.get_loop() is asyncio.get_running_loop()  # bound once a loop needs it
+    pm.eval("resolveLater('awaited')")
+    return await unsettled
+  assert asyncio.run(async_fn()) == 'awaited'
+
+
+def test_wait_runs_jobs_enqueued_without_event_loop():
+  pm.eval("globalThis.ranLater = false; Promise.resolve().then(() => { ranLater = true; })")
+
+  async def async_fn():
+    await pm.wait()
+    await asyncio.sleep(0)
+    return pm.eval("ranLater")
+  assert asyncio.run(async_fn())
+
+
 def test_errors_thrown_in_promise():
   async def async_fn():
     loop = asyncio.get_running_loop()
@@ -433,3 +594,274 @@ def test_webassembly():
     # making sure the async_fn is run
     return True
   assert asyncio.run(async_fn())
+
+
+def test_many_off_thread_dispatches():
+  """
+  Thousands of off-thread promises are handed to the event-loop by a single dispatcher thread
+  """
+  async def async_fn():
+    count = await pm.eval("""
+      (count) => {
+        // the smallest valid module: just the magic number and version
+        const code = new Uint8Array([0, 97, 115, 109, 1, 0, 0, 0]);
+        const compilations = [];
+        for (let i = 0; i < count; i++)
+          compilations.push(WebAssembly.compile(code));
+        return Promise.all(compilations).then((modules) => modules.filter((m) => m instanceof WebAssembly.Module).length);
+      }
+    """)(5000)
+    assert count == 5000
+    return True
+  assert asyncio.run(async_fn())
+
+
+def test_many_timers_fire_in_deadline_order():
+  async def async_fn():
+    inOrder = await pm.eval("""
+      new Promise((resolve) => {
+        const order = [];
+        const count = 10000;
+        for (let i = 0; i < count; i++) {
+          // non-decreasing delays spanning several slots of the timer wheel, so deadlines follow the scheduling order
+          setTimeout(() => {
+            order.push(i);
+            if (order.length === count)
+              resolve(order.every((index, position) => index === position));
+          }, Math.floor(i * 300 / count));
+        }
+      })
+    """)
+    assert inOrder
+    return True
+  assert asyncio.run(async_fn())
+
+
+def test_stale_clearTimeout_is_harmless():
+  async def async_fn():
+    fired = await pm.eval("""
+      new Promise((resolve) => {
+        const first = setTimeout(() => {
+          setTimeout(() => {
+            // `first` has fired, so its slot is free and gets reused by `second`
+            const second = setTimeout(() => resolve(true), 10);
+            clearTimeout(first); // stale, must not cancel `second`
+            first.unref(); // stale as well, ref/unref are no-ops
+            if (first.hasRef()) resolve(false);
+            if (Number(first) === Number(second)) resolve(false);
+          }, 0);
+        }, 0);
+      })
+    """)
+    assert fired
+    return True
+  assert asyncio.run(async_fn())
+
+
+def test_stale_clearTimeout_after_many_slot_reuses():
+  async def async_fn():
+    fired = await pm.eval("""
+      new Promise((resolve) => {
+        const stale = setTimeout(() => {});
+        clearTimeout(stale);
+        // far more reuses than a 10-bit generation could tell apart
+        for (let i = 0; i < 5000; i++)
+          clearTimeout(setTimeout(() => {}, 1000));
+        const live = setTimeout(() => resolve(true), 10);
+        clearTimeout(stale); // must not cancel `live`
+        if (Number(stale) === Number(live)) resolve(false);
+      })
+    """)
+    assert fired
+    return True
+  assert asyncio.run(async_fn())
+
+
+def test_infinite_and_huge_timer_delays():
+  async def async_fn():
+    fired = await pm.eval("""
+      new Promise((resolve) => {
+        const never = [setTimeout(() => resolve(false), Infinity), setTimeout(() => resolve(false), 1e300), setInterval(() => resolve(false), 2 ** 64)];
+        setTimeout(() => {
+          never.forEach(clearTimeout);
+          resolve(true);
+        }, 10);
+      })
+    """)
+    assert fired
+    return True
+  assert asyncio.run(async_fn())
+
+
+def test_timer_slots_are_reused():
+  async def async_fn():
+    # a long-running service creating timers over and over doesn't grow the timer storage
+    slots = await pm.eval("""
+      async () => {
+        const slots = new Set();
+        for (let round = 0; round < 100; round++) {
+          const timers = [];
+          for (let i = 0; i < 1000; i++)
+            timers.push(new Promise((resolve) => setTimeout(resolve, 0)));
+          for (let i = 0; i < 1000; i++)
+            clearTimeout(setTimeout(() => {}, 1000));
+          await Promise.all(timers);
+          // the low 22 bits of a timeoutID is the slot index
+          slots.add(Number(setTimeout(() => {})) % (2 ** 22));
+        }
+        return Math.max(...slots);
+      }
+    """)()
+    assert slots < 2000
+    return True
+  assert asyncio.run(async_fn())
+
+
+def test_python_async_generator_in_js_for_await():
+  async def async_fn():
+    produced = []
+    cleaned_up = []
+
+    async def numbers():
+      try:
+        for i in range(100):
+          produced.append(i)
+          await asyncio.sleep(0)
+          yield i
+      finally:
+        cleaned_up.append(True)
+
+    consume = pm.eval("""
+      async (gen, produced) => {
+        const seen = [];
+        for await (const x of gen) {
+          // values are only produced on demand
+          if (produced.length !== seen.length + 1) throw new Error('generator ran ahead of the consumer');
+          seen.push(x);
+          if (seen.length === 5) break;
+        }
+        return seen;
+      }
+    """)
+    assert [0.0, 1.0, 2.0, 3.0, 4.0] == await consume(numbers(), produced)
+    assert produced == [0, 1, 2, 3, 4]
+    assert cleaned_up == [True]  # breaking out of `for await` closes the generator
+
+    async def empty():
+      return
+      yield
+    assert [] == await consume(empty(), [])
+    return True
+  assert asyncio.run(async_fn())
+
+
+def test_python_async_iterable_in_js_for_await():
+  async def async_fn():
+    class Countdown:
+      def __init__(self):
+        self.aiter_calls = 0
+
+      def __aiter__(self):
+        self.aiter_calls += 1
+        return CountdownIterator(3)
+
+    class CountdownIterator:
+      def __init__(self, n):
+        self.n = n
+
+      async def __anext__(self):
+        if self.n == 0:
+          raise StopAsyncIteration
+        self.n -= 1
+        return self.n + 1
+
+    class Broken:
+      def __aiter__(self):
+        raise ValueError("no async iterator for you")
+
+    countdown = Countdown()
+    identity = pm.eval("(x) => x")
+    assert identity(countdown) is countdown  # the original object round-trips
+    assert countdown.aiter_calls == 0  # `__aiter__()` is not called by the conversion itself
+
+    consume = pm.eval("""
+      async (iterable) => {
+        const seen = [];
+        for await (const x of iterable) seen.push(x);
+        return seen;
+      }
+    """)
+    assert [3.0, 2.0, 1.0] == await consume(countdown)
+    assert countdown.aiter_calls == 1
+
+    with pytest.raises(pm.SpiderMonkeyError, match="Python ValueError: no async iterator for you"):
+      await consume(Broken())
+    return True
+  assert asyncio.run(async_fn())
+
+
+def test_js_async_iterable_in_python_async_for():
+  async def async_fn():
+    js_gen = pm.eval("""
+      (async function* () {
+        globalThis.asyncGenProduced = 0;
+        for (let i = 0; i < 3; i++) {
+          asyncGenProduced++;
+          await new Promise((resolve) => setTimeout(resolve, 0));
+          yield i * 10;
+        }
+      })()
+    """)
+    values = []
+    async for x in js_gen:
+      assert pm.eval("asyncGenProduced") == len(values) + 1
+      values.append(x)
+    assert values == [0.0, 10.0, 20.0]
+
+    # a hand-written async iterable returning plain iterator results
+    countdown = pm.eval("""
+      ({
+        [Symbol.asyncIterator]() {
+          let n = 3;
+          return { next: () => (n > 0 ? { value: n--, done: false } : { done: true }) };
+        }
+      })
+    """)
+    assert [3.0, 2.0, 1.0] == [x async for x in countdown]
+
+    failing = pm.eval("(async function* () { yield 1; throw new TypeError('in the generator'); })()")
+    with pytest.raises(pm.SpiderMonkeyError, match="in the generator"):
+      async for _ in failing:
+        pass
+
+    with pytest.raises(TypeError):
+      async for _ in pm.eval("({})"):
+        pass
+    return True
+  assert asyncio.run(async_fn())
+
+
+def test_only_js_async_iterables_are_async_iterable_proxies():
+  plain = pm.eval("({ a: 1 })")
+  assert type(plain) is pm.JSObjectProxy
+  assert not hasattr(type(plain), "__aiter__")
+  assert not isinstance(plain, collections.abc.AsyncIterable)
+  assert not isinstance(plain, collections.abc.AsyncIterator)
+
+  js_gen = pm.eval("(async function* () { yield 1; })()")
+  assert isinstance(js_gen, pm.JSObjectAsyncIterableProxy)
+  assert isinstance(js_gen, pm.JSObjectProxy)
+  assert isinstance(js_gen, collections.abc.AsyncIterator)
+  hand_written = pm.eval("({ [Symbol.asyncIterator]() { return { next: () => ({ done: true }) }; } })")
+  assert isinstance(hand_written, collections.abc.AsyncIterable)
+  assert isinstance(type(hand_written).__aiter__(hand_written), collections.abc.AsyncIterator)
+
+
+def test_async_iterable_check_runs_no_js_code():
+  # converting to Python doesn't run Proxy traps nor getters
+  proxy = pm.eval("new Proxy({ a: 1 }, { get() { throw new Error('get trap'); }, has() { throw new Error('has trap'); } })")
+  assert type(proxy) is pm.JSObjectProxy
+  getter = pm.eval("({ get [Symbol.asyncIterator]() { throw new Error('getter'); } })")
+  assert isinstance(getter, pm.JSObjectAsyncIterableProxy)
+  with pytest.raises(pm.SpiderMonkeyError, match="getter"):
+    type(getter).__aiter__(getter)  # read when iterating
@@ -0,0 +1,61 @@
+import pythonmonkey as pm
+import asyncio
+import os
+import pytest
+import sys
+
+pytestmark = pytest.mark.skipif(not hasattr(os, 'fork'), reason='os.fork() is not available')
+
+
+def forkAndRun(childFn):
+  pid = os.fork()
+  if pid == 0:
+    code = 1
+    try:
+      code = 0 if childFn() else 1
+    finally:
+      os._exit(code)
+  _, status = os.waitpid(pid, 0)
+  return os.waitstatus_to_exitcode(status) if sys.version_info >= (3, 9) else status >> 8
+
+
+def test_fork_child_uses_the_warmed_context():
+  pm.eval("globalThis.forkedValue = { warmed: true }")
+
+  def child():
+    return pm.eval("forkedValue.warmed && new URL('https://example.com/x').pathname === '/x'")
+  assert forkAndRun(child) == 0
+
+
+def test_fork_child_collects_garbage():
+  pm.eval("globalThis.forkGarbage = () => { const a = []; for (let i = 0; i < 100000; i++) a.push({ i }); return a.length; }")
+
+  def child():
+    for _ in range(5):
+      pm.eval("forkGarbage()")
+      pm.collect()
+    return pm.eval("forkGarbage()") == 100000
+  assert forkAndRun(child) == 0
+
+
+def test_parent_works_after_fork():
+  assert forkAndRun(lambda: True) == 0
+  pm.eval("globalThis.afterFork = Array.from({ length: 100000 }, (_, i) => ({ i }))")
+  pm.collect()
+  assert pm.eval("afterFork.length") == 100000
+
+
+def test_fork_child_runs_off_thread_promises():
+  compile = pm.eval("""() => {
+    // the smallest valid module: just the magic number and version
+    const code = new Uint8Array([0, 97, 115, 109, 1, 0, 0, 0]);
+    return WebAssembly.compile(code).then((module) => module instanceof WebAssembly.Module);
+  }""")
+
+  async def compileModule():
+    return await compile()
+  assert asyncio.run(compileModule())  # starts the dispatcher thread in the parent
+
+  def child():
+    return asyncio.run(asyncio.wait_for(compileModule(), 5))
+  assert forkAndRun(child) == 0
@@ -0,0 +1,18 @@
+import pythonmonkey as pm
+
+
+def test_internal_binding_namespace_built_once():
+  sameObject = pm.eval("(internalBinding) => internalBinding('timers') === internalBinding('timers')")
+  assert sameObject(pm.internalBinding)
+
+
+def test_internal_binding_namespaces_are_distinct():
+  namespaces = pm.eval("(internalBinding) => ['utils', 'timers', 'fs'].map((name) => internalBinding(name))")(pm.internalBinding)
+  assert namespaces[0]['isPromise'] is not None
+  assert namespaces[1]['enqueueWithDelay'] is not None
+  assert namespaces[2]['readFile'] is not None
+
+
+def test_internal_binding_unknown_namespace():
+  assert pm.internalBinding('no-such-namespace') is None
+  assert pm.internalBinding('toString') is None  # the cache of namespaces has no prototype
@@ -0,0 +1,155 @@
+import pythonmonkey as pm
+import os
+import stat
+import time
+
+
+fs = pm.internalBinding('fs')
+
+
+def test_fs_stat(tmp_path):
+  (tmp_path / 'file.js').write_text('', encoding='utf-8')
+  assert stat.S_ISREG(int(fs.stat(str(tmp_path / 'file.js'))))
+  assert stat.S_ISDIR(int(fs.stat(str(tmp_path))))
+  assert fs.stat(str(tmp_path / 'missing.js')) is None
+  assert fs.exists(str(tmp_path / 'file.js'))
+  assert not fs.exists(str(tmp_path / 'missing.js'))
+
+
+def test_fs_normalized_paths(tmp_path):
+  (tmp_path / 'sub').mkdir()
+  (tmp_path / 'file.js').write_text('normalized', encoding='utf-8')
+  assert fs.readFile(str(tmp_path) + '/sub/../file.js') == 'normalized'
+  assert fs.readFile(str(tmp_path) + '//./file.js') == 'normalized'
+  assert stat.S_ISDIR(int(fs.stat(str(tmp_path / 'sub') + '/')))
+
+
+def test_fs_non_ascii_paths(tmp_path):
+  directory = tmp_path / 'répertoire ✓'
+  directory.mkdir()
+  (directory / 'модуль.js').write_text('non-ascii', encoding='utf-8')
+  assert stat.S_ISREG(int(fs.stat(str(directory / 'модуль.js'))))
+  assert fs.readFile(str(directory / 'модуль.js')) == 'non-ascii'
+  assert fs.mtime(str(directory / 'модуль.js')) is not None
+
+
+def test_fs_read_file(tmp_path):
+  (tmp_path / 'latin1.js').write_text('module.exports = "abc";', encoding='utf-8')
+  (tmp_path / 'unicode.js').write_text('module.exports = "héllo 🐍";', encoding='utf-8')
+  (tmp_path / 'empty.js').write_bytes(b'')
+  assert fs.readFile(str(tmp_path / 'latin1.js')) == 'module.exports = "abc";'
+  assert fs.readFile(str(tmp_path / 'unicode.js')) == 'module.exports = "héllo 🐍";'
+  assert fs.readFile(str(tmp_path / 'empty.js')) == ''
+  assert fs.readFile(str(tmp_path / 'missing.js')) is None
+
+
+def test_fs_negative_lookup_cache(tmp_path):
+  path = str(tmp_path / 'late.js')
+  os.utime(tmp_path, ns=(0, 0))  # a directory modified just now isn't trusted to change its mtime again
+  assert not fs.exists(path)
+  (tmp_path / 'late.js').write_text('module.exports = 1;', encoding='utf-8')
+  assert fs.exists(path)  # creating the file modified the directory
+
+  hidden = str(tmp_path / 'hidden.js')
+  os.utime(tmp_path, ns=(0, 0))
+  assert not fs.exists(hidden)
+  (tmp_path / 'hidden.js').write_text('module.exports = 1;', encoding='utf-8')
+  os.utime(tmp_path, ns=(0, 0))  # the miss is keyed on the directory mtime
+  assert not fs.exists(hidden)
+  fs.clearCache()
+  assert fs.exists(hidden)
+
+
+def test_fs_negative_lookup_cache_in_a_resolution(tmp_path):
+  os.utime(tmp_path, ns=(0, 0))
+  assert not fs.exists(str(tmp_path / 'a.js'))
+  assert not fs.exists(str(tmp_path / 'b.js'))
+  fs.beginResolution()
+  try:
+    assert not fs.exists(str(tmp_path / 'a.js'))
+    (tmp_path / 'b.js').write_text('', encoding='utf-8')
+    assert not fs.exists(str(tmp_path / 'b.js'))  # the directory was already checked in this resolution
+  finally:
+    fs.endResolution()
+  assert fs.exists(str(tmp_path / 'b.js'))
+
+
+def test_require_through_fs_binding(tmp_path):
+  (tmp_path / 'lib.js').write_text('exports.greeting = "héllo";', encoding='utf-8')
+  (tmp_path / 'main.js').write_text('exports.message = require("./lib").greeting + " world";', encoding='utf-8')
+  assert pm.require(str(tmp_path / 'main.js'))['message'] == 'héllo world'
+
+
+def test_fs_mtime(tmp_path):
+  path = tmp_path / 'file.js'
+  path.write_text('', encoding='utf-8')
+  before = fs.mtime(str(path))
+  assert before == fs.mtime(str(path))
+  os.utime(path, ns=(0, 0))
+  assert fs.mtime(str(path)) != before
+  assert fs.mtime(str(tmp_path / 'missing.js')) is None
+
+
+def waitForPrefetch():
+  deadline = time.monotonic() + 5
+  while fs.prefetchStats()['pending'] > 0:
+    assert time.monotonic() < deadline, 'prefetch did not complete'
+    time.sleep(0.001)
+
+
+def test_fs_prefetch(tmp_path):
+  (tmp_path / 'dep.js').write_text('module.exports = "prefetched";', encoding='utf-8')
+  hits = fs.prefetchStats()['hits']
+  fs.prefetch([[str(tmp_path / 'dep'), str(tmp_path / 'dep.js')], [str(tmp_path / 'none.js')]])
+  waitForPrefetch()
+  assert fs.readFile(str(tmp_path / 'dep.js')) == 'module.exports = "prefetched";'
+  assert fs.prefetchStats()['hits'] == hits + 1
+  assert fs.readFile(str(tmp_path / 'dep.js')) == 'module.exports = "prefetched";'  # read again from disk
+  assert fs.prefetchStats()['hits'] == hits + 1
+
+
+def test_fs_prefetched_file_modified(tmp_path):
+  path = tmp_path / 'changed.js'
+  path.write_text('old', encoding='utf-8')
+  os.utime(path, ns=(0, 0))
+  hits = fs.prefetchStats()['hits']
+  fs.prefetch([[str(path)]])
+  waitForPrefetch()
+  path.write_text('new', encoding='utf-8')
+  assert fs.readFile(str(path)) == 'new'
+  assert fs.prefetchStats()['hits'] == hits  # the stale copy was dropped
+
+
+def test_require_resolution_cache(tmp_path):
+  (tmp_path / 'shared.js').write_text('exports.loads = (exports.loads || 0) + 1;', encoding='utf-8')
+  (tmp_path / 'a.js').write_text('exports.shared = require("./shared");', encoding='utf-8')
+  (tmp_path / 'b.js').write_text('exports.shared = require("./shared");', encoding='utf-8')
+  a = pm.require(str(tmp_path / 'a.js'))
+  b = pm.require(str(tmp_path / 'b.js'))
+  assert a['shared'] == b['shared']
+  assert a['shared']['loads'] == 1
+  assert pm.bootstrap.lookupResolution(str(tmp_path).replace('\\', '/'), './shared') == str(tmp_path / 'shared.js').replace('\\', '/')
+
+
+def test_require_resolution_cache_invalidated(tmp_path):
+  (tmp_path / 'dep').mkdir()
+  (tmp_path / 'dep' / 'index.js').write_text('exports.name = "index";', encoding='utf-8')
+  (tmp_path / 'first.js').write_text('exports.name = require("./dep").name;', encoding='utf-8')
+  os.utime(tmp_path, ns=(0, 0))  # so that the misses are cached
+  assert pm.require(str(tmp_path / 'first.js'))['name'] == 'index'
+  (tmp_path / 'dep.js').write_text('exports.name = "file";', encoding='utf-8')  # modifies the directory, where dep.js was found missing
+  (tmp_path / 'second.js').write_text('exports.name = require("./dep").name;', encoding='utf-8')
+  assert pm.require(str(tmp_path / 'second.js'))['name'] == 'file'
+
+
+def test_require_resolution_cache_search_paths(tmp_path):
+  for name in ('one', 'two'):
+    (tmp_path / name).mkdir()
+    (tmp_path / name / 'lib.js').write_text('exports.name = "%s";' % name, encoding='utf-8')
+  (tmp_path / 'app').mkdir()
+  # two requires of the same directory, which search different paths for the same identifier
+  requireOne = pm.createRequire(str(tmp_path / 'app' / 'one.js'), [str(tmp_path / 'one')])
+  requireTwo = pm.createRequire(str(tmp_path / 'app' / 'two.js'), [str(tmp_path / 'two')])
+  assert requireOne('lib')['name'] == 'one'
+  assert requireTwo('lib')['name'] == 'two'
+  assert requireOne('lib')['name'] == 'one'
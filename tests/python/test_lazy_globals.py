@@ -0,0 +1,47 @@
+import pythonmonkey as pm
+import subprocess
+import sys
+
+
+def runChild(code):
+  return subprocess.run([sys.executable, '-c', code], check=True, capture_output=True, text=True).stdout.split()
+
+
+def test_lazy_globals_not_loaded_by_import():
+  output = runChild("""
+import pythonmonkey as pm
+print(pm.eval("typeof Object.getOwnPropertyDescriptor(globalThis, 'XMLHttpRequest').get"))
+print(pm.eval("typeof Object.getOwnPropertyDescriptor(globalThis, 'console').get"))
+""")
+  assert output == ['function', 'function']
+
+
+def test_lazy_globals_load_on_first_use():
+  output = runChild("""
+import pythonmonkey as pm
+print(pm.eval("new URL('https://example.com/a?b=c').pathname"))
+print(pm.eval("typeof Object.getOwnPropertyDescriptor(globalThis, 'URL').value"))
+print(pm.eval("typeof URLSearchParams"))
+print(pm.eval("btoa('pm')"))
+""")
+  assert output == ['/a', 'function', 'function', 'cG0=']
+
+
+def test_lazy_globals_assigned_before_use():
+  output = runChild("""
+import pythonmonkey as pm
+pm.eval("globalThis.atob = () => 'mine'")
+print(pm.eval("atob('x')"))
+print(pm.eval("btoa('pm')"))
+print(pm.eval("atob('x')"))
+""")
+  assert output == ['mine', 'cG0=', 'mine']
+
+
+def test_lazy_globals():
+  assert pm.eval("typeof console.log") == 'function'
+  assert pm.eval("typeof setTimeout") == 'function'
+  assert pm.eval("new DOMException('m', 'AbortError').name") == 'AbortError'
+  assert pm.eval("new Event('e').type") == 'e'
+  assert pm.eval("typeof XMLHttpRequest") == 'function'
+  assert pm.eval("Object.keys(globalThis).includes('XMLHttpRequest')")
@@ -847,6 +847,34 @@ def test_sort_with_one_arg_function():
   assert a == ['VW', 'BMW', 'Ford', 'Mitsubishi']
 
 
+def test_sort_with_one_arg_function_calls_key_once_per_element():
+  calls = []
+
+  def myFunc(e):
+    calls.append(e)
+    return e
+  a = pm.eval("[5,1,2,4,9,6,3,7,8]")
+  a.sort(key=myFunc)
+  assert a == [1, 2, 3, 4, 5, 6, 7, 8, 9]
+  assert len(calls) == 9
+
+
+def test_sort_with_one_arg_function_is_stable():
+  def myFunc(e):
+    return e[0]
+  a = pm.eval("[['b', 1], ['a', 2], ['b', 3], ['a', 4]]")
+  a.sort(key=myFunc)
+  assert a == [['a', 2], ['a', 4], ['b', 1], ['b', 3]]
+
+
+def test_sort_with_one_arg_function_and_reverse_is_stable():
+  def myFunc(e):
+    return e[0]
+  a = pm.eval("[['b', 1], ['a', 2], ['b', 3], ['a', 4]]")
+  a.sort(key=myFunc, reverse=True)
+  assert a == [['b', 1], ['b', 3], ['a', 2], ['a', 4]]
+
+
 def test_sort_with_one_arg_function_wrong_data_type():
   def myFunc(e):
     return len(e)
@@ -933,6 +961,35 @@ def test_sort_with_builtin_function_wrong_data_type():
     assert str(type(e)) == "<class 'TypeError'>"
     assert str(e) == "object of type 'float' has no len()"
 
+
+def test_sort_with_inconsistent_key_ordering():
+  class Chaotic:
+    def __init__(self, value):
+      self.value = value
+
+    def __lt__(self, other):
+      return True
+  a = pm.eval("Array.from({ length: 100 }, (_, i) => i)")
+  a.sort(key=Chaotic)
+  assert sorted(a) == list(range(100))
+
+
+def test_sort_with_key_comparison_error():
+  class Fragile:
+    def __init__(self, value):
+      self.value = value
+
+    def __lt__(self, other):
+      raise ValueError('cannot compare')
+  a = pm.eval("[3, 1, 2]")
+  try:
+    a.sort(key=Fragile)
+    assert (False)
+  except Exception as e:
+    assert str(type(e)) == "<class 'ValueError'>"
+    assert str(e) == "cannot compare"
+  assert a == [3, 1, 2]
+
 # iter
 
 
@@ -1098,6 +1155,37 @@ def test_slice_assign_pm_array():
   assert a == [1, 2, 7, 8, 5, 6]
 
 
+def test_slice_assign_insert_middle():
+  a = pm.eval("([1,2,3,4,5,6])")
+  a[1:2] = [7, 8, 9, 10]
+  assert a == [1, 7, 8, 9, 10, 3, 4, 5, 6]
+
+
+def test_slice_assign_generator():
+  a = pm.eval("([1,2,3,4,5,6])")
+  a[1:5] = (x * 10 for x in range(2))
+  assert a == [1, 0, 10, 6]
+
+
+def test_bulk_mutation_conversion_error():
+  async def coro():
+    pass
+  a = pm.eval("([1,2,3])")
+  awaitable = coro()
+  try:
+    a.extend([4, awaitable])  # no running event-loop to convert the awaitable to a Promise
+    assert (False)
+  except Exception as e:
+    assert str(type(e)) == "<class 'RuntimeError'>"
+  try:
+    a[0:1] = [awaitable]
+    assert (False)
+  except Exception as e:
+    assert str(type(e)) == "<class 'RuntimeError'>"
+  awaitable.close()
+  assert a == [1, 2, 3]
+
+
 def test_slice_assign_wrong_type():
   a = pm.eval('([1,2,3,4])')
   try:
@@ -1229,7 +1317,13 @@ def test_slice_assign_own_array_no_match():
     assert (False)
   except Exception as e:
     assert str(type(e)) == "<class 'ValueError'>"
-    assert str(e) == "attempt to assign sequence of size 0 to extended slice of size 2"
+    assert str(e) == "attempt to assign sequence of size 6 to extended slice of size 2"
+
+
+def test_slice_assign_own_array_reversed():
+  a = pm.eval("([1,2,3,4,5,6])")
+  a[::-1] = a
+  assert a == [6, 5, 4, 3, 2, 1]
 
 
 def test_slice_assign_pm_array_step_2():
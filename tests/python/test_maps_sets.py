@@ -0,0 +1,104 @@
+import pythonmonkey as pm
+import collections.abc
+import pytest
+
+
+def test_js_map_is_a_mapping():
+  m = pm.eval("new Map([['a', 1], ['b', 2]])")
+  assert isinstance(m, pm.JSMapProxy)
+  assert isinstance(m, collections.abc.MutableMapping)
+  assert len(m) == 2
+  assert m['a'] == 1.0
+  assert 'b' in m
+  assert 'c' not in m
+  assert m.get('c', 42) == 42
+  with pytest.raises(KeyError):
+    m['c']
+  assert list(m) == ['a', 'b']
+  assert list(m.values()) == [1.0, 2.0]
+  assert list(m.items()) == [('a', 1.0), ('b', 2.0)]
+  assert m == {'a': 1.0, 'b': 2.0}
+  assert repr(m) == "JSMapProxy({'a': 1.0, 'b': 2.0})"
+
+
+def test_js_map_mutations_are_shared():
+  m = pm.eval("globalThis.sharedMap = new Map(); sharedMap")
+  m['x'] = 1
+  m.update({'y': 2}, z=3)
+  assert pm.eval("[...sharedMap.keys()]") == ['x', 'y', 'z']
+  del m['x']
+  assert m.pop('y') == 2
+  assert m.pop('y', None) is None
+  assert m.setdefault('w', 4) == 4
+  assert pm.eval("sharedMap.get('w')") == 4
+  m.clear()
+  assert pm.eval("sharedMap.size") == 0
+
+
+def test_js_map_object_keys_and_undefined_values():
+  m = pm.eval("const key = {}; globalThis.keyed = new Map([[key, 'object'], ['u', undefined]]); keyed")
+  key = pm.eval("keyed.keys().next().value")
+  assert m[key] == 'object' # JS objects are looked up by identity, no hashing involved
+  assert m['u'] is None
+  assert 'u' in m
+
+
+def test_js_map_round_trip():
+  m = pm.eval("new Map()")
+  assert pm.eval("(m) => m instanceof Map")(m)
+  assert pm.eval("(a, b) => a === b")(m, m) # the proxy unwraps to the same JS Map
+  m2 = pm.eval("(m) => { m.set('k', 'v'); return m; }")(m)
+  assert m2['k'] == 'v'
+
+
+def test_js_set_is_a_set():
+  s = pm.eval("new Set([1, 2, 3, 2])")
+  assert isinstance(s, pm.JSSetProxy)
+  assert isinstance(s, collections.abc.MutableSet)
+  assert len(s) == 3
+  assert 2 in s
+  assert 4 not in s
+  assert list(s) == [1.0, 2.0, 3.0]
+  assert s == {1, 2, 3}
+  assert s <= {1, 2, 3, 4}
+  assert s & {2, 3, 4} == {2, 3}
+  assert s | {4} == {1, 2, 3, 4}
+  assert s - {1} == {2, 3}
+  assert s.isdisjoint([5, 6])
+  assert repr(pm.eval("new Set()")) == "JSSetProxy()"
+
+
+def test_js_set_mutations_are_shared():
+  s = pm.eval("globalThis.sharedSet = new Set(); sharedSet")
+  s.add('a')
+  s.add('b')
+  s.discard('a')
+  assert pm.eval("[...sharedSet]") == ['b']
+  with pytest.raises(KeyError):
+    s.remove('a')
+  assert s.pop() == 'b'
+  assert len(s) == 0
+
+
+def test_python_set_in_js():
+  s = {1, 2, 3}
+  jsSize, hasTwo, hasFour, spread = pm.eval("(s) => [s.size, s.has(2), s.has(4), [...s].sort()]")(s)
+  assert jsSize == 3
+  assert hasTwo
+  assert not hasFour
+  assert spread == [1, 2, 3]
+  assert pm.eval("(s) => s instanceof Set")(s)
+
+
+def test_python_set_mutated_from_js():
+  s = {'a'}
+  pm.eval("(s) => { s.add('b').add('c'); s.delete('a'); }")(s)
+  assert s == {'b', 'c'}
+  visited = pm.eval("(s) => { const visited = []; s.forEach((v) => visited.push(v)); return visited.sort(); }")(s)
+  assert visited == ['b', 'c']
+
+
+def test_python_frozenset_in_js():
+  s = frozenset([1])
+  assert pm.eval("(s) => s.has(1) && typeof s.add === 'undefined'")(s)
+  assert pm.eval("(s) => s")(s) is s
@@ -0,0 +1,129 @@
+import pythonmonkey as pm
+import asyncio
+import pytest
+
+
+def writeModules(directory, modules):
+  for name, source in modules.items():
+    (directory / name).write_text(source, encoding='utf-8')
+
+
+def test_import_module_graph(tmp_path):
+  writeModules(tmp_path, {
+    'main.mjs': "import { double } from './lib/math.mjs'; import answer from './answer.mjs'; export const result = double(answer);",
+    'answer.mjs': "export default 21;",
+  })
+  (tmp_path / 'lib').mkdir()
+  writeModules(tmp_path / 'lib', {
+    'math.mjs': "export function double(x) { return x * 2; }",
+  })
+
+  async def async_fn():
+    ns = await pm.importModule(str(tmp_path / 'main.mjs'))
+    assert ns['result'] == 42
+    return True
+  assert asyncio.run(async_fn())
+
+
+def test_import_module_evaluated_once(tmp_path):
+  writeModules(tmp_path, {
+    'counter.mjs': "globalThis.moduleEvaluations = (globalThis.moduleEvaluations || 0) + 1; export const n = 1;",
+    'a.mjs': "import './counter.mjs'; export const a = 1;",
+    'b.mjs': "import './counter.mjs'; export const b = 1;",
+  })
+
+  async def async_fn():
+    await asyncio.gather(pm.importModule(str(tmp_path / 'a.mjs')), pm.importModule(str(tmp_path / 'b.mjs')))
+    await pm.importModule('file://' + str(tmp_path / 'counter.mjs'))
+    assert pm.eval("moduleEvaluations") == 1
+    return True
+  assert asyncio.run(async_fn())
+
+
+def test_import_module_top_level_await(tmp_path):
+  writeModules(tmp_path, {
+    'tla.mjs': "export const value = await new Promise((resolve) => setTimeout(() => resolve('awaited'), 10));",
+  })
+
+  async def async_fn():
+    ns = await pm.importModule(str(tmp_path / 'tla.mjs'))
+    assert ns['value'] == 'awaited'
+    return True
+  assert asyncio.run(async_fn())
+
+
+def test_import_meta_and_dynamic_import(tmp_path):
+  writeModules(tmp_path, {
+    'meta.mjs': "export const url = import.meta.url; export const other = (await import('./other.mjs')).name;",
+    'other.mjs': "export const name = 'other';",
+  })
+
+  async def async_fn():
+    ns = await pm.importModule(str(tmp_path / 'meta.mjs'))
+    assert ns['url'] == 'file://' + str(tmp_path / 'meta.mjs').replace('\\', '/')
+    assert ns['other'] == 'other'
+    return True
+  assert asyncio.run(async_fn())
+
+
+def test_import_module_errors(tmp_path):
+  writeModules(tmp_path, {
+    'syntax.mjs': "export const = 1;",
+    'missing.mjs': "import './nowhere.mjs';",
+  })
+
+  async def async_fn():
+    with pytest.raises(pm.SpiderMonkeyError, match="SyntaxError"):
+      await pm.importModule(str(tmp_path / 'syntax.mjs'))
+    with pytest.raises(pm.SpiderMonkeyError, match="Cannot find module"):
+      await pm.importModule(str(tmp_path / 'missing.mjs'))
+    with pytest.raises(pm.SpiderMonkeyError, match="Cannot resolve module specifier"):
+      await pm.importModule('some-package')
+    return True
+  assert asyncio.run(async_fn())
+
+
+def test_eval_module(tmp_path):
+  writeModules(tmp_path, {
+    'dep.mjs': "export const dep = 'dep';",
+  })
+
+  async def async_fn():
+    ns = await pm.eval("import { dep } from './dep.mjs'; export const value = dep + '!';", {'module': True, 'filename': str(tmp_path / 'inline.mjs')})
+    assert ns['value'] == 'dep!'
+    return True
+  assert asyncio.run(async_fn())
+
+
+def test_import_module_without_event_loop(tmp_path):
+  writeModules(tmp_path, {
+    'sync.mjs': "import { dep } from './dep.mjs'; export const value = await Promise.resolve(dep + '!');",
+    'dep.mjs': "export const dep = 'dep';",
+    'pending.mjs': "await new Promise(() => {});",
+    'throws.mjs': "throw new TypeError('while evaluating');",
+  })
+
+  # without a running event-loop, the module graph is loaded and evaluated synchronously
+  ns = pm.importModule(str(tmp_path / 'sync.mjs'))
+  assert ns['value'] == 'dep!'
+  ns = pm.eval("import { dep } from './dep.mjs'; export const value = dep + '?';", {'module': True, 'filename': str(tmp_path / 'inline.mjs')})
+  assert ns['value'] == 'dep?'
+
+  with pytest.raises(pm.SpiderMonkeyError, match="while evaluating"):
+    pm.importModule(str(tmp_path / 'throws.mjs'))
+  with pytest.raises(RuntimeError, match="needs a running event-loop"):
+    pm.importModule(str(tmp_path / 'pending.mjs'))
+
+
+def test_import_module_after_its_event_loop_closed(tmp_path):
+  writeModules(tmp_path, {
+    'abandoned.mjs': "export const value = 'loaded again';",
+  })
+
+  async def async_fn():
+    pm.importModule(str(tmp_path / 'abandoned.mjs'))  # the event-loop closes before the load is handed back
+  asyncio.run(async_fn())
+
+  # the abandoned load doesn't leave later imports of the same URL waiting forever
+  ns = pm.importModule(str(tmp_path / 'abandoned.mjs'))
+  assert ns['value'] == 'loaded again'
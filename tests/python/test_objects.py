@@ -1,4 +1,5 @@
 import pythonmonkey as pm
+import pytest
 import sys
 
 
@@ -163,6 +164,20 @@ def test_constructor_iterable():
   assert repr(constructor).__contains__("<pythonmonkey.JSFunctionProxy object at")    
 
 
+def test_python_generator_in_js_for_of():
+  produced = []
+
+  def gen():
+    for i in range(5):
+      produced.append(i)
+      yield i
+
+  # breaking out of the loop must not have consumed values ahead of the JS consumer
+  taken = pm.eval("(it) => { const taken = []; for (const x of it) { taken.push(x); if (x == 2) break; } return taken; }")(gen())
+  assert taken == [0.0, 1.0, 2.0]
+  assert produced == [0, 1, 2]
+
+
 def test_toPrimitive_stdin():
   toPrimitive = pm.eval("(obj) => { return obj[Symbol.toPrimitive]; }")(sys.stdin)
   assert repr(toPrimitive).__contains__("<pythonmonkey.JSFunctionProxy object at")  
@@ -185,4 +200,21 @@ def test_toString_is_prototype_toLocaleString():
 
 def test_valueof_is_prototype_valueof():
   is_valueof_correct = pm.eval("x => x.valueOf === Object.prototype.valueOf")
-  assert is_valueof_correct({})
\ No newline at end of file
+  assert is_valueof_correct({})
+
+
+def test_iterate_js_iterables():
+  assert [1.0, 2.0, 3.0] == list(pm.eval("new Set([1, 2, 3, 2])"))
+  # Maps are mappings, iterating over their keys
+  assert ['a', 'b'] == list(pm.eval("new Map([['a', 1], ['b', 2]])"))
+  assert [0.0, 1.0, 4.0] == [x for x in pm.eval("(function* () { for (let i = 0; i < 3; i++) yield i * i; })()")]
+  # objects without a [Symbol.iterator] method still iterate over their keys like a dict
+  assert ['a', 'b'] == list(pm.eval("({ a: 1, b: 2 })"))
+
+
+def test_next_on_js_iterator():
+  iterator = pm.eval("[10, 20][Symbol.iterator]()")
+  assert 10.0 == next(iterator)
+  assert 20.0 == next(iterator)
+  with pytest.raises(StopIteration):
+    next(iterator)
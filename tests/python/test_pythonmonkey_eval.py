@@ -5,6 +5,8 @@ from datetime import datetime, timedelta, timezone
 import math
 from io import StringIO
 import sys
+import os
+import pathlib
 import asyncio
 
 
@@ -450,4 +452,55 @@ def test_iterable_attribute_console_printing():
   assert hasattr(sys.stdin, '__iter__') == True
   obj['stdin'].isTTY = sys.stdin.isatty()
   pm.eval('''(function iife(obj){console.log(obj['stdin'].isTTY);})''')(obj)
-  assert temp_out.getvalue() == "\x1b[33mfalse\x1b[39m\n" 
\ No newline at end of file
+  assert temp_out.getvalue() == "\x1b[33mfalse\x1b[39m\n" 
+
+
+def test_eval_bytes_source():
+  assert pm.eval(b"'by' + 'tes'") == 'bytes'
+  assert pm.eval(bytearray("'été'".encode('utf-8'))) == 'été'
+  assert pm.eval(memoryview(b"6 * 7")) == 42
+  assert pm.eval(b"") is None
+
+
+def test_eval_path_source(tmp_path):
+  sourcePath = tmp_path / 'source.js'
+  sourcePath.write_text("const evalPathSource = 'mapped ✓'; (new Error()).stack + '|' + evalPathSource", encoding='utf-8')
+  stack, value = pm.eval(sourcePath).split('|')
+  assert value == 'mapped ✓'
+  assert 'source.js' in stack
+  assert 'other.js' in pm.eval(pathlib.Path(sourcePath), {'filename': 'other.js'})
+
+
+def test_eval_empty_path_source(tmp_path):
+  emptyPath = tmp_path / 'empty.js'
+  emptyPath.write_bytes(b'')
+  assert pm.eval(emptyPath) is None
+
+
+def test_eval_missing_path_source(tmp_path):
+  with pytest.raises(FileNotFoundError):
+    pm.eval(tmp_path / 'missing.js')
+
+
+def test_eval_file_source(tmp_path):
+  sourcePath = tmp_path / 'file.js'
+  sourcePath.write_bytes(b"'skipped';\n'from ' + 'file'")
+  with open(sourcePath, 'rb') as f:
+    f.seek(len(b"'skipped';\n"))
+    assert pm.eval(f) == 'from file'
+    assert not f.closed
+  with open(sourcePath, 'rb') as f:
+    assert pm.eval(f) == 'from file'
+
+
+def test_eval_pipe_source():
+  readFd, writeFd = os.pipe()
+  os.write(writeFd, b"'from ' + 'pipe'")
+  os.close(writeFd)
+  with os.fdopen(readFd, 'rb') as f:
+    assert pm.eval(f) == 'from pipe'
+
+
+def test_eval_bad_source():
+  with pytest.raises(TypeError):
+    pm.eval(42)
@@ -0,0 +1,73 @@
+import pythonmonkey as pm
+import collections
+import pytest
+
+
+def test_tuple_is_array_like():
+  t = (1, 'two', None)
+  assert pm.eval("(t) => [Array.isArray(t), t instanceof Array, t.length, t[0], t[1], t[2], t[3]]")(t) == \
+      [True, True, 3.0, 1.0, 'two', None, None]
+
+
+def test_tuple_array_methods():
+  assert pm.eval("(t) => t.map((x) => x * 2)")((1, 2, 3)) == [2.0, 4.0, 6.0]
+  assert pm.eval("(t) => t.join('-')")((1, 2, 3)) == '1-2-3'
+  assert pm.eval("(t) => t.indexOf(2)")((1, 2, 3)) == 1.0
+  assert pm.eval("(t) => JSON.stringify(t)")((1, 'a')) == '[1,"a"]'
+
+
+def test_tuple_iteration():
+  assert pm.eval("(t) => { const out = []; for (const x of t) out.push(x); return out }")((1, 2)) == [1.0, 2.0]
+  assert pm.eval("(t) => [...t.values()]")(('a', 'b')) == ['a', 'b']
+
+
+def test_tuple_is_read_only():
+  t = (1, 2)
+  with pytest.raises(pm.SpiderMonkeyError):
+    pm.eval("'use strict'; (t) => { t[0] = 5 }")(t)
+  with pytest.raises(pm.SpiderMonkeyError):
+    pm.eval("'use strict'; (t) => { delete t[0] }")(t)
+  assert t == (1, 2)
+
+
+def test_tuple_round_trip():
+  t = (1, 2)
+  assert pm.eval("(t) => t")(t) is t
+
+
+def test_namedtuple_fields():
+  Point = collections.namedtuple('Point', ['x', 'y'])
+  assert pm.eval("(p) => [p.x, p.y, p[0], p.length]")(Point(3, 4)) == [3.0, 4.0, 3.0, 2.0]
+
+
+def test_range_is_lazy():
+  r = range(10**9)
+  assert pm.eval("(r) => [r.length, r[123456789], r[10 ** 9]]")(r) == [10.0**9, 123456789.0, None]
+  assert pm.eval("(r) => { let sum = 0; for (const x of r) { if (x > 5) break; sum += x } return sum }")(r) == 15.0
+  assert pm.eval("(r) => r.slice(3, 6)")(range(0, 100, 10)) == [30.0, 40.0, 50.0]
+
+
+def test_huge_range_keys():
+  assert pm.eval("(r) => Object.keys(r)")(range(3)) == ['0', '1', '2']
+  with pytest.raises(pm.SpiderMonkeyError, match="RangeError"):
+    pm.eval("(r) => Object.keys(r)")(range(10**9))
+  with pytest.raises(pm.SpiderMonkeyError, match="RangeError"):
+    pm.eval("(r) => Object.getOwnPropertyNames(r)")(range(2**40))
+
+
+def test_abc_sequence():
+  class Squares(collections.abc.Sequence):
+    def __len__(self):
+      return 5
+
+    def __getitem__(self, i):
+      if i >= 5:
+        raise IndexError(i)
+      return i * i
+  assert pm.eval("(s) => [s.length, s[3], Array.from(s)]")(Squares()) == [5.0, 9.0, [0.0, 1.0, 4.0, 9.0, 16.0]]
+
+
+def test_mutable_sequence_is_not_a_read_only_array():
+  user_list = collections.UserList([1, 2, 3])  # a collections.abc.MutableSequence
+  assert not pm.eval("Array.isArray")(user_list)
+  assert pm.eval("(l) => l")(user_list) is user_list